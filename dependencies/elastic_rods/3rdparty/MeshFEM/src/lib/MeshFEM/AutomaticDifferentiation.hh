@@ -6,6 +6,17 @@
 
 using ADReal = Eigen::AutoDiffScalar<Eigen::Matrix<Real, 1, 1>>;
 
+// Vector-dual scalar carrying K tangent directions at once; evaluating an
+// expression with this type computes K directional derivatives in one pass.
+template<int K>
+using ADRealK = Eigen::AutoDiffScalar<Eigen::Matrix<Real, K, 1>>;
+
+// Number of directions propagated per pass by the batched kernels.
+#ifndef AD_BATCH_SIZE
+#define AD_BATCH_SIZE 4
+#endif
+using ADRealBatch = ADRealK<AD_BATCH_SIZE>;
+
 // Wrapper to get the underlying value of an autodiff type (or do nothing for
 // primitive types)
 template<typename T>
@@ -137,6 +148,35 @@ inline VecX_T<Real> extractDirectionalDerivative(const VecX_T<ADReal> &a) {
     return result;
 }
 
+// Seed an autodiff vector with values `x` and the tangent directions stored in
+// columns [offset, offset + K) of `V`. Directions past the last column of `V`
+// are zero-padded so that a partially filled batch can still be evaluated.
+template<int K>
+VecX_T<ADRealK<K>> seedDirections(const VecX_T<Real> &x, const Eigen::MatrixXd &V, int offset = 0) {
+    const int n = x.size();
+    if (V.rows() != n) throw std::runtime_error("Direction size mismatch");
+    const int numDirs = std::max(0, std::min(K, int(V.cols()) - offset));
+    VecX_T<ADRealK<K>> result(n);
+    for (int i = 0; i < n; ++i) {
+        result[i].value() = x[i];
+        auto &der = result[i].derivatives();
+        der.setZero();
+        for (int k = 0; k < numDirs; ++k) der[k] = V(i, offset + k);
+    }
+    return result;
+}
+
+// Extract the directional derivatives for all K directions as the columns of an
+// (n x K) matrix (batched analog of extractDirectionalDerivative).
+template<int K>
+Eigen::MatrixXd extractDirectionalDerivatives(const VecX_T<ADRealK<K>> &a) {
+    const int n = a.size();
+    Eigen::MatrixXd result(n, K);
+    for (int i = 0; i < n; ++i)
+        result.row(i) = a[i].derivatives().transpose();
+    return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Extra autodiff math functions
 // Note: Eigen 3.3 changes how functions are declared and now finally implements
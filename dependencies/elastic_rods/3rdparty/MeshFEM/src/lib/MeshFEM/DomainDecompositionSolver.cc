@@ -0,0 +1,329 @@
+#include "DomainDecompositionSolver.hh"
+#include "MemoryReport.hh"
+#include "Parallelism.hh"
+#include "Profiler.hh"
+
+#include <algorithm>
+#include <mutex>
+#include <tuple>
+
+namespace {
+
+using Index = DomainDecompositionSolver::Index;
+
+template<typename F>
+void forEachSubdomain(size_t n, F &&f) {
+#ifdef MESHFEM_WITH_TBB
+    parallel_for_range(n, std::forward<F>(f));
+#else
+    for (size_t i = 0; i < n; ++i) f(i);
+#endif
+}
+
+// Entry (i, j) of a block, taken from entry `src` of the full matrix.
+struct BlockEntry {
+    Index i, j, src;
+    bool operator<(const BlockEntry &b) const { return std::tie(j, i) < std::tie(b.j, b.i); }
+};
+
+// Compressed column matrix holding `entries` (which are sorted in place);
+// `source` receives the entries' `src` fields in storage order.
+SuiteSparseMatrix blockMatrix(Index m, Index n, std::vector<BlockEntry> &entries, std::vector<Index> &source, SuiteSparseMatrix::SymmetryMode mode) {
+    std::sort(entries.begin(), entries.end());
+    SuiteSparseMatrix result(m, n);
+    result.symmetry_mode = mode;
+    result.nz = entries.size();
+    result.Ap.assign(n + 1, 0);
+    result.Ai.reserve(entries.size());
+    result.Ax.assign(entries.size(), 0.0);
+    source.clear();
+    source.reserve(entries.size());
+    for (const auto &e : entries) {
+        ++result.Ap[e.j + 1];
+        result.Ai.push_back(e.i);
+        source.push_back(e.src);
+    }
+    for (Index j = 0; j < n; ++j) result.Ap[j + 1] += result.Ap[j];
+    return result;
+}
+
+// Breadth-first ordering of the matrix graph, started in each connected
+// component from the end of a BFS sweep (an approximately peripheral node)
+// so that the BFS levels are thin.
+std::vector<Index> breadthFirstOrder(const std::vector<std::vector<Index>> &adj) {
+    const Index n = adj.size();
+    std::vector<Index> order;
+    order.reserve(n);
+    std::vector<char> visited(n, false), swept(n, false);
+
+    auto bfs = [&](Index root, std::vector<char> &mark, std::vector<Index> &out) {
+        const size_t begin = out.size();
+        out.push_back(root);
+        mark[root] = true;
+        for (size_t k = begin; k < out.size(); ++k) {
+            for (Index v : adj[out[k]]) {
+                if (mark[v]) continue;
+                mark[v] = true;
+                out.push_back(v);
+            }
+        }
+    };
+
+    std::vector<Index> sweep;
+    for (Index start = 0; start < n; ++start) {
+        if (visited[start]) continue;
+        sweep.clear();
+        bfs(start, swept, sweep);
+        bfs(sweep.back(), visited, order);
+    }
+    return order;
+}
+
+}
+
+void DomainDecompositionSolver::analyze(const SuiteSparseMatrix &pattern, size_t numSubdomains) {
+    PROFILE_SCOPE("DomainDecompositionSolver::analyze");
+    if (numSubdomains == 0) throw std::runtime_error("At least one subdomain is needed");
+    const Index n = pattern.n;
+    if (pattern.m != n) throw std::runtime_error("DomainDecompositionSolver requires a square matrix");
+
+    std::vector<std::vector<Index>> adj(n);
+    for (Index j = 0; j < n; ++j) {
+        for (Index idx = pattern.Ap[j]; idx < pattern.Ap[j + 1]; ++idx) {
+            const Index i = pattern.Ai[idx];
+            if (i == j) continue;
+            adj[i].push_back(j);
+            adj[j].push_back(i);
+        }
+    }
+
+    const std::vector<Index> order = breadthFirstOrder(adj);
+    std::vector<size_t> subdomainForVar(n);
+    for (Index k = 0; k < n; ++k)
+        subdomainForVar[order[k]] = (size_t(k) * numSubdomains) / size_t(n);
+    analyze(pattern, subdomainForVar);
+}
+
+void DomainDecompositionSolver::analyze(const SuiteSparseMatrix &pattern, const std::vector<size_t> &subdomainForVar) {
+    PROFILE_SCOPE("DomainDecompositionSolver::analyze");
+    const Index n = pattern.n;
+    if (pattern.m != n) throw std::runtime_error("DomainDecompositionSolver requires a square matrix");
+    if (pattern.symmetry_mode != SuiteSparseMatrix::SymmetryMode::UPPER_TRIANGLE) throw std::runtime_error("DomainDecompositionSolver requires an upper triangular matrix");
+    if (subdomainForVar.size() != size_t(n)) throw std::runtime_error("Subdomain assignment size mismatch");
+    const size_t numSubdomains = (n == 0) ? 0 : *std::max_element(subdomainForVar.begin(), subdomainForVar.end()) + 1;
+
+    m_factorized = false;
+    m_n  = n;
+    m_nz = pattern.nz;
+
+    // Variables coupled to a lower-numbered subdomain become interface variables;
+    // afterwards, no entry couples the interiors of two different subdomains.
+    m_subdomainForVar = subdomainForVar;
+    for (Index j = 0; j < n; ++j) {
+        for (Index idx = pattern.Ap[j]; idx < pattern.Ap[j + 1]; ++idx) {
+            const Index i = pattern.Ai[idx];
+            if (subdomainForVar[i] < subdomainForVar[j]) m_subdomainForVar[j] = INTERFACE;
+            if (subdomainForVar[j] < subdomainForVar[i]) m_subdomainForVar[i] = INTERFACE;
+        }
+    }
+
+    m_subdomains.clear();
+    m_subdomains.resize(numSubdomains);
+    m_interfaceVars.clear();
+    m_localIndex.assign(n, 0);
+    for (Index v = 0; v < n; ++v) {
+        const size_t s = m_subdomainForVar[v];
+        auto &vars = (s == INTERFACE) ? m_interfaceVars : m_subdomains[s].vars;
+        m_localIndex[v] = vars.size();
+        vars.push_back(v);
+    }
+    const Index nG = m_interfaceVars.size();
+
+    // Sort the entries into the interior blocks, coupling blocks (indexed by
+    // interface variable for now) and the interface block C.
+    std::vector<std::vector<BlockEntry>> AEntries(numSubdomains), BEntries(numSubdomains);
+    std::vector<BlockEntry> CEntries;
+    for (Index j = 0; j < n; ++j) {
+        for (Index idx = pattern.Ap[j]; idx < pattern.Ap[j + 1]; ++idx) {
+            const Index i = pattern.Ai[idx];
+            const size_t si = m_subdomainForVar[i], sj = m_subdomainForVar[j];
+            const Index li = m_localIndex[i], lj = m_localIndex[j];
+            if ((si == INTERFACE) && (sj == INTERFACE)) CEntries.push_back({std::min(li, lj), std::max(li, lj), idx});
+            else if (si == INTERFACE) BEntries[sj].push_back({lj, li, idx});
+            else if (sj == INTERFACE) BEntries[si].push_back({li, lj, idx});
+            else {
+                assert(si == sj);
+                AEntries[si].push_back({std::min(li, lj), std::max(li, lj), idx});
+            }
+        }
+    }
+
+    forEachSubdomain(numSubdomains, [&](size_t s) {
+        auto &sd = m_subdomains[s];
+        for (const auto &e : BEntries[s]) sd.interface.push_back(e.j);
+        std::sort(sd.interface.begin(), sd.interface.end());
+        sd.interface.erase(std::unique(sd.interface.begin(), sd.interface.end()), sd.interface.end());
+        for (auto &e : BEntries[s])
+            e.j = std::distance(sd.interface.begin(), std::lower_bound(sd.interface.begin(), sd.interface.end(), e.j));
+
+        const Index ni = sd.vars.size();
+        sd.B = blockMatrix(ni, sd.interface.size(), BEntries[s], sd.BSource, SuiteSparseMatrix::SymmetryMode::NONE);
+        if (ni == 0) return;
+        sd.solver = std::make_unique<CholmodFactorizer>(blockMatrix(ni, ni, AEntries[s], sd.ASource, SuiteSparseMatrix::SymmetryMode::UPPER_TRIANGLE),
+                                                        false, false, /* suppressWarnings */ true);
+        sd.solver->factorizeSymbolic();
+    });
+
+    // The Schur complement fills in each subdomain's interface block.
+    m_SSolver.reset();
+    m_SSource.clear();
+    if (nG == 0) return;
+    std::vector<std::vector<Index>> rowsForColumn(nG);
+    for (Index c = 0; c < nG; ++c) rowsForColumn[c].push_back(c);
+    for (const auto &e : CEntries) rowsForColumn[e.j].push_back(e.i);
+    for (const auto &sd : m_subdomains) {
+        for (size_t c = 0; c < sd.interface.size(); ++c)
+            rowsForColumn[sd.interface[c]].insert(rowsForColumn[sd.interface[c]].end(), sd.interface.begin(), sd.interface.begin() + c + 1);
+    }
+
+    SuiteSparseMatrix S(nG, nG);
+    S.symmetry_mode = SuiteSparseMatrix::SymmetryMode::UPPER_TRIANGLE;
+    S.Ap.assign(1, 0);
+    for (auto &rows : rowsForColumn) {
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+        S.Ai.insert(S.Ai.end(), rows.begin(), rows.end());
+        S.Ap.push_back(S.Ai.size());
+        std::vector<Index>().swap(rows);
+    }
+    S.nz = S.Ai.size();
+    S.Ax.assign(S.nz, 0.0);
+
+    m_SSource.assign(S.nz, -1);
+    for (const auto &e : CEntries) m_SSource[S.findEntry(e.i, e.j)] = e.src;
+
+    m_SSolver = std::make_unique<CholmodFactorizer>(std::move(S), false, false, /* suppressWarnings */ true);
+    m_SSolver->factorizeSymbolic();
+}
+
+void DomainDecompositionSolver::factorize(const SuiteSparseMatrix &A) {
+    PROFILE_SCOPE("DomainDecompositionSolver::factorize");
+    if (!analyzedFor(A)) throw std::runtime_error("Matrix does not match the analyzed sparsity pattern");
+    m_factorized = false;
+
+    const size_t numSubdomains = m_subdomains.size();
+    forEachSubdomain(numSubdomains, [&](size_t s) {
+        auto &sd = m_subdomains[s];
+        for (size_t k = 0; k < sd.BSource.size(); ++k) sd.B.Ax[k] = A.Ax[sd.BSource[k]];
+        if (!sd.solver) return;
+        auto &interior = sd.solver->matrix();
+        for (size_t k = 0; k < sd.ASource.size(); ++k) interior.Ax[k] = A.Ax[sd.ASource[k]];
+        sd.solver->refactorize();
+        if (!sd.solver->checkPosDef()) throw std::runtime_error("Subdomain matrix is not positive definite");
+    });
+
+    if (!m_SSolver) { m_factorized = true; return; }
+
+    auto &S = m_SSolver->matrix();
+    for (size_t k = 0; k < m_SSource.size(); ++k)
+        S.Ax[k] = (m_SSource[k] >= 0) ? A.Ax[m_SSource[k]] : 0.0;
+
+    // Subtract each subdomain's contribution B^T A_i^-1 B, computed a block of
+    // interface columns at a time to bound the dense storage.
+    std::mutex scatterMutex;
+    forEachSubdomain(numSubdomains, [&](size_t s) {
+        const auto &sd = m_subdomains[s];
+        const Index ni = sd.vars.size(), ng = sd.interface.size();
+        if ((ni == 0) || (ng == 0)) return;
+        constexpr Index blockSize = 32;
+        const SuiteSparseMatrix &B = sd.B;
+        Eigen::MatrixXd X(ni, blockSize), C(ng, blockSize);
+        Eigen::VectorXd rhs(ni), x(ni);
+        for (Index c0 = 0; c0 < ng; c0 += blockSize) {
+            const Index nc = std::min(blockSize, ng - c0);
+            for (Index c = 0; c < nc; ++c) {
+                rhs.setZero();
+                for (Index idx = B.Ap[c0 + c]; idx < B.Ap[c0 + c + 1]; ++idx) rhs[B.Ai[idx]] = B.Ax[idx];
+                sd.solver->solveExistingFactorization(rhs, x);
+                X.col(c) = x;
+            }
+            C.setZero();
+            for (Index r = 0; r < std::min(ng, c0 + nc); ++r) {
+                for (Index idx = B.Ap[r]; idx < B.Ap[r + 1]; ++idx)
+                    C.row(r).head(nc) += B.Ax[idx] * X.row(B.Ai[idx]).head(nc);
+            }
+
+            std::lock_guard<std::mutex> lock(scatterMutex);
+            for (Index c = 0; c < nc; ++c) {
+                for (Index r = 0; r <= c0 + c; ++r)
+                    S.addNZ(sd.interface[r], sd.interface[c0 + c], -C(r, c));
+            }
+        }
+    });
+
+    m_SSolver->refactorize();
+    if (!m_SSolver->checkPosDef()) throw std::runtime_error("Interface Schur complement is not positive definite");
+    m_factorized = true;
+}
+
+void DomainDecompositionSolver::solve(const Eigen::VectorXd &b, Eigen::VectorXd &x) const {
+    PROFILE_SCOPE("DomainDecompositionSolver::solve");
+    if (!m_factorized) throw std::runtime_error("Factorization doesn't exist");
+    if (b.size() != m_n) throw std::runtime_error("Right-hand side size mismatch");
+    x.resize(m_n);
+
+    const size_t numSubdomains = m_subdomains.size();
+    const Index nG = m_interfaceVars.size();
+    std::vector<Eigen::VectorXd> y(numSubdomains);
+
+    // Interior solves y_i = A_i^-1 b_i.
+    forEachSubdomain(numSubdomains, [&](size_t s) {
+        const auto &sd = m_subdomains[s];
+        if (!sd.solver) return;
+        Eigen::VectorXd bi(sd.vars.size());
+        for (size_t k = 0; k < sd.vars.size(); ++k) bi[k] = b[sd.vars[k]];
+        sd.solver->solveExistingFactorization(bi, y[s]);
+    });
+
+    // Interface solve S x_G = b_G - sum_i B_i^T y_i.
+    Eigen::VectorXd xG(nG);
+    if (nG > 0) {
+        Eigen::VectorXd g(nG);
+        for (Index k = 0; k < nG; ++k) g[k] = b[m_interfaceVars[k]];
+        for (size_t s = 0; s < numSubdomains; ++s) {
+            const auto &sd = m_subdomains[s];
+            if (!sd.solver) continue;
+            for (size_t c = 0; c < sd.interface.size(); ++c) {
+                for (Index idx = sd.B.Ap[c]; idx < sd.B.Ap[c + 1]; ++idx)
+                    g[sd.interface[c]] -= sd.B.Ax[idx] * y[s][sd.B.Ai[idx]];
+            }
+        }
+        m_SSolver->solveExistingFactorization(g, xG);
+        for (Index k = 0; k < nG; ++k) x[m_interfaceVars[k]] = xG[k];
+    }
+
+    // Interior back-substitution x_i = A_i^-1 (b_i - B_i x_G).
+    forEachSubdomain(numSubdomains, [&](size_t s) {
+        const auto &sd = m_subdomains[s];
+        if (!sd.solver) return;
+        Eigen::VectorXd bi(sd.vars.size());
+        for (size_t k = 0; k < sd.vars.size(); ++k) bi[k] = b[sd.vars[k]];
+        for (size_t c = 0; c < sd.interface.size(); ++c) {
+            for (Index idx = sd.B.Ap[c]; idx < sd.B.Ap[c + 1]; ++idx)
+                bi[sd.B.Ai[idx]] -= sd.B.Ax[idx] * xG[sd.interface[c]];
+        }
+        Eigen::VectorXd xi;
+        sd.solver->solveExistingFactorization(bi, xi);
+        for (size_t k = 0; k < sd.vars.size(); ++k) x[sd.vars[k]] = xi[k];
+    });
+}
+
+size_t DomainDecompositionSolver::memoryUsage() const {
+    size_t result = heapBytes(m_subdomainForVar) + heapBytes(m_localIndex) + heapBytes(m_interfaceVars) + heapBytes(m_SSource);
+    for (const auto &sd : m_subdomains) {
+        result += heapBytes(sd.vars) + heapBytes(sd.interface) + sd.B.memoryUsage() + heapBytes(sd.ASource) + heapBytes(sd.BSource);
+        if (sd.solver) result += sd.solver->matrixMemoryUsage() + sd.solver->factorMemoryUsage();
+    }
+    if (m_SSolver) result += m_SSolver->matrixMemoryUsage() + m_SSolver->factorMemoryUsage();
+    return result;
+}
@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////////////////
+// DomainDecompositionSolver.hh
+////////////////////////////////////////////////////////////////////////////////
+/*! @file
+//  Non-overlapping domain decomposition (substructuring) solver for sparse
+//  symmetric positive definite systems stored as upper triangles.
+//
+//  The variables are split into subdomain interiors and an interface so that
+//  no two interiors are coupled directly:
+//      [A_1             B_1] [x_1]   [b_1]
+//      [     ...        ...] [...] = [...]
+//      [          A_k   B_k] [x_k]   [b_k]
+//      [B_1^T ... B_k^T   C] [x_G]   [b_G]
+//  The interior blocks A_i are factorized concurrently, their contributions to
+//  the interface Schur complement S = C - sum_i B_i^T A_i^-1 B_i are computed
+//  concurrently, and S is factorized with CHOLMOD. The system is positive
+//  definite iff all A_i and S are, so like CholmodFactorizer, `factorize`
+//  throws when it is not (allowing use inside shifted Newton iterations).
+//
+//  The default partition cuts a breadth-first ordering of the matrix graph
+//  into contiguous slabs of equal size; variables coupled to an earlier slab
+//  form the interface. This pays off for large systems whose graphs are long
+//  or wide compared to their thickness (e.g., gridshells and woven roofs),
+//  where the interfaces stay small relative to the interiors.
+*/
+////////////////////////////////////////////////////////////////////////////////
+#ifndef DOMAINDECOMPOSITIONSOLVER_HH
+#define DOMAINDECOMPOSITIONSOLVER_HH
+
+#include <MeshFEM/SparseMatrices.hh>
+#include <MeshFEM_export.h>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+class MESHFEM_EXPORT DomainDecompositionSolver {
+public:
+    using Index = SuiteSparse_long;
+    static constexpr size_t INTERFACE = std::numeric_limits<size_t>::max();
+
+    DomainDecompositionSolver() = default;
+    DomainDecompositionSolver(const SuiteSparseMatrix &pattern, size_t numSubdomains) { analyze(pattern, numSubdomains); }
+
+    // The factorizations cannot be copied.
+    DomainDecompositionSolver(const DomainDecompositionSolver &) = delete;
+    DomainDecompositionSolver &operator=(const DomainDecompositionSolver &) = delete;
+
+    // Partition the variables of the (upper triangular) sparsity pattern into
+    // `numSubdomains` breadth-first slabs and prepare the factorizations.
+    void analyze(const SuiteSparseMatrix &pattern, size_t numSubdomains);
+
+    // Use a custom assignment of variables to subdomains (0..numSubdomains-1);
+    // variables coupled to a lower-numbered subdomain are moved to the interface.
+    void analyze(const SuiteSparseMatrix &pattern, const std::vector<size_t> &subdomainForVar);
+
+    // Numeric factorization of `A`, which must have the pattern passed to
+    // `analyze`. Throws if A is not positive definite.
+    void factorize(const SuiteSparseMatrix &A);
+
+    void solve(const Eigen::VectorXd &b, Eigen::VectorXd &x) const;
+    Eigen::VectorXd solve(const Eigen::VectorXd &b) const {
+        Eigen::VectorXd x;
+        solve(b, x);
+        return x;
+    }
+
+    bool hasFactorization() const { return m_factorized; }
+    // Whether `analyze` was called for a pattern of A's size (necessary but not sufficient for A to match).
+    bool analyzedFor(const SuiteSparseMatrix &A) const { return (A.n == m_n) && (A.nz == m_nz) && !m_subdomains.empty(); }
+
+    size_t numVars()       const { return m_subdomainForVar.size(); }
+    size_t numSubdomains() const { return m_subdomains.size(); }
+    size_t interfaceSize() const { return m_interfaceVars.size(); }
+    // Subdomain of each variable (INTERFACE for the interface variables).
+    const std::vector<size_t> &subdomainForVar() const { return m_subdomainForVar; }
+
+    size_t memoryUsage() const;
+
+private:
+    struct Subdomain {
+        std::vector<Index> vars;      // interior variables (ascending)
+        std::vector<Index> interface; // interface variables coupled to the interior (indices into m_interfaceVars, ascending)
+        SuiteSparseMatrix B;          // interior-interface coupling block (rows: interior, columns: `interface`)
+        std::vector<Index> ASource, BSource; // index in the full matrix's Ax of each entry of the interior block/B
+        std::unique_ptr<CholmodFactorizer> solver; // holds the interior block (upper triangle)
+    };
+
+    std::vector<Subdomain> m_subdomains;
+    std::vector<size_t> m_subdomainForVar;
+    std::vector<Index> m_localIndex;    // index of each variable within its subdomain's `vars` or within m_interfaceVars
+    std::vector<Index> m_interfaceVars; // ascending
+
+    std::vector<Index> m_SSource; // index in the full matrix's Ax of each entry of C (-1 for fill from the Schur complement)
+    std::unique_ptr<CholmodFactorizer> m_SSolver; // holds the interface Schur complement (upper triangle)
+
+    Index m_n = 0, m_nz = 0;
+    bool m_factorized = false;
+};
+
+#endif /* end of include guard: DOMAINDECOMPOSITIONSOLVER_HH */
@@ -1,8 +1,25 @@
 #include "GlobalBenchmark.hh"
 
-#ifdef BENCHMARK
+#include <mutex>
 
-Timer g_timer;
-std::vector<std::string> g_benchmarkMessages;
+static std::mutex g_benchmarkMessagesMutex;
+static std::vector<std::string> g_benchmarkMessages;
 
-#endif
+void BENCHMARK_ADD_MESSAGE(const std::string &msg) {
+    std::lock_guard<std::mutex> lock(g_benchmarkMessagesMutex);
+    g_benchmarkMessages.push_back(msg);
+}
+
+void BENCHMARK_CLEAR_MESSAGES() {
+    std::lock_guard<std::mutex> lock(g_benchmarkMessagesMutex);
+    g_benchmarkMessages.clear();
+}
+
+void BENCHMARK_REPORT() {
+    {
+        std::lock_guard<std::mutex> lock(g_benchmarkMessagesMutex);
+        for (const auto &message : g_benchmarkMessages)
+            std::cout << message << std::endl;
+    }
+    Profiler::report(std::cout);
+}
@@ -4,57 +4,56 @@
 #include <string>
 #include <iostream>
 #include <MeshFEM_export.h>
-
+#include <MeshFEM/Profiler.hh>
+
+// Legacy timing interface, now forwarding to the thread-safe Profiler (which
+// -DBENCHMARK merely enables at startup). These functions intern `name` on
+// every call; hot code should use PROFILE_SCOPE instead.
+//
+// Timers and sections both become profiler sections nested under the
+// current section. Unlike the legacy flat timers, START_TIMER/STOP_TIMER
+// pairs must therefore nest properly: stopping a timer also stops every
+// timer or section started after it (their own stops are then ignored), so
+// overlapping pairs attribute the overlap to the timer started first.
+//
+// As before, BENCHMARK_RESET and BENCHMARK_REPORT_NO_MESSAGES are compiled
+// out unless building with -DBENCHMARK, so library code calling them does not
+// clear or print the profile of a program that enabled profiling at runtime
+// (which should call Profiler::reset/report itself).
+
+MESHFEM_EXPORT void BENCHMARK_ADD_MESSAGE(const std::string &msg);
+MESHFEM_EXPORT void BENCHMARK_CLEAR_MESSAGES();
+MESHFEM_EXPORT void BENCHMARK_REPORT();
+
+inline void BENCHMARK_START_TIMER_SECTION(const std::string &name) { if (Profiler::enabled()) Profiler::enter(Profiler::section(name)); }
+inline void  BENCHMARK_STOP_TIMER_SECTION(const std::string &name) { if (Profiler::enabled()) Profiler::exit (Profiler::section(name)); }
+inline void         BENCHMARK_START_TIMER(const std::string &name) { BENCHMARK_START_TIMER_SECTION(name); }
+inline void          BENCHMARK_STOP_TIMER(const std::string &name) { BENCHMARK_STOP_TIMER_SECTION(name); }
 #ifdef BENCHMARK
-#include <MeshFEM/Timer.hh>
-
-MESHFEM_EXPORT extern Timer g_timer;
-MESHFEM_EXPORT extern std::vector<std::string> g_benchmarkMessages;
-
-inline void BENCHMARK_START_TIMER_SECTION(const std::string &name) { g_timer.startSection(name); }
-inline void  BENCHMARK_STOP_TIMER_SECTION(const std::string &name) { g_timer.stopSection(name); }
-inline void         BENCHMARK_START_TIMER(const std::string &name) { g_timer.start(name); }
-inline void          BENCHMARK_STOP_TIMER(const std::string &name) { g_timer.stop(name); }
-inline void               BENCHMARK_RESET()                   { g_timer.reset(); }
-
-inline void BENCHMARK_ADD_MESSAGE(const std::string &msg) {
-    g_benchmarkMessages.push_back(msg);
-}
-
-inline void BENCHMARK_CLEAR_MESSAGES() { g_benchmarkMessages.clear(); }
-
-inline void BENCHMARK_REPORT() {
-    for (const auto &message : g_benchmarkMessages)
-        std::cout << message << std::endl;
-    g_timer.report(std::cout);
-}
+inline void               BENCHMARK_RESET()                   { Profiler::reset(); }
 
 inline void BENCHMARK_REPORT_NO_MESSAGES() {
-    g_timer.report(std::cout);
+    Profiler::report(std::cout);
 }
 #else
-inline void BENCHMARK_START_TIMER_SECTION(const std::string &/* name */) { }
-inline void  BENCHMARK_STOP_TIMER_SECTION(const std::string &/* name */) { }
-inline void         BENCHMARK_START_TIMER(const std::string &/* name */) { }
-inline void          BENCHMARK_STOP_TIMER(const std::string &/* name */) { }
-inline void               BENCHMARK_RESET() { }
-
-inline void BENCHMARK_ADD_MESSAGE(const std::string &/* msg */) { }
-inline void BENCHMARK_CLEAR_MESSAGES() { }
-inline void BENCHMARK_REPORT() { }
-inline void BENCHMARK_REPORT_NO_MESSAGES() { }
+inline void               BENCHMARK_RESET()                   { }
+inline void BENCHMARK_REPORT_NO_MESSAGES()                     { }
 #endif
 
 struct BENCHMARK_SCOPED_TIMER_SECTION {
-    BENCHMARK_SCOPED_TIMER_SECTION(const std::string &name) : m_name(name) {
-        BENCHMARK_START_TIMER_SECTION(name);
+    BENCHMARK_SCOPED_TIMER_SECTION(const std::string &name) : m_active(Profiler::enabled()) {
+        if (m_active) {
+            m_id = Profiler::section(name);
+            Profiler::enter(m_id);
+        }
     }
 
     ~BENCHMARK_SCOPED_TIMER_SECTION() {
-        BENCHMARK_STOP_TIMER_SECTION(m_name);
+        if (m_active) Profiler::exit(m_id);
     }
 private:
-    std::string m_name;
+    bool m_active;
+    Profiler::SectionId m_id = 0;
 };
 
 #endif /* end of include guard: GLOBALBENCHMARK_HH */
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////////////////
+// MemoryReport.hh
+////////////////////////////////////////////////////////////////////////////////
+/*! @file
+//      Per-component breakdown of the heap memory held by an object (e.g., a
+//      linkage or a solver). Components are identified by dot-separated names
+//      ("segments.deformed_states") and listed in the order they were first
+//      added. Sizes are computed from container capacities, so building a
+//      report is cheap and does not touch the stored data.
+//      Memory shared between objects (e.g., cross-section meshes referenced by
+//      several RodMaterial copies) is not included.
+*/
+////////////////////////////////////////////////////////////////////////////////
+#ifndef MEMORYREPORT_HH
+#define MEMORYREPORT_HH
+
+#include <string>
+#include <utility>
+#include <vector>
+#include <Eigen/Dense>
+
+struct MemoryReport {
+    std::vector<std::pair<std::string, size_t>> components; // (name, bytes)
+
+    // Add `bytes` to component `name`, creating it if needed.
+    void add(const std::string &name, size_t bytes) {
+        for (auto &c : components) {
+            if (c.first == name) { c.second += bytes; return; }
+        }
+        components.emplace_back(name, bytes);
+    }
+
+    // Merge all components of `other`, prefixing their names with `prefix.`
+    void add(const std::string &prefix, const MemoryReport &other) {
+        for (const auto &c : other.components)
+            add(prefix.empty() ? c.first : prefix + "." + c.first, c.second);
+    }
+
+    size_t total() const {
+        size_t result = 0;
+        for (const auto &c : components) result += c.second;
+        return result;
+    }
+};
+
+template<typename T, class Alloc>
+size_t heapBytes(const std::vector<T, Alloc> &v) { return v.capacity() * sizeof(T); }
+
+template<typename Derived>
+size_t heapBytes(const Eigen::PlainObjectBase<Derived> &m) {
+    if (Derived::SizeAtCompileTime != Eigen::Dynamic) return 0; // stored inline
+    return m.size() * sizeof(typename Derived::Scalar);
+}
+
+// Heap memory of a vector of containers (e.g., std::vector<std::vector<Real>>).
+template<typename T, class Alloc>
+size_t nestedHeapBytes(const std::vector<T, Alloc> &v) {
+    size_t result = heapBytes(v);
+    for (const auto &x : v) result += heapBytes(x);
+    return result;
+}
+
+#endif /* end of include guard: MEMORYREPORT_HH */
@@ -1,6 +1,17 @@
 #include <MeshFEM/Parallelism.hh>
+#include <stdexcept>
+#include <vector>
 
 #ifdef MESHFEM_WITH_TBB
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
 
 std::unique_ptr<tbb::global_control> g_global_control;
 std::unique_ptr<tbb::task_arena> g_hessian_assembly_arena,
@@ -36,18 +47,128 @@ void set_gradient_assembly_num_threads(int num_threads) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// Arena of the ParallelismArena the calling thread is currently working in (if any).
+static thread_local tbb::task_arena *t_current_arena = nullptr;
+
 tbb::task_arena &get_hessian_assembly_arena() {
+    if (t_current_arena) return *t_current_arena;
     if (!g_hessian_assembly_arena) set_hessian_assembly_num_threads(tbb::task_arena::automatic);
     return *g_hessian_assembly_arena;
 }
 
 tbb::task_arena &get_gradient_assembly_arena() {
+    if (t_current_arena) return *t_current_arena;
     if (!g_gradient_assembly_arena) set_gradient_assembly_num_threads(tbb::task_arena::automatic);
     return *g_gradient_assembly_arena;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// ParallelismArena
+////////////////////////////////////////////////////////////////////////////////
+// Tracks the threads entering and leaving the arena: records the current
+// arena for the assembly routines and optionally pins the thread to a core.
+struct ArenaObserver : public tbb::task_scheduler_observer {
+    ArenaObserver(tbb::task_arena &a, int first_pinned_core)
+        : tbb::task_scheduler_observer(a), arena(a), firstPinnedCore(first_pinned_core) { observe(true); }
+    ~ArenaObserver() { observe(false); }
+
+    void on_scheduler_entry(bool /* is_worker */) override {
+        t_saved.emplace_back();
+        t_saved.back().arena = t_current_arena;
+        t_current_arena = &arena;
+        if (firstPinnedCore >= 0) pin(firstPinnedCore + tbb::this_task_arena::current_thread_index(), t_saved.back());
+    }
+
+    void on_scheduler_exit(bool /* is_worker */) override {
+        if (t_saved.empty()) return;
+        if (firstPinnedCore >= 0) unpin(t_saved.back());
+        t_current_arena = t_saved.back().arena;
+        t_saved.pop_back();
+    }
+
+    tbb::task_arena &arena;
+    int firstPinnedCore;
+
+private:
+    // State to restore when the thread leaves the arena. A thread can enter
+    // arenas while inside another (e.g., through task_arena::execute), so the
+    // states of all observers are kept on a per-thread stack.
+    struct SavedState {
+        tbb::task_arena *arena = nullptr;
+#if defined(__linux__)
+        cpu_set_t affinity;
+        bool pinned = false;
+#elif defined(_WIN32)
+        DWORD_PTR affinity = 0;
+#endif
+    };
+    static thread_local std::vector<SavedState> t_saved;
+
+#if defined(__linux__)
+    static void pin(int core, SavedState &saved) {
+        saved.pinned = (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &saved.affinity) == 0);
+        if (!saved.pinned) return;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core % CPU_SETSIZE, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set);
+    }
+    static void unpin(const SavedState &saved) {
+        if (saved.pinned) pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &saved.affinity);
+    }
+#elif defined(_WIN32)
+    static void pin(int core, SavedState &saved) { saved.affinity = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (core % (8 * sizeof(DWORD_PTR)))); }
+    static void unpin(const SavedState &saved) {
+        if (saved.affinity) SetThreadAffinityMask(GetCurrentThread(), saved.affinity);
+    }
+#else
+    static void pin(int /* core */, SavedState &/* saved */) { }
+    static void unpin(const SavedState &/* saved */) { }
+#endif
+};
+
+thread_local std::vector<ArenaObserver::SavedState> ArenaObserver::t_saved;
+
+struct ParallelismArena::Impl {
+    Impl(int num_threads, int first_pinned_core)
+        : arena(num_threads), observer(arena, first_pinned_core) { }
+    tbb::task_arena arena;
+    ArenaObserver observer; // declared after `arena` so that it stops observing before the arena is destroyed
+};
+
+ParallelismArena::ParallelismArena(int num_threads, int first_pinned_core) {
+    validateNumThreads(num_threads);
+    m_impl = std::make_shared<Impl>(num_threads, first_pinned_core);
+}
+
+int ParallelismArena::maxConcurrency() const {
+    return m_impl ? m_impl->arena.max_concurrency() : tbb::this_task_arena::max_concurrency();
+}
+
+int ParallelismArena::firstPinnedCore() const { return m_impl ? m_impl->observer.firstPinnedCore : -1; }
+
+void ParallelismArena::m_execute(const std::function<void()> &f) const {
+    // The observer only sees the threads joining the arena; the calling
+    // thread must record the arena itself.
+    tbb::task_arena *previous = t_current_arena;
+    t_current_arena = &m_impl->arena;
+    try { m_impl->arena.execute(f); }
+    catch (...) { t_current_arena = previous; throw; }
+    t_current_arena = previous;
+}
+
 #else // !MESHFEM_WITH_TBB
 
+struct ParallelismArena::Impl { };
+
+ParallelismArena::ParallelismArena(int /* num_threads */, int /* first_pinned_core */) {
+    throw std::runtime_error("TBB Disabled");
+}
+
+int  ParallelismArena::maxConcurrency() const { return 1; }
+int  ParallelismArena::firstPinnedCore() const { return -1; }
+void ParallelismArena::m_execute(const std::function<void()> &f) const { f(); }
+
 void set_max_num_tbb_threads(int num_threads) {
     throw std::runtime_error("TBB Disabled");
 }
@@ -17,6 +17,7 @@ MESHFEM_EXPORT void unset_max_num_tbb_threads();
 
 // We may want to use different numbers of threads to assemble the Hessian/gradient because of the
 // overhead of the reduction operation used to combine the results.
+// Inside a ParallelismArena, the assembly runs in that arena instead.
 MESHFEM_EXPORT void set_hessian_assembly_num_threads(int num_threads);
 MESHFEM_EXPORT void set_gradient_assembly_num_threads(int num_threads);
 
@@ -40,5 +41,41 @@ void parallel_for_range(size_t n, F &&f) {
 }
 #endif
 
-#endif
+#endif // MESHFEM_WITH_TBB
+
+#include <functional>
+#include <memory>
+#include <MeshFEM_export.h>
+
+// Handle to a task arena with its own concurrency limit. Running a
+// computation (e.g., one solve) inside it keeps its parallel loops and the
+// parallel gradient/Hessian assembly from competing with other computations
+// running concurrently in TBB's shared arena. Copies refer to the same arena;
+// a default-constructed (empty) handle runs computations in the caller's arena.
+// If `first_pinned_core` is nonnegative, the threads working in the arena are
+// pinned to cores `first_pinned_core, first_pinned_core + 1, ...` while they
+// are in the arena (Linux and Windows only).
+class MESHFEM_EXPORT ParallelismArena {
+public:
+    static constexpr int automatic = -1; // tbb::task_arena::automatic
+
+    ParallelismArena() { }
+    ParallelismArena(int num_threads, int first_pinned_core = -1);
+
+    bool empty() const { return !m_impl; }
+    int maxConcurrency() const;
+    int firstPinnedCore() const;
+
+    template<typename F>
+    void execute(F &&f) const {
+        if (empty()) f();
+        else m_execute(std::function<void()>(std::forward<F>(f)));
+    }
+
+    struct Impl;
+private:
+    void m_execute(const std::function<void()> &f) const;
+    std::shared_ptr<Impl> m_impl;
+};
+
 #endif /* end of include guard: PARALLELISM_HH */
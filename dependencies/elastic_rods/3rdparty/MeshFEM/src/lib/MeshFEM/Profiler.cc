@@ -0,0 +1,209 @@
+#include "Profiler.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace Profiler {
+
+#ifdef BENCHMARK
+std::atomic<bool> g_enabled(true);
+#else
+std::atomic<bool> g_enabled(false);
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Call tree of a single thread. The mutex is only contended while a report
+// or reset is in progress.
+struct ThreadTree {
+    struct TreeNode {
+        TreeNode(SectionId id_, uint32_t parent_) : id(id_), parent(parent_) { }
+        SectionId id;
+        uint32_t parent;
+        std::vector<uint32_t> children;
+        size_t calls = 0;
+        double seconds = 0;
+    };
+
+    std::mutex mutex;
+    std::vector<TreeNode> nodes{TreeNode(0, 0)}; // nodes[0] is the root
+    std::vector<std::pair<uint32_t, Clock::time_point>> open; // open sections (node, start time), innermost last
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::string> names;
+    std::unordered_map<std::string, SectionId> ids;
+    std::vector<std::shared_ptr<ThreadTree>> threads; // trees of the running threads
+    // Timings of threads that have exited, merged by section path so that
+    // short-lived threads don't keep their trees alive.
+    Node retired;
+};
+
+Registry &registry() {
+    static Registry r;
+    return r;
+}
+
+double secondsBetween(Clock::time_point a, Clock::time_point b) {
+    return std::chrono::duration<double>(b - a).count();
+}
+
+void mergeInto(Node &dst, const ThreadTree &tree, uint32_t n, const std::vector<double> &running, const std::vector<std::string> &names) {
+    for (uint32_t c : tree.nodes[n].children) {
+        const auto &src = tree.nodes[c];
+        if ((src.calls == 0) && (running[c] == 0)) continue; // not visited since the last reset
+        const std::string &name = names.at(src.id);
+        auto it = std::find_if(dst.children.begin(), dst.children.end(), [&](const Node &child) { return child.name == name; });
+        if (it == dst.children.end()) {
+            dst.children.emplace_back();
+            it = std::prev(dst.children.end());
+            it->name = name;
+        }
+        it->calls   += src.calls;
+        it->seconds += src.seconds + running[c];
+        mergeInto(*it, tree, c, running, names);
+    }
+}
+
+// Owns the calling thread's tree; when the thread exits, its timings (including
+// any sections still open) are merged into the registry's retired tree and the
+// tree is released.
+struct ThreadTreeHolder {
+    std::shared_ptr<ThreadTree> tree;
+
+    ~ThreadTreeHolder() {
+        if (!tree) return;
+        const auto now = Clock::now();
+        auto &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        {
+            std::lock_guard<std::mutex> treeLock(tree->mutex);
+            std::vector<double> running(tree->nodes.size(), 0.0);
+            for (const auto &o : tree->open) running[o.first] = secondsBetween(o.second, now);
+            mergeInto(r.retired, *tree, 0, running, r.names);
+        }
+        r.threads.erase(std::remove(r.threads.begin(), r.threads.end(), tree), r.threads.end());
+    }
+};
+
+ThreadTree &threadTree() {
+    thread_local ThreadTreeHolder t_holder;
+    if (!t_holder.tree) {
+        t_holder.tree = std::make_shared<ThreadTree>();
+        auto &r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.threads.push_back(t_holder.tree);
+    }
+    return *t_holder.tree;
+}
+
+void writeReport(std::ostream &os, const Node &node, size_t depth) {
+    for (const Node &child : node.children) {
+        os << std::string(4 * depth, ' ') << child.name << '\t' << child.seconds << '\t' << child.calls << '\n';
+        writeReport(os, child, depth + 1);
+    }
+}
+
+}
+
+void setEnabled(bool enable) { g_enabled = enable; }
+
+SectionId section(const std::string &name) {
+    // Per-thread cache so that repeated lookups by name (e.g., through the
+    // legacy BENCHMARK_* functions) do not contend on the registry lock.
+    thread_local std::unordered_map<std::string, SectionId> t_cache;
+    auto cached = t_cache.find(name);
+    if (cached != t_cache.end()) return cached->second;
+
+    auto &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    auto it = r.ids.find(name);
+    if (it == r.ids.end()) {
+        it = r.ids.emplace(name, SectionId(r.names.size())).first;
+        r.names.push_back(name);
+    }
+    t_cache.emplace(name, it->second);
+    return it->second;
+}
+
+std::string sectionName(SectionId id) {
+    auto &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.names.at(id);
+}
+
+void enter(SectionId id) {
+    auto &t = threadTree();
+    std::lock_guard<std::mutex> lock(t.mutex);
+    const uint32_t current = t.open.empty() ? 0 : t.open.back().first;
+
+    uint32_t child = 0;
+    for (uint32_t c : t.nodes[current].children) {
+        if (t.nodes[c].id == id) { child = c; break; }
+    }
+    if (child == 0) {
+        child = uint32_t(t.nodes.size());
+        t.nodes.emplace_back(id, current);
+        t.nodes[current].children.push_back(child);
+    }
+
+    ++t.nodes[child].calls;
+    t.open.emplace_back(child, Clock::now());
+}
+
+void exit(SectionId id) {
+    const auto now = Clock::now();
+    auto &t = threadTree();
+    std::lock_guard<std::mutex> lock(t.mutex);
+
+    auto match = std::find_if(t.open.rbegin(), t.open.rend(), [&](const std::pair<uint32_t, Clock::time_point> &o) { return t.nodes[o.first].id == id; });
+    if (match == t.open.rend()) return;
+
+    const size_t first = std::distance(t.open.begin(), match.base()) - 1;
+    for (size_t i = first; i < t.open.size(); ++i)
+        t.nodes[t.open[i].first].seconds += secondsBetween(t.open[i].second, now);
+    t.open.resize(first);
+}
+
+void reset() {
+    const auto now = Clock::now();
+    auto &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired = Node();
+    for (auto &tp : r.threads) {
+        std::lock_guard<std::mutex> treeLock(tp->mutex);
+        for (auto &n : tp->nodes) { n.calls = 0; n.seconds = 0; }
+        for (auto &o : tp->open) {
+            tp->nodes[o.first].calls = 1;
+            o.second = now;
+        }
+    }
+}
+
+Node report() {
+    const auto now = Clock::now();
+    auto &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    Node root = r.retired;
+    for (auto &tp : r.threads) {
+        std::lock_guard<std::mutex> treeLock(tp->mutex);
+        std::vector<double> running(tp->nodes.size(), 0.0);
+        for (const auto &o : tp->open) running[o.first] = secondsBetween(o.second, now);
+        mergeInto(root, *tp, 0, running, r.names);
+    }
+    return root;
+}
+
+void report(std::ostream &os) {
+    writeReport(os, report(), 0);
+    os.flush();
+}
+
+}
@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////
+// Profiler.hh
+////////////////////////////////////////////////////////////////////////////////
+/*! @file
+//      Low-overhead hierarchical profiler that is always compiled in and can
+//      be enabled/disabled at runtime.
+//      Section names are interned once into integer ids (the PROFILE_SCOPE
+//      macro caches the id in a function-local static), and each thread
+//      records its own call tree, so timing a section never touches shared
+//      state. The per-thread trees are merged by section path when a report
+//      is requested; when a thread exits, its tree is folded into the
+//      retained totals and freed. While the profiler is disabled, entering a section costs
+//      a single atomic load.
+//
+//      Sections entered on worker threads (e.g., inside a parallel_for) do not
+//      know about the sections open on the thread that spawned the work; they
+//      appear at the top level of the merged tree.
+*/
+////////////////////////////////////////////////////////////////////////////////
+#ifndef PROFILER_HH
+#define PROFILER_HH
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <MeshFEM_export.h>
+
+namespace Profiler {
+
+using SectionId = uint32_t;
+
+MESHFEM_EXPORT extern std::atomic<bool> g_enabled;
+
+inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+MESHFEM_EXPORT void setEnabled(bool enable);
+
+// Intern `name`, returning the same id for every call with the same name.
+MESHFEM_EXPORT SectionId section(const std::string &name);
+MESHFEM_EXPORT std::string sectionName(SectionId id);
+
+// Start/stop timing section `id` as a child of the calling thread's current
+// section. `exit` also closes any sections left open inside `id`; exiting a
+// section that is not open is ignored (e.g., when the profiler was enabled
+// in between).
+MESHFEM_EXPORT void enter(SectionId id);
+MESHFEM_EXPORT void exit(SectionId id);
+
+// Zero all timings and call counts. Sections currently open keep running and
+// are accounted for when they exit.
+MESHFEM_EXPORT void reset();
+
+// Merged call tree; the root is unnamed and holds the top-level sections.
+struct Node {
+    std::string name;
+    size_t calls = 0;
+    double seconds = 0;
+    std::vector<Node> children;
+};
+
+MESHFEM_EXPORT Node report();
+
+// Indented "name\tseconds\tcalls" lines, one per section of the merged tree.
+MESHFEM_EXPORT void report(std::ostream &os);
+
+struct ScopedSection {
+    ScopedSection(SectionId id) : m_id(id), m_active(enabled()) {
+        if (m_active) enter(m_id);
+    }
+
+    ~ScopedSection() {
+        if (m_active) exit(m_id);
+    }
+
+    ScopedSection(const ScopedSection &) = delete;
+    ScopedSection &operator=(const ScopedSection &) = delete;
+private:
+    SectionId m_id;
+    bool m_active;
+};
+
+}
+
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+// Time the rest of the enclosing scope as section `name`. The name expression
+// is evaluated (and interned) only the first time this line is reached; in a
+// template it is evaluated once per instantiation.
+#define PROFILE_SCOPE(name)                                                                                                   \
+    static const ::Profiler::SectionId PROFILER_CONCAT(profilerSectionId_, __LINE__) = ::Profiler::section(name);             \
+    ::Profiler::ScopedSection PROFILER_CONCAT(profilerScopedSection_, __LINE__)(PROFILER_CONCAT(profilerSectionId_, __LINE__))
+
+#endif /* end of include guard: PROFILER_HH */
@@ -814,6 +814,11 @@ struct CSCMatrix {
 
     size_t nnz() const { return nz; }
 
+    // Bytes allocated for the column pointer, row index and value arrays.
+    size_t memoryUsage() const {
+        return (Ap.capacity() + Ai.capacity()) * sizeof(_Index) + Ax.capacity() * sizeof(_Real);
+    }
+
     CSCMatrix(_Index mm = 0, _Index nn = 0)
         : m(mm), n(nn), nz(0) { }
 
@@ -1986,8 +1991,18 @@ public:
         if (mat.nnz() > size_t(m_A.nzmax)) throw std::runtime_error("Matrix has more nonzeros than the one passed to the constructor"); // again, necessary but not sufficient!
 
         m_AStorage = std::forward<Mat>(mat);
-        m_matrixUpdated();
+        refactorize(isInTryCatch);
+    }
+
+    // The system matrix currently stored by the factorizer. Its values may be
+    // modified in place (e.g., to shift the diagonal) before calling
+    // `refactorize`, but its sparsity pattern must be left unchanged.
+    SuiteSparseMatrix &matrix() { return m_AStorage; }
 
+    // Recompute the numeric factorization of the stored system matrix,
+    // reusing the symbolic factorization.
+    void refactorize(bool isInTryCatch = false) {
+        m_matrixUpdated(); // the stored matrix's arrays may have been reallocated
         if (!hasFactorization()) return; // no symbolic factorization was computed yet; nothing needs to be updated.
 
         BENCHMARK_START_TIMER("CHOLMOD Numeric Factorize");
@@ -2152,6 +2167,11 @@ public:
     size_t m() const { return m_A.nrow; }
     size_t n() const { return m_A.ncol; }
 
+    // Bytes held by the numeric factorization(s) (including a stashed one)
+    // and by the copy of the factorized matrix.
+    size_t factorMemoryUsage() const { return m_factorBytes(m_L) + m_factorBytes(m_L_stashed); }
+    size_t matrixMemoryUsage() const { return m_AStorage.memoryUsage(); }
+
     void setSuppressWarnings(bool suppressWarnings) {
         m_c->print = suppressWarnings ? 0 : 2;
     }
@@ -2165,6 +2185,24 @@ private:
 
     SuiteSparseMatrix m_AStorage;
 
+    static size_t m_factorBytes(const cholmod_factor *L) {
+        if (L == nullptr) return 0;
+        using Index = SuiteSparse_long;
+        const size_t n = L->n;
+        size_t result = 2 * n * sizeof(Index); // Perm, ColCount
+        if (L->is_super) {
+            result += 3 * (L->nsuper + 1) * sizeof(Index)  // super, pi, px
+                    + L->ssize * sizeof(Index)             // s
+                    + L->xsize * sizeof(double);           // x
+        }
+        else if (L->xtype != CHOLMOD_PATTERN) {
+            result += (n + 1) * sizeof(Index)              // p
+                    + (n + 2 * (n + 2)) * sizeof(Index)    // nz, next, prev
+                    + L->nzmax * (sizeof(Index) + sizeof(double)); // i, x
+        }
+        return result;
+    }
+
     void m_matrixUpdated() {
         m_A.p = m_AStorage.Ap.data();
         m_A.i = m_AStorage.Ai.data();
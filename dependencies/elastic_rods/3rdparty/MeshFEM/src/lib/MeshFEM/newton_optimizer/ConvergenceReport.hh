@@ -3,9 +3,22 @@
 #include <map>
 #include <string>
 
+// Cost breakdown of a single Newton iteration.
+struct NewtonIterationStatistics {
+    Real time              = 0; // wall time of the whole iteration (seconds)
+    Real assemblyTime      = 0; // Hessian evaluation and reduction
+    Real factorizationTime = 0; // factorizing and solving the (shifted) Newton system, including failed attempts
+    Real lineSearchTime    = 0; // backtracking/trust region step and gradient descent fallback
+    size_t failedFactorizations = 0; // factorizations rejected as indefinite (each one increases tau)
+    Real tau               = 0; // shift added to make the Hessian positive definite (NaN: factorization reused)
+    size_t backtrackingSteps = 0; // rejected step lengths (or trust region radii)
+    size_t workingSetChanges = 0; // bound constraints added to or removed from the working set
+};
+
 struct ConvergenceReport {
     bool success = false;
     bool backtracking_failure = false;
+    bool cancelled = false;             // the solve was stopped early by the progress callback
 
     // Entries for iterations 0..numIters inclusive (numIters + 1 entries in total)
     std::vector<Real> energy, gradientNorm,
@@ -13,6 +26,9 @@ struct ConvergenceReport {
                       stepLength;       // step length chosen by this iteration's line search (only numIters meaningful entries; last is duplicated)
     std::vector<bool> indefinite;       // whether the Hessian is indefinite                  (only numIters meaningful entries; last is duplicated)
     std::vector<std::map<std::string, Real>> customData;
+    // Per-iteration cost breakdown, with the same entries as `energy` (the
+    // last entry covers the final gradient evaluation). Only filled by NewtonOptimizer.
+    std::vector<NewtonIterationStatistics> statistics;
 
     void addEntry(Real e, Real gn, Real gfn, Real alpha, bool indef) {
         energy.push_back(e);
@@ -24,6 +40,9 @@ struct ConvergenceReport {
     void addCustomData(const std::map<std::string, Real> &data) {
         customData.push_back(data);
     }
+    void addStatistics(const NewtonIterationStatistics &s) {
+        statistics.push_back(s);
+    }
 
     size_t numIters() const { return energy.size() ? energy.size() - 1 : 0; }
     void printEntry(size_t entry = std::numeric_limits<size_t>::max()) const {
@@ -1,29 +1,84 @@
 #include "newton_optimizer.hh"
 #include "../AutomaticDifferentiation.hh"
+#include <atomic>
+#include <chrono>
+#include <tuple>
 
-// Modify `H` to enforce the active bound constraints (which are of the form d_i = 0 when solving H d = -g).
-// In order to preserve H's sparsity pattern, instead of removing the rows/columns for pinned variables `i`,
-// we replace these rows/columns with rows/columns of the identity.
-void fixVariablesInWorkingSet(const NewtonProblem &prob, SuiteSparseMatrix &H, const WorkingSet &ws) {
-    if (ws.size() == 0) return;
-
-    BENCHMARK_START_TIMER("fixVariablesInWorkingSet");
-    // Zero out the rows corresponding to all variables in the working set
-    for (size_t elem = 0; elem < H.Ai.size(); ++elem)
-        if (ws.fixesVariable(H.Ai[elem])) H.Ax[elem] = 0.0;
-
-    // Zero out working set vars' columns/gradient components, placing a 1 on the diagonal
-    const SuiteSparseMatrix::index_type nv = prob.numVars();
-    for (SuiteSparseMatrix::index_type var = 0; var < nv; ++var) {
-        if (!ws.fixesVariable(var)) continue;
-        const auto start = H.Ap[var    ],
-                   end   = H.Ap[var + 1];
-        Eigen::Map<Eigen::VectorXd>(H.Ax.data() + start, end - start).setZero();
-        assert(H.Ai[end - 1] == var);
-        H.Ax[end - 1] = 1.0; // Diagonal should be the column's last entry; we assume it exists in the sparsity pattern!
+using StatisticsClock = std::chrono::steady_clock;
+static Real secondsSince(StatisticsClock::time_point start) {
+    return std::chrono::duration<Real>(StatisticsClock::now() - start).count();
+}
+
+void ReducedHessianMap::build(const SuiteSparseMatrix &H, const std::vector<char> &isFixed, const WorkingSet &ws) {
+    PROFILE_SCOPE("ReducedHessianMap::build");
+    const SuiteSparse_long n = H.n;
+    if ((H.m != n) || (isFixed.size() != size_t(n))) throw std::runtime_error("ReducedHessianMap size mismatch");
+    const auto &wsFixed = ws.fixedVariables();
+
+    constexpr SuiteSparse_long NONE = -1;
+    std::vector<SuiteSparse_long> reducedIdx(n, NONE);
+    SuiteSparse_long nr = 0;
+    for (SuiteSparse_long i = 0; i < n; ++i)
+        if (!isFixed[i]) reducedIdx[i] = nr++;
+
+    SuiteSparseMatrix result(nr, nr);
+    result.symmetry_mode = H.symmetry_mode;
+    result.Ap.reserve(nr + 1);
+    result.Ai.reserve(H.nz);
+    result.Ax.reserve(H.nz);
+    m_source.clear();
+    m_source.reserve(H.nz);
+
+    m_diagIdx.assign(nr, NONE);
+
+    result.Ap.push_back(0);
+    for (SuiteSparse_long j = 0; j < n; ++j) {
+        if (isFixed[j]) continue;
+        for (auto idx = H.Ap[j]; idx < H.Ap[j + 1]; ++idx) {
+            const SuiteSparse_long i = H.Ai[idx];
+            if (isFixed[i]) continue;
+            if (i == j) m_diagIdx[reducedIdx[j]] = result.Ai.size();
+            result.Ai.push_back(reducedIdx[i]);
+            // The active bound constraints (d_i = 0 when solving H d = -g) are
+            // enforced by replacing the working set variables' rows/columns
+            // with rows/columns of the identity, preserving H's sparsity pattern.
+            const bool pinned = wsFixed[i] || wsFixed[j];
+            result.Ax.push_back((pinned && (i == j)) ? 1.0 : 0.0);
+            m_source.push_back(pinned ? NONE : idx);
+        }
+        result.Ap.push_back(result.Ai.size());
     }
+    result.nz = result.Ai.size();
+
+    static std::atomic<size_t> nextPatternId(1);
+    m_patternId = nextPatternId++;
+    m_hessian   = std::move(result);
+    m_metric    = SuiteSparseMatrix();
+    m_hasMetric = m_metricIsDiagonal = false;
+    m_fullAi    = H.Ai.data();
+    m_fullN     = n;
+    m_fullNz    = H.nz;
+    m_isFixed   = isFixed;
+    m_wsFixed   = wsFixed;
+}
 
-    BENCHMARK_STOP_TIMER("fixVariablesInWorkingSet");
+void ReducedHessianMap::m_gather(const SuiteSparseMatrix &A, SuiteSparseMatrix &out) const {
+    if ((A.n != m_fullN) || (A.nz != m_fullNz)) throw std::runtime_error("Matrix does not have the sparsity pattern of the ReducedHessianMap");
+    const size_t nz = m_source.size();
+    for (size_t k = 0; k < nz; ++k) {
+        const SuiteSparse_long src = m_source[k];
+        if (src >= 0) out.Ax[k] = A.Ax[src];
+    }
+}
+
+bool ReducedHessianMap::m_isDiagonal(const SuiteSparseMatrix &A) const {
+    const SuiteSparse_long n = A.n;
+    for (SuiteSparse_long j = 0; j < n; ++j) {
+        if (m_diagIdx[j] < 0) return false;
+        for (auto idx = A.Ap[j]; idx < A.Ap[j + 1]; ++idx)
+            if ((idx != m_diagIdx[j]) && (A.Ax[idx] != 0.0)) return false;
+    }
+    return true;
 }
 
 // Solve the Newton system `H d = -g`, modifying H to be pos. def. if it is indefinite.
@@ -33,7 +88,7 @@ void fixVariablesInWorkingSet(const NewtonProblem &prob, SuiteSparseMatrix &H, c
 // Upon return, "solver" holds a factorization of the matrix:
 //     (H + tau (M / ||M||_2))
 Real NewtonOptimizer::newton_step(Eigen::VectorXd &step, const Eigen::VectorXd &g, const WorkingSet &ws, Real &beta, const Real betaMin, const bool feasibility) {
-    BENCHMARK_SCOPED_TIMER_SECTION ns_timer("newton_step");
+    PROFILE_SCOPE("newton_step");
     step.resize(g.size());
     if (&ws.problem() != &get_problem()) throw std::runtime_error("Working set is for a different problem");
 
@@ -50,7 +105,7 @@ Real NewtonOptimizer::newton_step(Eigen::VectorXd &step, const Eigen::VectorXd &
 
     // Though the full mass matrix is cached by NewtonProblem, we also want to cache
     // the reduced version (if it is ever needed).
-    std::unique_ptr<SuiteSparseMatrix> M_reduced;
+    const SuiteSparseMatrix *M_reduced = nullptr;
 
     Eigen::VectorXd x, gReduced;
 
@@ -73,52 +128,94 @@ Real NewtonOptimizer::newton_step(Eigen::VectorXd &step, const Eigen::VectorXd &
 
     Eigen::VectorXd g_free = ws.getFreeComponent(g); // Zero out the entries with active bound constraints.
 
-    if (solver.hasFactorization()) {
+    const bool useDD = m_useDomainDecomposition();
+    if (useDD ? m_ddSolver.hasFactorization() : solver.hasFactorization()) {
         if (!hUpdtCtr.needsUpdate() && (ws.size() == 0)) { // TODO: Reusing factorizations with bound constraints needs more care
             hUpdtCtr.reusedHessian();
             gReduced = removeFixedEntries(g_free);
-            solver.solveExistingFactorization(gReduced, x);
+            if (useDD) m_ddSolver.solve(gReduced, x);
+            else       solver.solveExistingFactorization(gReduced, x);
             postprocessSolution();
+            m_iterationStats.tau = NAN;
             return NAN; // tau is unknown/undefined since we're reusing an old factorization; no negative curvature direction will be attempted by caller.
         }
     }
 
-    SuiteSparseMatrix H_reduced;
-    { BENCHMARK_SCOPED_TIMER_SECTION hevalTimer("hessEval");
-        H_reduced = prob->hessian(hProjCtr.shouldUseProjection());
-        fixVariablesInWorkingSet(*prob, H_reduced, ws);
-        H_reduced.rowColRemoval([&](SuiteSparse_long i) { return isFixed[i]; });
+    // The reduced system is gathered into storage owned by m_reducedHessianMap,
+    // whose pattern is only rebuilt when the fixed variables/working set change.
+    const SuiteSparseMatrix &H_reduced = [&]() -> const SuiteSparseMatrix & {
+        PROFILE_SCOPE("hessEval");
+        const auto assemblyStart = StatisticsClock::now();
+        const SuiteSparseMatrix &H = prob->hessian(hProjCtr.shouldUseProjection());
+        const SuiteSparseMatrix &result = m_reducedHessianMapFor(H, ws).hessian(H);
+        m_iterationStats.assemblyTime += secondsSince(assemblyStart);
+        return result;
+    }();
+
+    if (useDD && ((m_ddPatternId != m_reducedHessianMap.patternId()) || (m_ddSolver.numSubdomains() != options.numSubdomains))) {
+        m_ddSolver.analyze(H_reduced, options.numSubdomains);
+        m_ddPatternId = m_reducedHessianMap.patternId();
     }
 
     Real currentTauScale = 0; // simple caching mechanism to avoid excessive calls to tauScale()
+    bool shiftingInPlace = false; // whether the factorizer's matrix holds H_reduced with a shifted diagonal
+    SuiteSparseMatrix Hshifted;   // shifted system for the domain decomposition solver
+    const auto factorizationStart = StatisticsClock::now();
     while (true) {
         try {
-            BENCHMARK_SCOPED_TIMER_SECTION timer("Newton solve");
+            PROFILE_SCOPE("Newton solve");
             if (tau != 0) {
-                if (!M_reduced) {
-                    M_reduced = std::make_unique<SuiteSparseMatrix>(prob->metric());
-                    fixVariablesInWorkingSet(*prob, *M_reduced, ws);
-                    M_reduced->rowColRemoval([&](SuiteSparse_long i) { return isFixed[i]; });
-                }
+                if (!M_reduced) M_reduced = &m_reducedHessianMap.metric(prob->metric());
 
-                auto Hmod = H_reduced;
-                Hmod.addWithIdenticalSparsity(*M_reduced, tau * currentTauScale); // Note: rows/cols corresponding to vars with active bounds will now have a nonzero value different from 1 on the diagonal, but this is fine since the RHS component is zero...
-                solver.updateFactorization(std::move(Hmod));
+                // Note: rows/cols corresponding to vars with active bounds will now have a nonzero value different from 1 on the diagonal, but this is fine since the RHS component is zero...
+                if (useDD) {
+                    if (!shiftingInPlace || !m_reducedHessianMap.metricIsDiagonal()) {
+                        Hshifted = H_reduced;
+                        shiftingInPlace = true;
+                    }
+                    if (m_reducedHessianMap.metricIsDiagonal()) m_reducedHessianMap.shiftDiagonal(Hshifted, H_reduced, tau * currentTauScale);
+                    else                                        Hshifted.addWithIdenticalSparsity(*M_reduced, tau * currentTauScale);
+                    m_ddSolver.factorize(Hshifted);
+                }
+                else if (m_reducedHessianMap.metricIsDiagonal()) {
+                    // Shift the diagonal of the factorizer's copy of H_reduced
+                    // in place; the original diagonal is kept in H_reduced.
+                    if (!shiftingInPlace) {
+                        solver.matrix() = H_reduced;
+                        shiftingInPlace = true;
+                    }
+                    m_reducedHessianMap.shiftDiagonal(solver.matrix(), H_reduced, tau * currentTauScale);
+                    solver.refactorize();
+                }
+                else {
+                    auto Hmod = H_reduced;
+                    Hmod.addWithIdenticalSparsity(*M_reduced, tau * currentTauScale);
+                    solver.updateFactorization(std::move(Hmod));
+                }
+            }
+            else if (useDD) {
+                m_ddSolver.factorize(H_reduced);
             }
             else {
                 solver.updateFactorization(H_reduced);
             }
 
-            BENCHMARK_SCOPED_TIMER_SECTION solve("Solve");
+            PROFILE_SCOPE("Solve");
 
             gReduced = removeFixedEntries(g_free);
-            solver.solve(gReduced, x);
-            if (!solver.checkPosDef()) throw std::runtime_error("System matrix is not positive definite");
+            if (useDD) {
+                m_ddSolver.solve(gReduced, x);
+            }
+            else {
+                solver.solve(gReduced, x);
+                if (!solver.checkPosDef()) throw std::runtime_error("System matrix is not positive definite");
+            }
             postprocessSolution();
 
             break;
         }
         catch (std::exception &e) {
+            ++m_iterationStats.failedFactorizations;
             tau  = std::max(  4 * tau, beta);
             beta = std::max(0.5 * tau, betaMin);
             if (options.verboseNonPosDef) std::cout << e.what() << "; increasing tau to " << tau << "\n";
@@ -133,6 +230,8 @@ Real NewtonOptimizer::newton_step(Eigen::VectorXd &step, const Eigen::VectorXd &
             }
         }
     }
+    m_iterationStats.factorizationTime += secondsSince(factorizationStart);
+    m_iterationStats.tau = tau;
 
     // Notify controllers that we have factorized a new Hessian
     // and whether or not it was indefinite.
@@ -143,6 +242,139 @@ Real NewtonOptimizer::newton_step(Eigen::VectorXd &step, const Eigen::VectorXd &
     return tau;
 }
 
+// Dogleg method (Nocedal and Wright 2006, pp 73) for the model
+//      m(p) = g^T p + 1/2 p^T B p,   B = H + tau (M / ||M||_2),
+// where B is the positive definite matrix factorized by `newton_step`. The
+// Newton point `newtonStep` and the Cauchy point are computed once; when a
+// step is rejected, only the dogleg path is re-intersected with the smaller
+// trust region, so rejections cost an energy evaluation but no factorization.
+bool NewtonOptimizer::trust_region_step(const Eigen::VectorXd &vars, const Eigen::VectorXd &g_free, const WorkingSet &ws,
+                                        const Eigen::VectorXd &newtonStep, Real tau, Real currEnergy,
+                                        Eigen::VectorXd &step, Real &alpha) {
+    PROFILE_SCOPE("Trust region step");
+    if (std::isnan(tau)) tau = 0.0; // reused factorization: use the current Hessian as the model.
+
+    auto applyB = [&](const Eigen::VectorXd &v) {
+        Eigen::VectorXd result = prob->hessian(options.getHessianProjectionController().shouldUseProjection()).apply(v);
+        if (tau != 0.0) result += (tau * tauScale()) * prob->metric().apply(v);
+        return result;
+    };
+
+    // Steepest descent direction restricted to the free variables (and to the
+    // LEQ constraint's tangent space so that the dogleg path stays feasible).
+    Eigen::VectorXd d = -g_free;
+    if (prob->hasLEQConstraint()) {
+        Eigen::VectorXd a = ws.getFreeComponent(prob->LEQConstraintMatrix());
+        for (size_t var : prob->fixedVars()) a[var] = 0.0;
+        d -= a * (d.dot(a) / a.squaredNorm());
+    }
+
+    const Real newtonNorm = newtonStep.norm();
+    if (m_trustRegionRadius <= 0) m_trustRegionRadius = (options.trustRegionRadius > 0) ? options.trustRegionRadius : newtonNorm;
+
+    // The model Hessian is only available at the current iterate (the
+    // problem's Hessian is re-evaluated when its variables change), so all
+    // products needed to evaluate the model are formed before any trial step.
+    // Dogleg steps lie in span{newtonStep, d}; bound clamping only perturbs
+    // them at the bound-constrained variables, whose block of B is gathered.
+    const Eigen::VectorXd Bn = applyB(newtonStep), Bd = applyB(d);
+    std::vector<std::tuple<size_t, size_t, Real>> boundBlock; // (i, j, weighted B_ij) with i, j bounded
+    {
+        std::vector<bool> isBounded(vars.size(), false);
+        for (const auto &bc : prob->boundConstraints()) isBounded[bc.idx] = true;
+        auto gatherBoundBlock = [&](const SuiteSparseMatrix &B, Real scale) {
+            const bool triangular = B.symmetry_mode != SuiteSparseMatrix::SymmetryMode::NONE;
+            for (SuiteSparse_long j = 0; j < B.n; ++j) {
+                if (!isBounded[j]) continue;
+                for (SuiteSparse_long idx = B.Ap[j]; idx < B.Ap[j + 1]; ++idx) {
+                    const size_t i = B.Ai[idx];
+                    if (!isBounded[i]) continue;
+                    boundBlock.emplace_back(i, j, ((triangular && (i != size_t(j))) ? 2.0 : 1.0) * scale * B.Ax[idx]);
+                }
+            }
+        };
+        if (prob->numBoundConstraints() > 0) {
+            gatherBoundBlock(prob->hessian(options.getHessianProjectionController().shouldUseProjection()), 1.0);
+            if (tau != 0.0) gatherBoundBlock(prob->metric(), tau * tauScale());
+        }
+    }
+
+    // Unconstrained minimizer of the model along the steepest descent direction.
+    Real cauchyCoeff = 0.0;
+    const Real dnorm = d.norm();
+    if (dnorm > 0) {
+        const Real dBd = d.dot(Bd);
+        cauchyCoeff = (dBd > 0) ? (-g_free.dot(d) / dBd) : (m_trustRegionRadius / dnorm);
+    }
+    const Eigen::VectorXd cauchyStep = cauchyCoeff * d;
+    const Real cauchyNorm = cauchyStep.norm();
+
+    // Coefficients (c_n, c_d) of the dogleg step c_n newtonStep + c_d d.
+    auto doglegStep = [&](Real radius) -> std::pair<Real, Real> {
+        if (newtonNorm <= radius) return { 1.0, 0.0 };
+        if ((cauchyNorm >= radius) || (dnorm == 0)) return (dnorm == 0) ? std::make_pair(radius / newtonNorm, 0.0)
+                                                                        : std::make_pair(0.0, radius / dnorm);
+        // Find s in [0, 1] with ||cauchyStep + s (newtonStep - cauchyStep)|| = radius
+        const Eigen::VectorXd diff = newtonStep - cauchyStep;
+        const Real a = diff.squaredNorm(), b = 2 * cauchyStep.dot(diff), c = cauchyStep.squaredNorm() - radius * radius;
+        const Real s = std::min(std::max((-b + std::sqrt(std::max(b * b - 4 * a * c, 0.0))) / (2 * a), 0.0), 1.0);
+        return { s, (1 - s) * cauchyCoeff };
+    };
+
+    const Real eta = 1e-4;
+    Eigen::VectorXd steppedVars;
+    for (size_t trit = 0; trit < options.nbacktrack_iter; ++trit) {
+        const auto coeffs = doglegStep(m_trustRegionRadius);
+        step = coeffs.first * newtonStep + coeffs.second * d;
+        const Real stepNorm = step.norm();
+        const bool onBoundary = stepNorm >= (1 - 1e-8) * m_trustRegionRadius;
+
+        // As in the line search, overshoot the first blocking bound slightly
+        // (the variables are clamped) so that nearby bounds enter the working set together.
+        Real feasible_alpha = prob->feasibleStepLength(vars, step).first;
+        alpha = std::min(1.0, feasible_alpha * 2);
+
+        steppedVars = vars + alpha * step;
+        prob->applyBoundConstraintsInPlace(steppedVars);
+        prob->setVars(steppedVars);
+        const Real steppedEnergy = prob->energy();
+
+        // Model decrease for p = alpha step + c, where the clamping
+        // correction c is supported on the bound-constrained variables:
+        //      p^T B p = alpha^2 step^T B step + 2 c^T (alpha B step) + c^T B c
+        const Eigen::VectorXd p = steppedVars - vars;
+        const Eigen::VectorXd Bstep = alpha * (coeffs.first * Bn + coeffs.second * Bd);
+        const Eigen::VectorXd c = p - alpha * step;
+        Real pBp = alpha * step.dot(Bstep) + 2 * c.dot(Bstep);
+        for (const auto &entry : boundBlock)
+            pBp += c[std::get<0>(entry)] * std::get<2>(entry) * c[std::get<1>(entry)];
+        const Real predicted = -(g_free.dot(p) + 0.5 * pBp);
+        Real decrease = currEnergy - steppedEnergy;
+        if (std::isfinite(steppedEnergy) && !std::isfinite(currEnergy))
+            decrease = safe_numeric_limits<Real>::max(); // always accept steps from invalid to valid states.
+
+        const Real rho = (predicted > 0) ? decrease / predicted : -1.0;
+        if (!std::isfinite(steppedEnergy) || (rho < 0.25)) m_trustRegionRadius = 0.25 * std::min(m_trustRegionRadius, p.norm());
+        else if ((rho > 0.75) && onBoundary)               m_trustRegionRadius = 2 * m_trustRegionRadius;
+
+        // Accept the step if the decrease is a sufficient fraction of the
+        // predicted one (or if the decrease is too small to be measured
+        // accurately and the energy does not increase significantly).
+        if (std::isfinite(steppedEnergy) &&
+               ((rho >= eta) || (std::abs(predicted) < 1e-8 * std::abs(currEnergy) && (decrease > -1e-10 * std::abs(currEnergy)))))
+            return true;
+
+        ++m_iterationStats.backtrackingSteps;
+        if (options.verbose > 1) std::cout << "Rejected trust region step with rho = " << rho << "; shrinking radius to " << m_trustRegionRadius << std::endl;
+    }
+
+    std::cout << "Trust region failure with:" << std::endl
+              << "Curr energy: " << currEnergy << std::endl
+              << "Trust region radius: " << m_trustRegionRadius << std::endl
+              << std::endl;
+    return false;
+}
+
 ConvergenceReport NewtonOptimizer::optimize() {
     // Indices of the bound constraints in our working set.
     WorkingSet workingSet(*prob);
@@ -150,6 +382,13 @@ ConvergenceReport NewtonOptimizer::optimize() {
 }
 
 ConvergenceReport NewtonOptimizer::optimize(WorkingSet &workingSet) {
+    if (options.arena.empty()) return m_optimize(workingSet);
+    ConvergenceReport report;
+    options.arena.execute([&]() { report = m_optimize(workingSet); });
+    return report;
+}
+
+ConvergenceReport NewtonOptimizer::m_optimize(WorkingSet &workingSet) {
     size_t ngd_fallback_steps = options.ngd_fallback_steps; // maximum number of gradient descent steps to take as a fallback when backtracking for the newton step fails.
 
     prob->setUseIdentityMetric(options.useIdentityMetric);
@@ -164,6 +403,7 @@ ConvergenceReport NewtonOptimizer::optimize(WorkingSet &workingSet) {
     solver.setSuppressWarnings(!options.verboseNonPosDef);
 
     m_cachedHessianL2Norm.reset();
+    m_trustRegionRadius = -1.0;
 
     if (prob->hasLEQConstraint()) {
         if (!prob->LEQConstraintIsFeasible()) {
@@ -218,15 +458,26 @@ ConvergenceReport NewtonOptimizer::optimize(WorkingSet &workingSet) {
     options.getHessianProjectionController().reset();
     options.getHessianUpdateController()    .reset();
 
+    // Each reported iterate gets one statistics entry; an iteration's entry is
+    // recorded once its step (including any gradient descent fallback) is taken.
+    m_iterationStats = NewtonIterationStatistics();
+    auto iterationStart = StatisticsClock::now();
+    auto recordStatistics = [&]() {
+        m_iterationStats.time = secondsSince(iterationStart);
+        report.addStatistics(m_iterationStats);
+        m_iterationStats = NewtonIterationStatistics();
+        iterationStart = StatisticsClock::now();
+    };
+
     for (it = 1; it <= options.niter; ++it) {
-        BENCHMARK_SCOPED_TIMER_SECTION it_timer("Newton iterate");
+        PROFILE_SCOPE("Newton iterate");
 
         Real currEnergy;
-        { BENCHMARK_SCOPED_TIMER_SECTION t2("Preamble");
+        { PROFILE_SCOPE("Preamble");
 
         // std::cout << "pre-update gradient: " << zeroOutFixedVars(prob->gradient(false)).norm() << std::endl;
         {
-            BENCHMARK_SCOPED_TIMER_SECTION cbTimer("Callback");
+            PROFILE_SCOPE("Callback");
             prob->iterationCallback(it);
         }
         // Note: we allow the iteration callback to modify the variables!
@@ -247,6 +498,7 @@ ConvergenceReport NewtonOptimizer::optimize(WorkingSet &workingSet) {
         bool ws_updated = workingSet.remove_if([&](size_t bc_idx) {
                 bool shouldRemove = prob->boundConstraint(bc_idx).shouldRemoveFromWorkingSet(g, g_free_norm);
                 if (shouldRemove && options.verboseWorkingSet) { std::cout << "Removed constraint " << bc_idx << " from working set" << std::endl; }
+                if (shouldRemove) ++m_iterationStats.workingSetChanges;
                 return shouldRemove;
             });
 
@@ -260,10 +512,10 @@ ConvergenceReport NewtonOptimizer::optimize(WorkingSet &workingSet) {
         } // End of 'Preamble' timer
 
 
-        { BENCHMARK_SCOPED_TIMER_SECTION t2("Compute descent direction");
+        Real tau;
+        { PROFILE_SCOPE("Compute descent direction");
 
         Real old_beta = beta;
-        Real tau;
         try {
             tau = newton_step(step, g_free, workingSet, beta, betaMin);
         }
@@ -274,13 +526,13 @@ ConvergenceReport NewtonOptimizer::optimize(WorkingSet &workingSet) {
         isIndefinite = (tau != 0.0);
 
         // Only add in negative curvature directions when "tau" is a reasonable estimate for the smallest eigenvalue and the gradient has become small.
-        if (options.useNegativeCurvatureDirection && ((tau > old_beta) || (tau == betaMin)) && (g_free.norm() < 100 * options.gradTol)) {
-            BENCHMARK_SCOPED_TIMER_SECTION timer("Negative curvature dir");
+        // (The trust region already limits steps along directions of negative curvature.)
+        if (options.useNegativeCurvatureDirection && !options.useTrustRegion && !m_useDomainDecomposition() && ((tau > old_beta) || (tau == betaMin)) && (g_free.norm() < 100 * options.gradTol)) {
+            PROFILE_SCOPE("Negative curvature dir");
             // std::cout.precision(19);
             std::cout << "Computing negative curvature direction for scaled tau = " << tau / prob->metricL2Norm() << '\n';
-            auto M_reduced = prob->metric();
-            fixVariablesInWorkingSet(*prob, M_reduced, workingSet);
-            M_reduced.rowColRemoval([&](SuiteSparse_long i) { return isFixed[i]; });
+            const SuiteSparseMatrix &M_reduced = m_reducedHessianMapFor(prob->hessian(options.getHessianProjectionController().shouldUseProjection()), workingSet)
+                                                    .metric(prob->metric());
             auto d = negativeCurvatureDirection(solver, M_reduced, 1e-6);
             {
                 Real dnorm = d.norm();
@@ -314,65 +566,78 @@ ConvergenceReport NewtonOptimizer::optimize(WorkingSet &workingSet) {
         //     std::cout << "Found step with directional derivative: " << directionalDerivative << std::endl;
 
         BENCHMARK_START_TIMER_SECTION("Backtracking");
-        // Simple backtracking line search to ensure a sufficient decrease
-
-        Real feasible_alpha;
-        size_t blocking_idx;
-        std::tie(feasible_alpha, blocking_idx) = prob->feasibleStepLength(vars, step);
-
-        // To add multiple nearby bounds to the working set at once, we allow the
-        // step to overshoot the bounds (note: variables will be clamped to the bounds anyway before
-        // evaluating the objective). Then all bounds violated by the step length obtaining
-        // sufficient decrease are added to the working set.
-        alpha = std::min(1.0, feasible_alpha * 2);
+        // Simple backtracking line search (or trust region step) to ensure a sufficient decrease
+        const auto lineSearchStart = StatisticsClock::now();
 
         const Real c_1 = 1e-2;
-        size_t bit;
+        size_t bit = 0;
 
         Eigen::VectorXd steppedVars;
-        for (bit = 0; bit < options.nbacktrack_iter; ++bit) {
-            steppedVars = vars + alpha * step;
-            prob->applyBoundConstraintsInPlace(steppedVars);
-            prob->setVars(steppedVars);
-            const Real steppedEnergy = prob->energy();
-            const Real sufficientDecrease = -c_1 * alpha * directionalDerivative;
-            Real decrease = currEnergy - steppedEnergy;
-            if (std::isfinite(steppedEnergy) && !std::isfinite(currEnergy))
-                decrease = safe_numeric_limits<Real>::max(); // always accept steps from invalid to valid states.
-            // Terminate line search successfully if a sufficient decrease is achieved
-            // (or if we cannot expect to evaluate the energy decrease accurately
-            // enough to measure a sufficient decrease--and the energy does not
-            // increase significantly)
-            if  ((decrease >= sufficientDecrease)
-                    || (std::abs(sufficientDecrease) < 1e-8 * std::abs(currEnergy)
-                            && (decrease > -1e-10 * std::abs(currEnergy)))) {
-                break;
-            }
+        if (options.useTrustRegion) {
+            const Eigen::VectorXd newtonStep = step;
+            if (!trust_region_step(vars, g_free, workingSet, newtonStep, tau, currEnergy, step, alpha))
+                bit = options.nbacktrack_iter; // fall back to gradient descent below
+        }
+        else {
+            Real feasible_alpha;
+            size_t blocking_idx;
+            std::tie(feasible_alpha, blocking_idx) = prob->feasibleStepLength(vars, step);
+
+            // To add multiple nearby bounds to the working set at once, we allow the
+            // step to overshoot the bounds (note: variables will be clamped to the bounds anyway before
+            // evaluating the objective). Then all bounds violated by the step length obtaining
+            // sufficient decrease are added to the working set.
+            alpha = std::min(1.0, feasible_alpha * 2);
+
+            for (bit = 0; bit < options.nbacktrack_iter; ++bit) {
+                steppedVars = vars + alpha * step;
+                prob->applyBoundConstraintsInPlace(steppedVars);
+                prob->setVars(steppedVars);
+                const Real steppedEnergy = prob->energy();
+                const Real sufficientDecrease = -c_1 * alpha * directionalDerivative;
+                Real decrease = currEnergy - steppedEnergy;
+                if (std::isfinite(steppedEnergy) && !std::isfinite(currEnergy))
+                    decrease = safe_numeric_limits<Real>::max(); // always accept steps from invalid to valid states.
+                // Terminate line search successfully if a sufficient decrease is achieved
+                // (or if we cannot expect to evaluate the energy decrease accurately
+                // enough to measure a sufficient decrease--and the energy does not
+                // increase significantly)
+                if  ((decrease >= sufficientDecrease)
+                        || (std::abs(sufficientDecrease) < 1e-8 * std::abs(currEnergy)
+                                && (decrease > -1e-10 * std::abs(currEnergy)))) {
+                    break;
+                }
 
-            if (alpha > feasible_alpha) {
-                // It's possible that our slight overshooting and clamping to the bounds did not achieve a sufficient
-                // decrease whereas a step to the first violated bound would; make sure we try this exact step too
-                // before continuing the backtracking search.
-                alpha = feasible_alpha;
-            }
-            else {
-                alpha *= 0.5;
-            }
+                if (alpha > feasible_alpha) {
+                    // It's possible that our slight overshooting and clamping to the bounds did not achieve a sufficient
+                    // decrease whereas a step to the first violated bound would; make sure we try this exact step too
+                    // before continuing the backtracking search.
+                    alpha = feasible_alpha;
+                }
+                else {
+                    alpha *= 0.5;
+                }
 
-            if (bit == options.nbacktrack_iter - 1) {
-                std::cout << "Backtracking failure with:" << std::endl
-                          << "Curr energy: " << currEnergy << std::endl
-                          << "Stepped energy: " << steppedEnergy << std::endl
-                          << "sufficientDecrease: " << sufficientDecrease << std::endl
-                          << "decrease: " << decrease << std::endl
-                          << std::endl;
+                if (bit == options.nbacktrack_iter - 1) {
+                    std::cout << "Backtracking failure with:" << std::endl
+                              << "Curr energy: " << currEnergy << std::endl
+                              << "Stepped energy: " << steppedEnergy << std::endl
+                              << "sufficientDecrease: " << sufficientDecrease << std::endl
+                              << "decrease: " << decrease << std::endl
+                              << std::endl;
+                }
             }
+            m_iterationStats.backtrackingSteps += bit;
         }
+        m_iterationStats.lineSearchTime += secondsSince(lineSearchStart);
         BENCHMARK_STOP_TIMER_SECTION("Backtracking");
 
         reportIterate(it - 1, currEnergy, zg, g_free); // Record iterate statistics, now that we know alpha, isIndefinite
         prob->customIterateReport(report);
 
+        if (options.progressCallback && options.progressCallback(NewtonProgress{it - 1, currEnergy, zg.norm(), g_free.norm(), alpha, isIndefinite}))
+            report.cancelled = true;
+
         // Add to the working set all bounds encountered by the step of length "alpha"
         for (size_t bci = 0; bci < prob->numBoundConstraints(); ++bci) {
             if (alpha >= prob->boundConstraint(bci).feasibleStepLength(vars, step)) {
@@ -386,6 +651,7 @@ ConvergenceReport NewtonOptimizer::optimize(WorkingSet &workingSet) {
                     throw std::logic_error("Re-encountered bound in working set");
                 }
                 workingSet.add(bci);
+                ++m_iterationStats.workingSetChanges;
                 if (options.verboseWorkingSet) std::cout << "Added constraint " << bci << " to working set\n";
             }
         }
@@ -396,9 +662,11 @@ ConvergenceReport NewtonOptimizer::optimize(WorkingSet &workingSet) {
             if (ngd_fallback_steps-- == 0) {
                 if (options.verbose) std::cout << "Maximum number of gradient descent fallback steps reached.\n";
                 prob->setVars(vars);
+                recordStatistics();
                 break;
             }
 
+            const auto fallbackStart = StatisticsClock::now();
             size_t gd_bit;
             directionalDerivative = -g_free.squaredNorm();
             alpha *= step.norm() / g_free.norm(); // Start with the same step magnitude where the Newton step backtracking failed....
@@ -413,11 +681,22 @@ ConvergenceReport NewtonOptimizer::optimize(WorkingSet &workingSet) {
                     break;
                 alpha *= 0.5;
             }
+            m_iterationStats.backtrackingSteps += gd_bit;
+            m_iterationStats.lineSearchTime += secondsSince(fallbackStart);
+        }
+
+        recordStatistics();
+
+        if (report.cancelled) {
+            if (options.verbose) std::cout << "Newton solve cancelled by the progress callback.\n";
+            ++it; // the step just taken produced iterate `it`, reported below
+            break;
         }
     }
 
     // Report the last iterate; gradient must be re-computed in case the iteration limit was exceeded
-    if (it > options.niter) {
+    // (or the solve was cancelled after taking a step).
+    if ((it > options.niter) || report.cancelled) {
         prob->iterationCallback(it);
         g = prob->gradient(true);
     }
@@ -425,6 +704,7 @@ ConvergenceReport NewtonOptimizer::optimize(WorkingSet &workingSet) {
     projectOutLEQConstrainedComponents(zg);
     prob->customIterateReport(report);
     reportIterate(it - 1, prob->energy(), zg, workingSet.getFreeComponent(zg));
+    recordStatistics(); // final gradient evaluation (or the partial iteration that terminated the solve)
     std::cout << std::flush;
 
     if ((options.verboseWorkingSet > 1) && workingSet.size()) {
@@ -4,7 +4,9 @@
 /*! @file
 //  Newton-type optimization method for large, sparse problems.
 //  This is Newton's method with a (sparse) Hessian modification strategy to
-//  deal with the indefinite case.
+//  deal with the indefinite case. Steps are globalized either with a
+//  backtracking line search (default) or with a dogleg trust region built on
+//  the factorized, modified Hessian.
 */
 //  Author:  Julian Panetta (jpanetta), julian.panetta@gmail.com
 //  Created:  09/27/2018 11:29:48
@@ -14,8 +16,12 @@
 
 #include <vector>
 #include <cmath>
+#include <functional>
 #include <MeshFEM/SparseMatrices.hh>
+#include <MeshFEM/DomainDecompositionSolver.hh>
 #include <MeshFEM/Eigensolver.hh>
+#include <MeshFEM/Parallelism.hh>
+#include <MeshFEM/MemoryReport.hh>
 #include "ConvergenceReport.hh"
 #include "HessianProjectionController.hh"
 #include "HessianUpdateController.hh"
@@ -222,6 +228,15 @@ struct MESHFEM_EXPORT NewtonProblem {
     // Allow problems to attach custom convergence information to each optimization iterate.
     virtual void customIterateReport(ConvergenceReport &/* report */) const { }
 
+    // Memory held by the cached Hessian and metric matrices.
+    MemoryReport memoryReport() const {
+        MemoryReport result;
+        result.add("cached_hessian", m_cachedHessian ? m_cachedHessian->memoryUsage() : 0);
+        result.add("cached_metric", (m_cachedMetric   ? m_cachedMetric  ->memoryUsage() : 0)
+                                  + (m_identityMetric ? m_identityMetric->memoryUsage() : 0));
+        return result;
+    }
+
     virtual ~NewtonProblem() { }
 
     bool disableCaching = false; // To be used when, e.g., this problem is wrapped by another problem which does its own Hessian caching...
@@ -314,6 +329,7 @@ struct MESHFEM_EXPORT WorkingSet {
     std::unique_ptr<WorkingSet> clone() const { return std::make_unique<WorkingSet>(*this); }
 
     const NewtonProblem &problem() const { return m_prob; }
+    const std::vector<char> &fixedVariables() const { return m_varFixed; }
 
     void report(const Eigen::VectorXd &vars, const Eigen::VectorXd &g) const {
         for (size_t bci = 0; bci < m_prob.numBoundConstraints(); ++bci) {
@@ -328,6 +344,18 @@ private:
     std::vector<char> m_varFixed; // Whether a variable is fixed by one of the constraints in the working set
 };
 
+// Statistics of an accepted iterate passed to `NewtonOptimizerOptions::progressCallback`
+// (the same quantities recorded in the ConvergenceReport).
+struct NewtonProgress {
+    size_t iteration;
+    Real energy, gradientNorm, freeGradientNorm, stepLength;
+    bool indefinite;
+};
+
+// Return `true` to cancel the solve; the optimizer then stops at the current
+// (accepted) iterate and flags the report as `cancelled`.
+using NewtonProgressCallback = std::function<bool(const NewtonProgress &)>;
+
 struct NewtonOptimizerOptionsBase {
     Real gradTol = 2e-8,
          beta = 1e-8;
@@ -344,6 +372,11 @@ struct NewtonOptimizerOptionsBase {
     size_t nbacktrack_iter = 25;               // Number of backtracking iterations to run before giving up on the linesearch
     size_t ngd_fallback_steps = 3;             // Total number of "fall-backs iterations" trying the neg gradient instead of the Newton direction
     int  verboseWorkingSet = 0;                // Whether to report changes to the working set (>0) and the contents of nonempty working sets upon termination (>1).
+    bool useTrustRegion = false;               // Globalize with a dogleg trust region instead of the backtracking line search.
+    Real trustRegionRadius = -1.0;             // Initial trust region radius (Euclidean norm of the step); nonpositive: length of the first Newton step.
+    size_t numSubdomains = 0;                  // If > 1, solve the Newton systems with a DomainDecompositionSolver over this many subdomains instead of a single CHOLMOD factorization (ignored for problems with an LEQ constraint; disables negative curvature directions).
+    NewtonProgressCallback progressCallback;   // Called after each iteration's step is accepted (optional).
+    ParallelismArena arena;                    // Arena the solve runs in (empty: the caller's arena).
 };
 
 // The part of the optimizer interface that is not trivially copyable.
@@ -461,6 +494,77 @@ private:
     Real hessianTrace, hessianL2Norm;
 };
 
+// Precomputed extraction of the reduced Newton system from the full Hessian:
+// the rows/columns of the fixed variables are removed, and those of the
+// working set's variables are replaced by rows/columns of the identity.
+// The reduced sparsity pattern and the index of each gathered entry in the
+// full matrix are built once per fixed variable set/working set, after which
+// reducing a matrix only gathers its values into persistent storage.
+// Matrices passed to `hessian`/`metric` must have the sparsity pattern of the
+// full Hessian the map was built from (NewtonProblem constructs its Hessian
+// and metric from the same `hessianSparsityPattern`).
+struct MESHFEM_EXPORT ReducedHessianMap {
+    // Whether the map was built for these fixed variables and working set,
+    // and for a Hessian with H's storage.
+    bool matches(const SuiteSparseMatrix &H, const std::vector<char> &isFixed, const WorkingSet &ws) const {
+        return (H.Ai.data() == m_fullAi) && (H.n == m_fullN) && (H.nz == m_fullNz)
+            && (isFixed == m_isFixed) && (ws.fixedVariables() == m_wsFixed);
+    }
+
+    void build(const SuiteSparseMatrix &H, const std::vector<char> &isFixed, const WorkingSet &ws);
+
+    // Reduced versions of the full Hessian `H` and of the metric `M`, each
+    // stored in its own persistent matrix.
+    const SuiteSparseMatrix &hessian(const SuiteSparseMatrix &H) { m_gather(H, m_hessian); return m_hessian; }
+    const SuiteSparseMatrix &metric (const SuiteSparseMatrix &M) {
+        if (!m_hasMetric) { m_metric = m_hessian; m_hasMetric = true; } // the entries pinned by the working set are shared
+        m_gather(M, m_metric);
+        m_metricIsDiagonal = m_isDiagonal(m_metric);
+        return m_metric;
+    }
+
+    // Whether the reduced metric last passed through `metric` is diagonal
+    // (e.g., a lumped mass matrix or the identity).
+    bool metricIsDiagonal() const { return m_hasMetric && m_metricIsDiagonal; }
+
+    // Set the diagonal of `A` (a matrix with the reduced pattern) to that of
+    // the reduced Hessian `H` plus `alpha` times the reduced diagonal metric,
+    // leaving the off-diagonal entries untouched.
+    void shiftDiagonal(SuiteSparseMatrix &A, const SuiteSparseMatrix &H, Real alpha) const {
+        if (!metricIsDiagonal()) throw std::logic_error("shiftDiagonal requires a diagonal metric");
+        for (SuiteSparse_long d : m_diagIdx) A.Ax[d] = H.Ax[d] + alpha * m_metric.Ax[d];
+    }
+
+    void clear() { *this = ReducedHessianMap(); }
+
+    // Identifier of the reduced sparsity pattern, unique to each `build` call (0: not built).
+    size_t patternId() const { return m_patternId; }
+
+    size_t memoryUsage() const {
+        return m_hessian.memoryUsage() + m_metric.memoryUsage() + heapBytes(m_source) + heapBytes(m_diagIdx)
+             + heapBytes(m_isFixed) + heapBytes(m_wsFixed);
+    }
+
+private:
+    void m_gather(const SuiteSparseMatrix &A, SuiteSparseMatrix &out) const;
+    bool m_isDiagonal(const SuiteSparseMatrix &A) const;
+
+    SuiteSparseMatrix m_hessian, m_metric;
+    bool m_hasMetric = false, m_metricIsDiagonal = false;
+    // Index into the full matrix's values of each reduced entry (-1 for the
+    // constant entries of the working set's identity rows/columns).
+    std::vector<SuiteSparse_long> m_source;
+    // Index of each reduced variable's diagonal entry (-1 if it is absent from the pattern).
+    std::vector<SuiteSparse_long> m_diagIdx;
+
+    // Configuration the map was built for.
+    const SuiteSparse_long *m_fullAi = nullptr;
+    SuiteSparse_long m_fullN = 0, m_fullNz = 0;
+    size_t m_patternId = 0;
+    std::vector<char> m_isFixed;
+    std::vector<char> m_wsFixed;
+};
+
 struct MESHFEM_EXPORT NewtonOptimizer {
     NewtonOptimizer(std::unique_ptr<NewtonProblem> &&p) : solver(p->hessianReducedSparsityPattern()) {
         prob = std::move(p);
@@ -473,6 +577,7 @@ struct MESHFEM_EXPORT NewtonOptimizer {
         isFixed.assign(prob->numVars(), false);
         for (size_t fv : fixedVars) isFixed[fv] = true;
         solver.updateSymbolicFactorization(prob->hessianReducedSparsityPattern());
+        m_reducedHessianMap.clear();
     }
 
     ConvergenceReport optimize();
@@ -480,6 +585,16 @@ struct MESHFEM_EXPORT NewtonOptimizer {
 
     Real newton_step(Eigen::VectorXd &step, const Eigen::VectorXd &g, const WorkingSet &ws, Real &beta, const Real betaMin, const bool feasibility = false);
 
+    // Dogleg step for the quadratic model built from the (modified) Hessian
+    // factorized by the last call to `newton_step`, which produced `newtonStep`
+    // with shift `tau`. Shrinks the trust region and retries (without
+    // refactorizing) until the step achieves a sufficient decrease, at most
+    // `options.nbacktrack_iter` times. On success, the problem's variables are
+    // set to the clamped `vars + alpha * step` and true is returned.
+    bool trust_region_step(const Eigen::VectorXd &vars, const Eigen::VectorXd &g_free, const WorkingSet &ws,
+                           const Eigen::VectorXd &newtonStep, Real tau, Real currEnergy,
+                           Eigen::VectorXd &step, Real &alpha);
+
     // Calculate a Newton step with empty working set and default beta/betaMin.
     Real newton_step(Eigen::VectorXd &step, const Eigen::VectorXd &g) {
         Real beta = options.beta;
@@ -494,11 +609,17 @@ struct MESHFEM_EXPORT NewtonOptimizer {
     // the problem is solved or the iteration limit is reached, solver/kkt_solver
     // hold values from the previous iteration (before the final linesearch
     // step).
+    // These factorizations always use CHOLMOD, even if the Newton steps are
+    // solved by domain decomposition (see `options.numSubdomains`).
     void update_factorizations(const WorkingSet &ws) {
         // Computing a Newton step updates the Cholesky factorization in
         // "solver" and (if applicable) the kkt_solver as a side-effect.
         Eigen::VectorXd dummy;
-        newton_step(dummy, Eigen::VectorXd::Zero(prob->numVars()), ws, options.beta, std::min(options.beta, 1e-6));
+        const bool forceCholmod = m_forceCholmod;
+        m_forceCholmod = true;
+        try { newton_step(dummy, Eigen::VectorXd::Zero(prob->numVars()), ws, options.beta, std::min(options.beta, 1e-6)); }
+        catch (...) { m_forceCholmod = forceCholmod; throw; }
+        m_forceCholmod = forceCholmod;
     }
 
     void update_factorizations() { update_factorizations(WorkingSet(*prob)); }
@@ -508,6 +629,16 @@ struct MESHFEM_EXPORT NewtonOptimizer {
     const NewtonProblem &get_problem() const { return *prob; }
           NewtonProblem &get_problem()       { return *prob; }
 
+    // Memory held by the problem's caches and by the Hessian factorization.
+    MemoryReport memoryReport() const {
+        MemoryReport result = prob->memoryReport();
+        result.add("factorized_matrix", solver.matrixMemoryUsage());
+        result.add("cholmod_factor",    solver.factorMemoryUsage());
+        result.add("reduced_hessian",   m_reducedHessianMap.memoryUsage());
+        result.add("domain_decomposition", m_ddSolver.memoryUsage());
+        return result;
+    }
+
     // Construct a vector of reduced components by removing the entries of "x" corresponding
     // to fixed variables. This is a (partial) inverse of extractFullSolution.
     void removeFixedEntriesInPlace(Eigen::VectorXd &x) const {
@@ -547,7 +678,22 @@ struct MESHFEM_EXPORT NewtonOptimizer {
     mutable CachedHessianL2Norm m_cachedHessianL2Norm;
 
 private:
+    ConvergenceReport m_optimize(WorkingSet &ws); // body of `optimize`, run inside `options.arena`
+
     std::unique_ptr<NewtonProblem> prob;
+    Real m_trustRegionRadius = -1.0; // current radius; reset at the start of each `optimize` call
+    NewtonIterationStatistics m_iterationStats; // cost breakdown of the iteration in progress (filled by `newton_step` and `m_optimize`)
+    ReducedHessianMap m_reducedHessianMap; // rebuilt when the fixed variables or the working set change
+    ReducedHessianMap &m_reducedHessianMapFor(const SuiteSparseMatrix &H, const WorkingSet &ws) {
+        if (!m_reducedHessianMap.matches(H, isFixed, ws)) m_reducedHessianMap.build(H, isFixed, ws);
+        return m_reducedHessianMap;
+    }
+
+    // Solver used for the Newton steps when `options.numSubdomains > 1`.
+    DomainDecompositionSolver m_ddSolver;
+    size_t m_ddPatternId = 0;    // patternId of the reduced Hessian m_ddSolver was analyzed for
+    bool m_forceCholmod = false; // set by update_factorizations
+    bool m_useDomainDecomposition() const { return (options.numSubdomains > 1) && !prob->hasLEQConstraint() && !m_forceCholmod; }
 };
 
 #endif /* end of include guard: NEWTON_OPTIMIZER_HH */
@@ -2,6 +2,7 @@
 #include <pybind11/iostream.h>
 #include <pybind11/stl.h>
 #include <MeshFEM/GlobalBenchmark.hh>
+#include <functional>
 namespace py = pybind11;
 
 PYBIND11_MODULE(_benchmark, m) {
@@ -15,18 +16,22 @@ PYBIND11_MODULE(_benchmark, m) {
             if (includeMessages) BENCHMARK_REPORT(); else BENCHMARK_REPORT_NO_MESSAGES();
         },
         py::arg("include_messages") = false);
-#ifdef BENCHMARK
+    m.def("set_enabled", &Profiler::setEnabled, py::arg("enable"));
+    m.def("enabled",     &Profiler::enabled);
+
+    // Merged call tree as nested dicts: {name: {"time": seconds, "calls": n, "children": {...}}}
     m.def("to_dict", []() {
-            std::map<std::string, std::pair<double, std::map<std::string, double>>> result;
-            for (const auto &sec : g_timer.sections()) {
-                result[sec.first] = std::make_pair(sec.second.elapsed(), std::map<std::string, double>());
-                auto &secResult = result[sec.first].second;
-                for (const auto &t : sec.second.timers)
-                    secResult[t.first] = t.second.time;
-            }
-            return result;
+            std::function<py::dict(const Profiler::Node &)> children = [&](const Profiler::Node &node) {
+                py::dict result;
+                for (const auto &c : node.children) {
+                    py::dict entry;
+                    entry["time"]     = c.seconds;
+                    entry["calls"]    = c.calls;
+                    entry["children"] = children(c);
+                    result[py::str(c.name)] = entry;
+                }
+                return result;
+            };
+            return children(Profiler::report());
         });
-#else
-    m.def("to_dict", []() { });
-#endif
 }
@@ -2,6 +2,7 @@
 #include <pybind11/stl.h>
 #include <pybind11/eigen.h>
 #include <pybind11/iostream.h>
+#include <pybind11/functional.h>
 namespace py = pybind11;
 
 #include <MeshFEM/newton_optimizer/newton_optimizer.hh>
@@ -69,6 +70,11 @@ PYBIND11_MODULE(py_newton_optimizer, m) {
         .def_readwrite("stdoutFlushInterval",           &NewtonOptimizerOptions::stdoutFlushInterval)
         .def_readwrite("nbacktrack_iter",               &NewtonOptimizerOptions::nbacktrack_iter)
         .def_readwrite("ngd_fallback_steps",            &NewtonOptimizerOptions::ngd_fallback_steps)
+        .def_readwrite("useTrustRegion",                &NewtonOptimizerOptions::useTrustRegion)
+        .def_readwrite("trustRegionRadius",             &NewtonOptimizerOptions::trustRegionRadius)
+        .def_readwrite("numSubdomains",                 &NewtonOptimizerOptions::numSubdomains)
+        .def_readwrite("progressCallback",              &NewtonOptimizerOptions::progressCallback, "Called with a NewtonProgress after each iteration; return True to cancel the solve.")
+        .def_readwrite("arena",                         &NewtonOptimizerOptions::arena, "ParallelismArena the solve runs in (empty: the caller's arena).")
         .def_property("hessianProjectionController", [](const NewtonOptimizerOptions &opts) -> HessianProjectionController & { return opts.getHessianProjectionController(); },
                                                      [](      NewtonOptimizerOptions &opts, const HessianProjectionController &h) { opts.setHessianProjectionController(h); },
                                                      py::return_value_policy::reference)
@@ -78,8 +84,29 @@ PYBIND11_MODULE(py_newton_optimizer, m) {
         ;
     addSerializationBindings<NewtonOptimizerOptions, PyNOO, NewtonOptimizerOptions::StateBackwardCompat>(pyNewtonOptimizerOptions);
 
+    py::class_<NewtonProgress>(m, "NewtonProgress")
+        .def_readonly("iteration",        &NewtonProgress::iteration)
+        .def_readonly("energy",           &NewtonProgress::energy)
+        .def_readonly("gradientNorm",     &NewtonProgress::gradientNorm)
+        .def_readonly("freeGradientNorm", &NewtonProgress::freeGradientNorm)
+        .def_readonly("stepLength",       &NewtonProgress::stepLength)
+        .def_readonly("indefinite",       &NewtonProgress::indefinite)
+        ;
+
+    py::class_<NewtonIterationStatistics>(m, "NewtonIterationStatistics")
+        .def_readonly("time",                 &NewtonIterationStatistics::time)
+        .def_readonly("assemblyTime",         &NewtonIterationStatistics::assemblyTime)
+        .def_readonly("factorizationTime",    &NewtonIterationStatistics::factorizationTime)
+        .def_readonly("lineSearchTime",       &NewtonIterationStatistics::lineSearchTime)
+        .def_readonly("failedFactorizations", &NewtonIterationStatistics::failedFactorizations)
+        .def_readonly("tau",                  &NewtonIterationStatistics::tau)
+        .def_readonly("backtrackingSteps",    &NewtonIterationStatistics::backtrackingSteps)
+        .def_readonly("workingSetChanges",    &NewtonIterationStatistics::workingSetChanges)
+        ;
+
     py::class_<ConvergenceReport>(m, "ConvergenceReport")
         .def_readonly("success",          &ConvergenceReport::success)
+        .def_readonly("cancelled",        &ConvergenceReport::cancelled)
         .def         ("numIters",         &ConvergenceReport::numIters)
         .def_readonly("energy",           &ConvergenceReport::energy)
         .def_readonly("gradientNorm",     &ConvergenceReport::gradientNorm)
@@ -87,6 +114,7 @@ PYBIND11_MODULE(py_newton_optimizer, m) {
         .def_readonly("stepLength",       &ConvergenceReport::stepLength)
         .def_readonly("indefinite",       &ConvergenceReport::indefinite)
         .def_readonly("customData",       &ConvergenceReport::customData)
+        .def_readonly("statistics",       &ConvergenceReport::statistics)
         ;
 
     using BC = NewtonProblem::BoundConstraint;
@@ -150,6 +178,11 @@ PYBIND11_MODULE(py_newton_optimizer, m) {
             }, py::arg("feasibility") = false)
         .def("get_problem", py::overload_cast<>(&NewtonOptimizer::get_problem), py::return_value_policy::reference)
         .def("setFixedVars", &NewtonOptimizer::setFixedVars, py::arg("fixedVars"))
+        .def("memoryReport", [](const NewtonOptimizer &opt) {
+                py::dict result;
+                for (const auto &c : opt.memoryReport().components) result[py::str(c.first)] = c.second;
+                return result;
+            }, "Bytes held by the problem's cached Hessian/metric and by the factorization")
         .def_readwrite("options", &NewtonOptimizer::options)
         ;
 }
@@ -8,4 +8,12 @@ PYBIND11_MODULE(_parallelism, m) {
     m.def("set_max_num_tbb_threads",           &set_max_num_tbb_threads,           py::arg("num_threads"));
     m.def("set_gradient_assembly_num_threads", &set_gradient_assembly_num_threads, py::arg("num_threads"));
     m.def("set_hessian_assembly_num_threads",  &set_hessian_assembly_num_threads,  py::arg("num_threads"));
+
+    py::class_<ParallelismArena>(m, "ParallelismArena")
+        .def(py::init<>())
+        .def(py::init<int, int>(), py::arg("num_threads"), py::arg("first_pinned_core") = -1)
+        .def("empty",           &ParallelismArena::empty)
+        .def("maxConcurrency",  &ParallelismArena::maxConcurrency)
+        .def("firstPinnedCore", &ParallelismArena::firstPinnedCore)
+        ;
 }
@@ -96,7 +96,7 @@ struct ActuationSparsifier {
 
     VecX_T<Real> apply_hess(const Eigen::Ref<const Eigen::VectorXd> &vars,
                             const Eigen::Ref<const Eigen::VectorXd> &delta_vars) {
-        BENCHMARK_SCOPED_TIMER_SECTION timer("apply_hess");
+        PROFILE_SCOPE("apply_hess");
         if (size_t(      vars.size()) != numVars()) throw std::runtime_error("Incorrect vars size");
         if (size_t(delta_vars.size()) != numVars()) throw std::runtime_error("Incorrect delta vars size");
         m_updateAdjointState(vars);
@@ -1790,48 +1790,124 @@ ElasticRod_T<Real_>::ElasticRod_T(const ElasticRod_T<Real2> &r) {
     dc_out.update(pts, thetas);
 }
 
+template<typename Real_>
+template<typename Real2>
+void ElasticRod_T<Real_>::transferState(const ElasticRod_T<Real2> &r) {
+    if (r.numVertices() != numVertices()) throw std::runtime_error("Rod discretization mismatch in transferState");
+
+    castStdADVector         (r.restPoints(),    m_restPoints);
+    castStdADVectorDirectors(r.restDirectors(), m_restDirectors);
+    castStdADVector         (r.restKappas(),    m_restKappa);
+    castStdADVector         (r.restTwists(),    m_restTwist);
+    castStdADVector         (r.restLengths(),   m_restLen);
+
+    setDesignParameterConfig(r.getDesignParameterConfig().restLen,
+                             r.getDesignParameterConfig().restKappa);
+
+    auto &dc_in = r.deformedConfiguration();
+    DeformedState &dc_out = deformedConfiguration();
+
+    castStdADVector         (dc_in.sourceTangent, dc_out.sourceTangent);
+    castStdADVectorDirectors(dc_in.sourceReferenceDirectors, dc_out.sourceReferenceDirectors);
+    castStdADVector         (dc_in.sourceTheta, dc_out.sourceTheta);
+    castStdADVector         (dc_in.sourceReferenceTwist, dc_out.sourceReferenceTwist);
+
+    std::vector<Pt3> pts;
+    std::vector<Real_> thetas;
+    castStdADVector(dc_in.points(), pts);
+    castStdADVector(dc_in.thetas(), thetas);
+    dc_out.update(pts, thetas);
+}
+
+template<typename Real_>
+size_t ElasticRod_T<Real_>::DeformedState::memoryUsage() const {
+    return heapBytes(m_point) + heapBytes(m_theta)
+         + heapBytes(referenceDirectors) + heapBytes(referenceTwist) + heapBytes(tangent) + heapBytes(materialFrame)
+         + heapBytes(kb) + heapBytes(kappa) + heapBytes(len) + heapBytes(per_corner_kappa)
+         + heapBytes(sourceTangent) + heapBytes(sourceReferenceDirectors) + heapBytes(sourceMaterialFrame)
+         + heapBytes(sourceTheta) + heapBytes(sourceReferenceTwist);
+}
+
+template<typename Real_>
+MemoryReport ElasticRod_T<Real_>::memoryReport() const {
+    MemoryReport result;
+    result.add("rest_state", heapBytes(m_restPoints) + heapBytes(m_restDirectors) + heapBytes(m_restKappa)
+                           + heapBytes(m_restTwist)  + heapBytes(m_restLen)       + heapBytes(m_restKappaVars));
+
+    size_t deformedStates = heapBytes(m_deformedStates);
+    for (const auto &ds : m_deformedStates) deformedStates += ds.memoryUsage();
+    result.add("deformed_states", deformedStates);
+
+    result.add("stiffness", heapBytes(m_density) + heapBytes(m_stretchingStiffness)
+                          + heapBytes(m_twistingStiffness) + heapBytes(m_bendingStiffness));
+
+    size_t materials = heapBytes(m_edgeMaterial);
+    for (const auto &mat : m_edgeMaterial) materials += mat.memoryUsage();
+    result.add("materials", materials);
+    return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-// Explicit instantiation for ordinary double type and autodiff type.
+// Explicit instantiation for ordinary double type and autodiff types.
 ////////////////////////////////////////////////////////////////////////////////
 template struct ElasticRod_T<  Real>;
 template struct ElasticRod_T<ADReal>;
+template struct ElasticRod_T<ADRealBatch>;
 template ElasticRod_T<ADReal>::ElasticRod_T(const ElasticRod_T<Real> &);
+template ElasticRod_T<ADRealBatch>::ElasticRod_T(const ElasticRod_T<Real> &);
+template void ElasticRod_T<ADReal     >::transferState(const ElasticRod_T<Real> &);
+template void ElasticRod_T<ADRealBatch>::transferState(const ElasticRod_T<Real> &);
 
 // Instantiations for the non-default gradient stencil types.
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradient<GradientStencilMaskCustom       >(bool, ElasticRod_T<  Real>::EnergyType, bool, bool, const GradientStencilMaskCustom        &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradient<GradientStencilMaskCustom       >(bool, ElasticRod_T<ADReal>::EnergyType, bool, bool, const GradientStencilMaskCustom        &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradient<GradientStencilMaskCustom       >(bool, ElasticRod_T<ADRealBatch>::EnergyType, bool, bool, const GradientStencilMaskCustom        &) const;
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradient<GradientStencilMaskTerminalsOnly>(bool, ElasticRod_T<  Real>::EnergyType, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradient<GradientStencilMaskTerminalsOnly>(bool, ElasticRod_T<ADReal>::EnergyType, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradient<GradientStencilMaskTerminalsOnly>(bool, ElasticRod_T<ADRealBatch>::EnergyType, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
 
 // The following annoying explicit instantiations really shouldn't be needed,
 // but due to an apparent bug, GCC 8.3 (the default on Ubuntu 19.04) fails to
 // instantiate them automatically...
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradient<GradientStencilMaskIncludeAll   >(bool, ElasticRod_T<  Real>::EnergyType, bool, bool, const GradientStencilMaskIncludeAll    &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradient<GradientStencilMaskIncludeAll   >(bool, ElasticRod_T<ADReal>::EnergyType, bool, bool, const GradientStencilMaskIncludeAll    &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradient<GradientStencilMaskIncludeAll   >(bool, ElasticRod_T<ADRealBatch>::EnergyType, bool, bool, const GradientStencilMaskIncludeAll    &) const;
 
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergyStretch<GradientStencilMaskIncludeAll>(      bool, bool, const GradientStencilMaskIncludeAll &) const;
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergyBend   <GradientStencilMaskIncludeAll>(bool, bool, bool, const GradientStencilMaskIncludeAll &) const;
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergyTwist  <GradientStencilMaskIncludeAll>(bool, bool, bool, const GradientStencilMaskIncludeAll &) const;
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergy       <GradientStencilMaskIncludeAll>(bool, bool, bool, const GradientStencilMaskIncludeAll &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergyStretch<GradientStencilMaskIncludeAll>(      bool, bool, const GradientStencilMaskIncludeAll &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergyStretch<GradientStencilMaskIncludeAll>(      bool, bool, const GradientStencilMaskIncludeAll &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergyBend   <GradientStencilMaskIncludeAll>(bool, bool, bool, const GradientStencilMaskIncludeAll &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergyBend   <GradientStencilMaskIncludeAll>(bool, bool, bool, const GradientStencilMaskIncludeAll &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergyTwist  <GradientStencilMaskIncludeAll>(bool, bool, bool, const GradientStencilMaskIncludeAll &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergyTwist  <GradientStencilMaskIncludeAll>(bool, bool, bool, const GradientStencilMaskIncludeAll &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergy       <GradientStencilMaskIncludeAll>(bool, bool, bool, const GradientStencilMaskIncludeAll &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergy       <GradientStencilMaskIncludeAll>(bool, bool, bool, const GradientStencilMaskIncludeAll &) const;
 
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergyStretch<GradientStencilMaskTerminalsOnly>(      bool, bool, const GradientStencilMaskTerminalsOnly &) const;
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergyBend   <GradientStencilMaskTerminalsOnly>(bool, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergyTwist  <GradientStencilMaskTerminalsOnly>(bool, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergy       <GradientStencilMaskTerminalsOnly>(bool, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergyStretch<GradientStencilMaskTerminalsOnly>(      bool, bool, const GradientStencilMaskTerminalsOnly &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergyStretch<GradientStencilMaskTerminalsOnly>(      bool, bool, const GradientStencilMaskTerminalsOnly &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergyBend   <GradientStencilMaskTerminalsOnly>(bool, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergyBend   <GradientStencilMaskTerminalsOnly>(bool, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergyTwist  <GradientStencilMaskTerminalsOnly>(bool, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergyTwist  <GradientStencilMaskTerminalsOnly>(bool, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergy       <GradientStencilMaskTerminalsOnly>(bool, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergy       <GradientStencilMaskTerminalsOnly>(bool, bool, bool, const GradientStencilMaskTerminalsOnly &) const;
 
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergyStretch<GradientStencilMaskCustom>(      bool, bool, const GradientStencilMaskCustom &) const;
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergyBend   <GradientStencilMaskCustom>(bool, bool, bool, const GradientStencilMaskCustom &) const;
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergyTwist  <GradientStencilMaskCustom>(bool, bool, bool, const GradientStencilMaskCustom &) const;
 template ElasticRod_T<  Real>::Gradient ElasticRod_T<  Real>::gradEnergy       <GradientStencilMaskCustom>(bool, bool, bool, const GradientStencilMaskCustom &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergyStretch<GradientStencilMaskCustom>(      bool, bool, const GradientStencilMaskCustom &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergyStretch<GradientStencilMaskCustom>(      bool, bool, const GradientStencilMaskCustom &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergyBend   <GradientStencilMaskCustom>(bool, bool, bool, const GradientStencilMaskCustom &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergyBend   <GradientStencilMaskCustom>(bool, bool, bool, const GradientStencilMaskCustom &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergyTwist  <GradientStencilMaskCustom>(bool, bool, bool, const GradientStencilMaskCustom &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergyTwist  <GradientStencilMaskCustom>(bool, bool, bool, const GradientStencilMaskCustom &) const;
 template ElasticRod_T<ADReal>::Gradient ElasticRod_T<ADReal>::gradEnergy       <GradientStencilMaskCustom>(bool, bool, bool, const GradientStencilMaskCustom &) const;
+template ElasticRod_T<ADRealBatch>::Gradient ElasticRod_T<ADRealBatch>::gradEnergy       <GradientStencilMaskCustom>(bool, bool, bool, const GradientStencilMaskCustom &) const;
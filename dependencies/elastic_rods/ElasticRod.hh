@@ -18,6 +18,7 @@
 #include <MeshFEM/SparseMatrices.hh>
 #include <MeshFEM/Fields.hh>
 #include <MeshFEM/AutomaticDifferentiation.hh>
+#include <MeshFEM/MemoryReport.hh>
 #include <stdexcept>
 #include <numeric>
 
@@ -109,6 +110,13 @@ struct ElasticRod_T {
     // Converting constructor from another floating point type (e.g., double to autodiff)
     template<typename Real2>
     ElasticRod_T(const ElasticRod_T<Real2> &r);
+
+    // Transfer the rest and deformed state (but not the materials/stiffnesses)
+    // from a rod with the same discretization, possibly of a different
+    // floating point type. This is a cheaper alternative to the converting
+    // constructor for refreshing, e.g., an autodiff copy of a rod.
+    template<typename Real2>
+    void transferState(const ElasticRod_T<Real2> &r);
     // "Elastic" is needed for compatibility with SurfaceAttractedLinkage's EnergyType interface, where
     // we need to distinguish between elastic and surface-attraction energies.
     enum class EnergyType { Full, Bend, Twist, Stretch, Elastic = Full };
@@ -649,6 +657,25 @@ struct ElasticRod_T {
         coloredVisualizationGeometry(vertices, quads, averagedMaterialFrames, averagedCrossSections);
     }
 
+    // Topology-stable split of visualizationGeometry: the quads depend only on the
+    // number of edges and the cross-section boundaries, so they can be extracted once
+    // while `visualizationPositions` refreshes just the vertex positions (in the
+    // same order) after each deformation.
+    size_t numVisualizationVertices() const;
+    size_t numVisualizationQuads() const;
+    // *Appends* this rod's quads, with vertex indices shifted by `vertexOffset`.
+    void visualizationQuads(std::vector<MeshIO::IOElement> &quads, size_t vertexOffset = 0) const;
+    // Write the 3 * numVisualizationVertices() vertex coordinates to `positions`
+    // and, if `normals` is not null, unit vertex normals (obtained from the
+    // edge's own cross-section contour) to `normals`.
+    void visualizationPositions(double *positions, double *normals = nullptr,
+                                const bool averagedMaterialFrames = false,
+                                const bool averagedCrossSections = false) const;
+    // Single-precision variant for display pipelines working in float32.
+    void visualizationPositions(float *positions, float *normals = nullptr,
+                                const bool averagedMaterialFrames = false,
+                                const bool averagedCrossSections = false) const;
+
     void writeDebugData(const std::string &path) const;
     void saveVisualizationGeometry(const std::string &path, const bool averagedMaterialFrames = false, const bool averagedCrossSections = false) const;
 
@@ -859,17 +886,26 @@ struct ElasticRod_T {
             sourceReferenceTwist     = referenceTwist;
         }
 
+        size_t memoryUsage() const;
+
     private:
         std::vector<Pt3  > m_point; // Current position of each vertex
         std::vector<Real_> m_theta;  // Angle from reference director to first material frame vector d1
     };
 
+    // Heap memory held by the rod, broken down into its rest configuration,
+    // deformed state stack, stiffnesses and per-edge material copies.
+    MemoryReport memoryReport() const;
+
     ////////////////////////////////////////////////////////////////////////////
     // Accessors to be used for serialization only.
     ////////////////////////////////////////////////////////////////////////////
     void setInitialMinRestLen(Real_ val) { m_initMinRestLen = val; }
 
 private:
+    template<typename OutReal>
+    void m_visualizationPositions(OutReal *positions, OutReal *normals, const bool averagedMaterialFrames, const bool averagedCrossSections) const;
+
     // Rest configuration
     std::vector<Pt3>       m_restPoints;       // Original position of each vertex
     std::vector<Directors> m_restDirectors;    // Original reference frame (zero twist)
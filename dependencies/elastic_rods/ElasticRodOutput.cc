@@ -173,6 +173,107 @@ void ElasticRod_T<Real_>::coloredVisualizationGeometry(std::vector<MeshIO::IOVer
     if (stressVisualization) *stress = Eigen::Map<Eigen::VectorXd>(stressStl.data(), stressStl.size());
 }
 
+template<typename Real_>
+size_t ElasticRod_T<Real_>::numVisualizationVertices() const {
+    size_t result = 0;
+    for (size_t j = 0; j < numEdges(); ++j) result += 2 * material(j).crossSectionBoundaryPts.size();
+    return result;
+}
+
+template<typename Real_>
+size_t ElasticRod_T<Real_>::numVisualizationQuads() const {
+    size_t result = 0;
+    for (size_t j = 0; j < numEdges(); ++j) result += material(j).crossSectionBoundaryEdges.size();
+    return result;
+}
+
+// Same connectivity as coloredVisualizationGeometry (without stress visualization).
+template<typename Real_>
+void ElasticRod_T<Real_>::visualizationQuads(std::vector<MeshIO::IOElement> &quads, size_t vertexOffset) const {
+    size_t offset = vertexOffset;
+    for (size_t j = 0; j < numEdges(); ++j) {
+        for (const auto &ce : material(j).crossSectionBoundaryEdges) {
+            quads.emplace_back(offset + 2 * ce.first  + 1,
+                               offset + 2 * ce.first  + 0,
+                               offset + 2 * ce.second + 0,
+                               offset + 2 * ce.second + 1);
+        }
+        offset += 2 * material(j).crossSectionBoundaryPts.size();
+    }
+}
+
+// Same vertex positions as coloredVisualizationGeometry, computed without
+// any per-call allocation of the averaged cross-sections or of the output.
+template<typename Real_>
+template<typename OutReal>
+void ElasticRod_T<Real_>::m_visualizationPositions(OutReal *positions, OutReal *normals,
+                                                   const bool averagedMaterialFrames,
+                                                   const bool averagedCrossSections) const {
+    using OutVec3 = Eigen::Matrix<OutReal, 3, 1>;
+    const size_t ne = numEdges();
+    const auto &dc = deformedConfiguration();
+    using Pts = typename CrossSection::AlignedPointCollection;
+
+    std::vector<Point2D> contourNormals;
+    size_t out = 0;
+    for (size_t j = 0; j < ne; ++j) {
+        const Pts &pts = material(j).crossSectionBoundaryPts;
+        const Pts *pts_prev = (averagedCrossSections && (j >      0)) ? &material(j - 1).crossSectionBoundaryPts : nullptr;
+        const Pts *pts_next = (averagedCrossSections && (j < ne - 1)) ? &material(j + 1).crossSectionBoundaryPts : nullptr;
+        if ((pts_prev && (pts_prev->size() != pts.size())) || (pts_next && (pts_next->size() != pts.size())))
+            throw std::runtime_error("Cross-section contour size mismatch in interpolation");
+
+        Vec3 d1_a = dc.materialFrame[j].d1,
+             d2_a = dc.materialFrame[j].d2;
+        Vec3 d1_b = d1_a,
+             d2_b = d2_a;
+        if (averagedMaterialFrames) {
+            if (j >      0) { d1_a += dc.materialFrame[j - 1].d1; d2_a += dc.materialFrame[j - 1].d2; d1_a *= 0.5; d2_a *= 0.5; }
+            if (j < ne - 1) { d1_b += dc.materialFrame[j + 1].d1; d2_b += dc.materialFrame[j + 1].d2; d1_b *= 0.5; d2_b *= 0.5; }
+        }
+
+        if (normals) {
+            // The contour is oriented ccw in the d1-d2 plane: its outward normals are the edge vectors rotated cw.
+            contourNormals.assign(pts.size(), Point2D::Zero());
+            for (const auto &ce : material(j).crossSectionBoundaryEdges) {
+                const Point2D e = pts[ce.second] - pts[ce.first];
+                const Point2D n(e[1], -e[0]);
+                contourNormals[ce.first ] += n;
+                contourNormals[ce.second] += n;
+            }
+        }
+
+        const Vec3 &p_a = dc.point(j    ),
+                   &p_b = dc.point(j + 1);
+        for (size_t k = 0; k < pts.size(); ++k, out += 2) {
+            Point2D c_a = pts[k], c_b = pts[k];
+            if (pts_prev) c_a = 0.5 * (c_a + (*pts_prev)[k]);
+            if (pts_next) c_b = 0.5 * (c_b + (*pts_next)[k]);
+            Eigen::Map<OutVec3>(positions + 3 * (out + 0)) = stripAutoDiff((p_a + d1_a * c_a[0] + d2_a * c_a[1]).eval()).template cast<OutReal>();
+            Eigen::Map<OutVec3>(positions + 3 * (out + 1)) = stripAutoDiff((p_b + d1_b * c_b[0] + d2_b * c_b[1]).eval()).template cast<OutReal>();
+            if (normals) {
+                const Point2D &n = contourNormals[k];
+                Eigen::Map<OutVec3>(normals + 3 * (out + 0)) = stripAutoDiff((d1_a * n[0] + d2_a * n[1]).eval()).normalized().template cast<OutReal>();
+                Eigen::Map<OutVec3>(normals + 3 * (out + 1)) = stripAutoDiff((d1_b * n[0] + d2_b * n[1]).eval()).normalized().template cast<OutReal>();
+            }
+        }
+    }
+}
+
+template<typename Real_>
+void ElasticRod_T<Real_>::visualizationPositions(double *positions, double *normals,
+                                                 const bool averagedMaterialFrames,
+                                                 const bool averagedCrossSections) const {
+    m_visualizationPositions(positions, normals, averagedMaterialFrames, averagedCrossSections);
+}
+
+template<typename Real_>
+void ElasticRod_T<Real_>::visualizationPositions(float *positions, float *normals,
+                                                 const bool averagedMaterialFrames,
+                                                 const bool averagedCrossSections) const {
+    m_visualizationPositions(positions, normals, averagedMaterialFrames, averagedCrossSections);
+}
+
 // Append this rod's data to existing geometry/scalar field.
 template<typename Real_>
 void ElasticRod_T<Real_>::stressVisualizationGeometry(std::vector<MeshIO::IOVertex > &vertices,
@@ -222,7 +323,8 @@ void ElasticRod_T<Real_>::saveVisualizationGeometry(const std::string &path, con
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Explicit instantiation for ordinary double type and autodiff type.
+// Explicit instantiation for ordinary double type and autodiff types.
 ////////////////////////////////////////////////////////////////////////////////
 template struct ElasticRod_T<double>;
 template struct ElasticRod_T<ADReal>;
+template struct ElasticRod_T<ADRealBatch>;
@@ -12,7 +12,11 @@
 #include "RegularizationTerms.hh"
 #include "DesignOptimizationTerms.hh"
 
-enum class OptAlgorithm    : int { NEWTON_CG=0, BFGS=1 };
+#include <atomic>
+
+// NEWTON_CG/BFGS use Knitro when available and otherwise fall back to the
+// corresponding native solver from bound_constrained_optimizer.hh.
+enum class OptAlgorithm    : int { NEWTON_CG=0, BFGS=1, NATIVE_NEWTON_CG=2, NATIVE_LBFGSB=3 };
 enum class OptEnergyType { Full, ElasticBase, ElasticDeployed, Target, Regularization, Smoothing, ContactForce };
 enum class PredictionOrder : int { Zero = 0, One = 1, Two = 2};
 
@@ -60,6 +64,14 @@ struct LinkageOptimization {
 
     Real defaultLengthBound() const { return 0.125 * m_base.getPerSegmentRestLength().minCoeff(); }
 
+    // Bounds on the full design parameter vector (in the order rest
+    // curvatures, rest lengths, target angle):
+    //     Rest length parameters are between minRestLen and infinity
+    //     Rest curvature parameters are between -2*pi and 2*pi
+    //     Target average opening angle are between -2*pi and 2*pi
+    // A negative minRestLen selects defaultLengthBound().
+    void getDesignParameterBounds(Real minRestLen, Eigen::VectorXd &lb, Eigen::VectorXd &ub);
+
     Real J_regularization() { return objective.value("RestLengthMinimization"); }
     Real J_smoothing()      { return objective.value("RestCurvatureSmoothing"); }
 
@@ -98,6 +110,11 @@ struct LinkageOptimization {
     // Let the user manually inform us of this change.
     void invalidateAdjointState() { m_adjointStateIsCurrent = false; }
 
+    // The autodiff linkages are normally refreshed in place (transferring only
+    // the DoFs, rest state and design parameters). If the linkages' materials
+    // or other constant data are modified, call this to force a full rebuild.
+    void invalidateAutodiffLinkages() { m_autodiffLinkagesNeedRebuild = true; m_autodiffLinkagesAreCurrent = false; }
+
     // For python bindings
     const Eigen::MatrixXd getTargetSurfaceVertices(){ return target_surface_fitter.getTargetSurfaceVertices(); }
     const Eigen::MatrixXi getTargetSurfaceFaces()   { return target_surface_fitter.getTargetSurfaceFaces(); }
@@ -154,12 +171,27 @@ struct LinkageOptimization {
         throw std::runtime_error("Minimum angle constraint is not implemented.");
     }
 
+    // Run the design optimization with Knitro or the native bound-constrained solvers (see OptAlgorithm).
+    // Returns 0 on success. The nonlinear angle/flatness constraints are only supported by Knitro.
     int optimize(OptAlgorithm alg,  
             size_t num_steps, Real trust_region_scale, Real optimality_tol, 
             std::function<void()> &update_viewer,
             double minRestLen = -1, 
             bool applyAngleConstraint = false, bool applyFlatnessConstraint = false);
 
+    // Ask a running `optimize` to stop after the current iterate (e.g., from
+    // its `update_viewer` callback or from another thread); the optimizer
+    // then returns a nonzero status with the design at the last iterate.
+    // A request made before `optimize` is called makes it return immediately
+    // with that status; requests are cleared when `optimize` returns.
+    void requestTermination() { m_terminationRequested = true; }
+    bool terminationRequested() const { return m_terminationRequested; }
+
+    // Arena in which `optimize` runs (including its equilibrium solves); by
+    // default the base linkage's (see RodLinkage::parallelismArena).
+    const ParallelismArena &parallelismArena() const { return m_parallelismArena.empty() ? m_base.parallelismArena() : m_parallelismArena; }
+    void setParallelismArena(const ParallelismArena &arena) { m_parallelismArena = arena; }
+
     virtual ~LinkageOptimization() = default;
 
 protected:
@@ -173,6 +205,17 @@ protected:
     // Update the adjoint state vectors "w" and "y"
     virtual bool m_updateAdjointState(const Eigen::Ref<const Eigen::VectorXd> &params, const OptEnergyType opt_eType=OptEnergyType::Full) = 0;
 
+    // Refresh an autodiff copy of `linkage`. Unless a rebuild is requested or
+    // the topology differs (e.g., `diff_linkage` is still empty or `linkage`
+    // was renumbered), only the state changing between design iterates is
+    // transferred with `updateState` instead of reconstructing the linkage
+    // with `set`.
+    template<class ADObject>
+    static void m_refreshAutodiffLinkage(ADObject &diff_linkage, const Object<Real> &linkage, bool rebuild) {
+        if (rebuild || !diff_linkage.hasSameTopology(linkage)) diff_linkage.set(linkage);
+        else                          diff_linkage.updateState(linkage);
+    }
+
     
     ////////////////////////////////////////////////////////////////////////////
     // Private member variables
@@ -188,8 +231,10 @@ protected:
     Object<Real> &m_base;
     Object<Real> m_linesearch_base;
 
-    bool m_adjointStateIsCurrent = false, m_autodiffLinkagesAreCurrent = false;
+    bool m_adjointStateIsCurrent = false, m_autodiffLinkagesAreCurrent = false, m_autodiffLinkagesNeedRebuild = false;
     bool m_equilibriumSolveSuccessful = false;
+    std::atomic<bool> m_terminationRequested{false};
+    ParallelismArena m_parallelismArena;
 
 };
 
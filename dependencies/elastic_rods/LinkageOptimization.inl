@@ -1,3 +1,73 @@
+#include "bound_constrained_optimizer.hh"
+
+template<template<typename> class Object>
+void LinkageOptimization<Object>::getDesignParameterBounds(Real minRestLen, Eigen::VectorXd &lb, Eigen::VectorXd &ub) {
+    if (minRestLen < 0) minRestLen = defaultLengthBound();
+    const Real inf = std::numeric_limits<Real>::infinity();
+
+    const size_t nk = use_restKappa() ? numRestKappaVars() : 0,
+                 nl = use_restLen()   ? numRestLen()       : 0,
+                 na = getOptimizeTargetAngle() ? 1 : 0;
+    if (nk + nl + na != numFullParams()) throw std::runtime_error("Unexpected design parameter layout");
+
+    lb.resize(nk + nl + na);
+    ub.resize(nk + nl + na);
+    lb.segment(0, nk).setConstant(-2 * M_PI);
+    ub.segment(0, nk).setConstant( 2 * M_PI);
+    lb.segment(nk, nl).setConstant(minRestLen);
+    ub.segment(nk, nl).setConstant(inf);
+    lb.segment(nk + nl, na).setConstant(-2 * M_PI);
+    ub.segment(nk + nl, na).setConstant( 2 * M_PI);
+}
+
+// Adapts a LinkageOptimization to the problem interface expected by the
+// native solvers in bound_constrained_optimizer.hh.
+template<template<typename> class Object>
+struct LinkageOptimizationNativeProblem {
+    LinkageOptimizationNativeProblem(LinkageOptimization<Object> &lopt) : m_lopt(lopt) { }
+
+    size_t numVars() const { return m_lopt.numFullParams(); }
+    Real            eval      (const Eigen::VectorXd &params) { return m_lopt.J(params); }
+    Eigen::VectorXd grad      (const Eigen::VectorXd &params) { return m_lopt.gradp_J(params); }
+    Eigen::VectorXd apply_hess(const Eigen::VectorXd &params, const Eigen::VectorXd &delta_p) { return m_lopt.apply_hess(params, delta_p, /* coeff_J */ 1.0); }
+    void            newPt     (const Eigen::VectorXd &params) { m_lopt.newPt(params); }
+
+private:
+    LinkageOptimization<Object> &m_lopt;
+};
+
+template<template<typename> class Object>
+int optimizeNative(LinkageOptimization<Object> &lopt, OptAlgorithm alg, size_t num_steps,
+              Real trust_region_scale, Real optimality_tol, std::function<void()> &update_viewer, double minRestLen, bool
+              applyAngleConstraint, bool applyFlatnessConstraint) {
+    if (applyAngleConstraint || applyFlatnessConstraint)
+        throw std::runtime_error("The native design optimizers do not support the angle/flatness constraints");
+
+    Eigen::VectorXd lb, ub;
+    lopt.getDesignParameterBounds(minRestLen, lb, ub);
+    Eigen::VectorXd x = lopt.getFullDesignParameters();
+
+    BoundConstrainedOptimizerOptions opts;
+    opts.niter = num_steps;
+    opts.gradTol = optimality_tol;
+    // Like Knitro's "delta" parameter, trust_region_scale scales the initial trust region radius.
+    opts.trustRegionRadius = trust_region_scale * std::max<Real>(1.0, x.norm());
+
+    LinkageOptimizationNativeProblem<Object> problem(lopt);
+    auto callback = [&](size_t) { update_viewer(); return lopt.terminationRequested(); };
+
+    BENCHMARK_RESET();
+    BoundConstrainedStatus status;
+    if      (alg == OptAlgorithm::NATIVE_NEWTON_CG) status = trust_region_newton_cg_optimize(problem, x, lb, ub, opts, callback);
+    else if (alg == OptAlgorithm::NATIVE_LBFGSB)    status = lbfgsb_optimize                (problem, x, lb, ub, opts, callback);
+    else throw std::runtime_error("Unknown algorithm");
+    BENCHMARK_REPORT_NO_MESSAGES();
+
+    if (status != BoundConstrainedStatus::CONVERGED)
+        std::cout << "Native design optimizer did not converge, final status = " << int(status) << std::endl;
+    return int(status);
+}
+
 #if HAS_KNITRO
 #include "knitro.hh"
 
@@ -15,11 +85,6 @@ struct OptKnitroProblem : public KnitroProblem<OptKnitroProblem<Object>> {
         this->setObjType(KPREFIX(OBJTYPE_GENERAL));
         this->setObjType(KPREFIX(OBJGOAL_MINIMIZE));
 
-        // Set the bounds for the design parameters:
-        //     Rest length parameters are between epsilon and infinity
-        //     Rest curvature parameters are between -2*pi and 2*pi
-        //     Target average opening angle are between -2*pi and 2*pi
-        if (minRestLen < 0) minRestLen = m_lopt.defaultLengthBound();
 #if KNITRO_LEGACY
         if (m_applyAngleConstraint) {
             this->setConTypes (angleConstraintIdx(), KPREFIX(CONTYPE_GENERAL));
@@ -37,31 +102,13 @@ struct OptKnitroProblem : public KnitroProblem<OptKnitroProblem<Object>> {
         throw std::runtime_error("TODO: port nonlinear constraints to the new Knitro API");
 #endif
         
-        if (minRestLen < 0) minRestLen = m_lopt.defaultLengthBound();
-        std::vector<double> restLenLoBounds(m_lopt.numRestLen(), minRestLen);
-        std::vector<double> restLenUpBounds(m_lopt.numRestLen(), KPREFIX(INFBOUND));
-
-        std::vector<double> restKappaLoBounds(m_lopt.numRestKappaVars(), -2 * M_PI);
-        std::vector<double> restKappaUpBounds(m_lopt.numRestKappaVars(),  2 * M_PI);
-
-        std::vector<double> alphaLoBounds(1, -2 * M_PI);
-        std::vector<double> alphaUpBounds(1,  2 * M_PI);
-
-        std::vector<double> loBounds;
-        std::vector<double> upBounds;
-        if (lopt.use_restKappa()) {
-            loBounds.insert(loBounds.end(), restKappaLoBounds.begin(), restKappaLoBounds.end());
-            upBounds.insert(upBounds.end(), restKappaUpBounds.begin(), restKappaUpBounds.end());
-        }
-
-        if (lopt.use_restLen()) {
-            loBounds.insert(loBounds.end(), restLenLoBounds.begin(), restLenLoBounds.end());
-            upBounds.insert(upBounds.end(), restLenUpBounds.begin(), restLenUpBounds.end());
-        }
-
-        if (m_optimizeTargetAngle) {
-            loBounds.insert(loBounds.end(), alphaLoBounds.begin(), alphaLoBounds.end());
-            upBounds.insert(upBounds.end(), alphaUpBounds.begin(), alphaUpBounds.end());
+        // Set the bounds for the design parameters (see LinkageOptimization::getDesignParameterBounds)
+        Eigen::VectorXd lb, ub;
+        m_lopt.getDesignParameterBounds(minRestLen, lb, ub);
+        std::vector<double> loBounds(lb.size()), upBounds(ub.size());
+        for (int i = 0; i < lb.size(); ++i) {
+            loBounds[i] = std::max<double>(lb[i], -KPREFIX(INFBOUND));
+            upBounds[i] = std::min<double>(ub[i],  KPREFIX(INFBOUND));
         }
 
         this->setVarLoBnds(loBounds);
@@ -144,7 +191,7 @@ struct OptKnitroNewPtCallback : public NewPtCallbackBase {
         m_lopt.newPt(Eigen::Map<const Eigen::VectorXd>(x, nfp));
         std::cout << "Done evaluating new point." << std::endl;
         m_update_viewer();
-        return 0;
+        return m_lopt.terminationRequested() ? KPREFIX(RC_USER_TERMINATION) : 0;
     }
 private:
     std::function<void()> m_update_viewer;
@@ -175,17 +222,17 @@ void configureKnitroSolver(KnitroSolver &solver, int num_steps, Real trust_regio
 }
 
 template<template<typename> class Object>
-int LinkageOptimization<Object>::optimize(OptAlgorithm alg, size_t num_steps,
+int optimizeKnitro(LinkageOptimization<Object> &lopt, OptAlgorithm alg, size_t num_steps,
               Real trust_region_scale, Real optimality_tol, std::function<void()> &update_viewer, double minRestLen, bool
               applyAngleConstraint, bool applyFlatnessConstraint) {
-    OptKnitroProblem<Object> problem(*this, applyAngleConstraint, applyFlatnessConstraint, minRestLen);
+    OptKnitroProblem<Object> problem(lopt, applyAngleConstraint, applyFlatnessConstraint, minRestLen);
 
-    const size_t np = numParams(), nfp = numFullParams();
+    const size_t nfp = lopt.numFullParams();
     std::vector<Real> x_init(nfp);
-    Eigen::Map<Eigen::VectorXd>(x_init.data(), x_init.size()) = getFullDesignParameters();
+    Eigen::Map<Eigen::VectorXd>(x_init.data(), x_init.size()) = lopt.getFullDesignParameters();
     problem.setXInitial(x_init);
 
-    OptKnitroNewPtCallback<Object> callback(*this, update_viewer);
+    OptKnitroNewPtCallback<Object> callback(lopt, update_viewer);
     problem.setNewPointCallback(&callback);
     // Create a solver - optional arguments:
     // exact first and second derivatives; no KPREFIX(GRADOPT_)* or KPREFIX(HESSOPT_)* parameter is needed.
@@ -201,7 +248,7 @@ int LinkageOptimization<Object>::optimize(OptAlgorithm alg, size_t num_steps,
     try {
         BENCHMARK_RESET();
         std::cout << "Starting..." << std::endl;
-        int solveStatus = solver.solve();
+        solveStatus = solver.solve();
         BENCHMARK_REPORT_NO_MESSAGES();
 
         if (solveStatus != 0) {
@@ -220,4 +267,34 @@ int LinkageOptimization<Object>::optimize(OptAlgorithm alg, size_t num_steps,
     return solveStatus;
 }
 
+#endif // HAS_KNITRO
+
+template<template<typename> class Object>
+int LinkageOptimization<Object>::optimize(OptAlgorithm alg, size_t num_steps,
+              Real trust_region_scale, Real optimality_tol, std::function<void()> &update_viewer, double minRestLen, bool
+              applyAngleConstraint, bool applyFlatnessConstraint) {
+    // Termination requests are cleared when the run ends (also by an
+    // exception) rather than when it starts, so that a request made before
+    // the call (e.g., while reporting the initial design) is honored.
+    struct ClearTerminationRequest {
+        ~ClearTerminationRequest() { flag = false; }
+        std::atomic<bool> &flag;
+    } clearTerminationRequest{m_terminationRequested};
+
+    int status = 0;
+    parallelismArena().execute([&]() {
+        if ((alg == OptAlgorithm::NEWTON_CG) || (alg == OptAlgorithm::BFGS)) {
+#if HAS_KNITRO
+            if (terminationRequested()) { status = KPREFIX(RC_USER_TERMINATION); return; }
+            status = optimizeKnitro(*this, alg, num_steps, trust_region_scale, optimality_tol, update_viewer, minRestLen, applyAngleConstraint, applyFlatnessConstraint);
+            return;
+#else
+            std::cout << "Knitro is unavailable; using the native " << ((alg == OptAlgorithm::NEWTON_CG) ? "trust-region Newton-CG" : "L-BFGS-B") << " solver" << std::endl;
+            alg = (alg == OptAlgorithm::NEWTON_CG) ? OptAlgorithm::NATIVE_NEWTON_CG : OptAlgorithm::NATIVE_LBFGSB;
 #endif
+        }
+        if (terminationRequested()) { status = int(BoundConstrainedStatus::USER_TERMINATION); return; }
+        status = optimizeNative(*this, alg, num_steps, trust_region_scale, optimality_tol, update_viewer, minRestLen, applyAngleConstraint, applyFlatnessConstraint);
+    });
+    return status;
+}
@@ -95,6 +95,9 @@ struct PeriodicRod_T {
     template<typename Real2>
     PeriodicRod_T(const PeriodicRod_T<Real2> &pr) : rod(pr.rod) { }
 
+    // Construct from an already periodic rod and its twist (e.g., when deserializing).
+    PeriodicRod_T(const Rod &r, Real_ twist) : rod(r), m_twist(twist) { }
+
     // Set a homogeneous material for the rod
     void setMaterial(const RodMaterial &mat) {
         rod.setMaterial(mat);
@@ -4,6 +4,7 @@
 #include <map>
 #include <algorithm>
 #include <iterator>
+#include <numeric>
 #include <MeshFEM/MeshIO.hh>
 #include <MeshFEM/GlobalBenchmark.hh>
 #include <MeshFEM/MSHFieldWriter.hh>
@@ -29,10 +30,18 @@ void RodLinkage_T<Real_>::read(const std::string &path, size_t subdivision, bool
     set(vertices, elements, subdivision, initConsistentAngle, rod_interleaving_type, edge_callbacks, input_joint_normals);
 }
 
+template<typename Real_>
+void RodLinkage_T<Real_>::read(const std::string &path, const std::vector<size_t> &segmentSubdivisions, bool initConsistentAngle, InterleavingType rod_interleaving_type, std::vector<std::function<Pt3_T<Real_>(Real_, bool)>> edge_callbacks, std::vector<Vec3> input_joint_normals) {
+    std::vector<MeshIO::IOVertex > vertices;
+    std::vector<MeshIO::IOElement> elements;
+    MeshIO::load(path, vertices, elements);
+    set(vertices, elements, segmentSubdivisions, initConsistentAngle, rod_interleaving_type, edge_callbacks, input_joint_normals);
+}
+
 template<typename Real_>
 void RodLinkage_T<Real_>::set(std::vector<MeshIO::IOVertex > vertices, // copy edited inside
                               std::vector<MeshIO::IOElement> edges,    // copy edited inside
-                              size_t subdivision,
+                              const std::vector<size_t> &segmentSubdivisions,
                               bool initConsistentAngle, 
                               InterleavingType rod_interleaving_type, 
                               std::vector<std::function<Pt3_T<Real_>(Real_, bool)>> edge_callbacks, 
@@ -46,8 +55,16 @@ void RodLinkage_T<Real_>::set(std::vector<MeshIO::IOVertex > vertices, // copy e
 
     const size_t nv = vertices.size(),
                  ne = edges.size();
+    if (segmentSubdivisions.size() != ne) throw std::runtime_error("Invalid number of segment subdivisions; there should be one per edge");
+    if (ne == 0) throw std::runtime_error("Linkage must have at least one edge");
+    for (size_t subdivision : segmentSubdivisions) {
+        if (subdivision < 7)
+            throw std::runtime_error("Rods in a linkage must have at least 5 edges (to prevent conflicting start/end joint constraints and fully separate joint influences in Hessian)");
+    }
     m_segments.clear();
     m_joints.clear();
+    m_originalSegmentIndex.clear();
+    m_originalJointIndex.clear();
     m_segments.reserve(edges.size());
     m_joints.reserve(vertices.size());
     std::vector<size_t> valence(nv);
@@ -77,10 +94,11 @@ void RodLinkage_T<Real_>::set(std::vector<MeshIO::IOVertex > vertices, // copy e
     temp_segments.reserve(edges.size());
     temp_joints.reserve(vertices.size());
     // Generate a rod segment for each edge.
-    for (const auto &e : edges) {
+    for (size_t ei = 0; ei < ne; ++ei) {
+        const auto &e = edges[ei];
         temp_segments.emplace_back(vertices[e[0]].point,
                                 vertices[e[1]].point,
-                                subdivision);
+                                segmentSubdivisions[ei]);
     }
 
     // Generate joints at the valence 2, 3, and 4 vertices.
@@ -209,15 +227,16 @@ void RodLinkage_T<Real_>::set(std::vector<MeshIO::IOVertex > vertices, // copy e
         // length of the neighboring edges, so rod segments' rest lengths
         // will need to be recomputed.
         Vec3 edgeA = -edgeVecs.col(segmentsA[0]), edgeB = -edgeVecs.col(segmentsB[0]); // get vector pointing out of segment 0
-        Real_ segmentFracLen = 1.0 / (subdivision - 1); // only (subdivision - 1) segment lengths fit between the endpoints; rod extends half a segment past each endpoint.
-        Real_ lenA  = edgeVecLens[segmentsA[0]] * segmentFracLen,
-              lenB  = edgeVecLens[segmentsB[0]] * segmentFracLen;
+        // only (subdivision - 1) segment lengths fit between the endpoints; rod extends half a segment past each endpoint.
+        auto segmentFracLen = [&](size_t k) { return Real_(1.0 / (segmentSubdivisions[incidentEdges[vi][k]] - 1)); };
+        Real_ lenA  = edgeVecLens[segmentsA[0]] * segmentFracLen(segmentsA[0]),
+              lenB  = edgeVecLens[segmentsB[0]] * segmentFracLen(segmentsB[0]);
         if (numA == 2) {
-            lenA  = std::min<Real_>(lenA, edgeVecLens[segmentsA[1]] * segmentFracLen);
+            lenA  = std::min<Real_>(lenA, edgeVecLens[segmentsA[1]] * segmentFracLen(segmentsA[1]));
             edgeA += edgeVecs.col(segmentsA[1]);
         }
         if (numB == 2) {
-            lenB  = std::min<Real_>(lenB, edgeVecLens[segmentsB[1]] * segmentFracLen);
+            lenB  = std::min<Real_>(lenB, edgeVecLens[segmentsB[1]] * segmentFracLen(segmentsB[1]));
             edgeB += edgeVecs.col(segmentsB[1]);
         }
         edgeA *= lenA / edgeA.norm();
@@ -256,8 +275,6 @@ void RodLinkage_T<Real_>::set(std::vector<MeshIO::IOVertex > vertices, // copy e
 
     // Initial guess for the length of each segment: straight line distance
     VecX segmentRestLenGuess(ne);
-    if (subdivision < 7)
-        throw std::runtime_error("Rods in a linkage must have at least 5 edges (to prevent conflicting start/end joint constraints and fully separate joint influences in Hessian)");
     for (size_t ei = 0; ei < ne; ++ei) {
         std::function<Pt3_T<Real_>(Real_)> edge_callback = {};
         const auto &e = edges[ei];
@@ -333,15 +350,16 @@ void RodLinkage_T<Real_>::set(std::vector<MeshIO::IOVertex > vertices, // copy e
         // length of the neighboring edges, so rod segments' rest lengths
         // will need to be recomputed.
         Vec3 edgeA = -edgeVecs[segmentsA[0]], edgeB = -edgeVecs[segmentsB[0]]; // get vector pointing out of segment 0
-        Real_ segmentFracLen = 1.0 / (subdivision - 1); // only (subdivision - 1) segment lengths fit between the endpoints; rod extends half a segment past each endpoint.
-        Real_ lenA  = edgeVecLens[segmentsA[0]] * segmentFracLen,
-              lenB  = edgeVecLens[segmentsB[0]] * segmentFracLen;
+        // only (subdivision - 1) segment lengths fit between the endpoints; rod extends half a segment past each endpoint.
+        auto segmentFracLen = [&](size_t k) { return Real_(1.0 / (segmentSubdivisions[incidentEdges[vi][k]] - 1)); };
+        Real_ lenA  = edgeVecLens[segmentsA[0]] * segmentFracLen(segmentsA[0]),
+              lenB  = edgeVecLens[segmentsB[0]] * segmentFracLen(segmentsB[0]);
         if (numA == 2) {
-            lenA  = std::min<Real_>(lenA, edgeVecLens[segmentsA[1]] * segmentFracLen);
+            lenA  = std::min<Real_>(lenA, edgeVecLens[segmentsA[1]] * segmentFracLen(segmentsA[1]));
             edgeA += edgeVecs[segmentsA[1]];
         }
         if (numB == 2) {
-            lenB  = std::min<Real_>(lenB, edgeVecLens[segmentsB[1]] * segmentFracLen);
+            lenB  = std::min<Real_>(lenB, edgeVecLens[segmentsB[1]] * segmentFracLen(segmentsB[1]));
             edgeB += edgeVecs[segmentsB[1]];
         }
         edgeA *= lenA / edgeA.norm();
@@ -373,12 +391,12 @@ void RodLinkage_T<Real_>::set(std::vector<MeshIO::IOVertex > vertices, // copy e
         if (!use_edge_cb) {
             m_segments.emplace_back(vertices[e[1 - int(m_rod_orientation_indicator[si])]].point,
                                 vertices[e[int(m_rod_orientation_indicator[si])]].point,
-                                subdivision);
+                                segmentSubdivisions[si]);
         } else {
             edge_callback = std::bind(edge_callbacks[si], std::placeholders::_1, m_rod_orientation_indicator[si]);
             // Specify the start and end edge length using the joints if they exists;
             // otherwise use the current segment's rest length to compute the edge length. 
-            Real_ start_len = segmentRestLenGuess[si] / (subdivision - 1) / 2.0;
+            Real_ start_len = segmentRestLenGuess[si] / (segmentSubdivisions[si] - 1) / 2.0;
             Real_ end_len = start_len;
             if (temp_segments.at(si).startJoint != NONE) {
                 auto startJoint = m_joints.at(temp_segments.at(si).startJoint);
@@ -388,7 +406,7 @@ void RodLinkage_T<Real_>::set(std::vector<MeshIO::IOVertex > vertices, // copy e
                 auto endJoint = m_joints.at(temp_segments.at(si).endJoint);
                 end_len = endJoint.segmentABOffset(si) == 0 ? endJoint.len_A() / 2.0 : endJoint.len_B() / 2.0;
             }
-            m_segments.emplace_back(subdivision, edge_callback, start_len, end_len);
+            m_segments.emplace_back(segmentSubdivisions[si], edge_callback, start_len, end_len);
         }
     }
 
@@ -650,6 +668,8 @@ void RodLinkage_T<Real_>::set(std::vector<MeshIO::IOVertex > vertices,
                  ne = edges.size();
     m_segments.clear();
     m_joints.clear();
+    m_originalSegmentIndex.clear();
+    m_originalJointIndex.clear();
     m_segments.reserve(edges.size());
     m_joints.reserve(vertices.size());
     std::vector<size_t> valence(nv);
@@ -1356,6 +1376,217 @@ void RodLinkage_T<Real_>::m_buildDoFOffsets() {
     }
 }
 
+template<typename Real_>
+void RodLinkage_T<Real_>::reorderForLocality() {
+    const size_t nj = numJoints(), ns = numSegments();
+    if (nj == 0) return;
+
+    // Joint adjacency graph: two joints are adjacent if a segment connects them.
+    std::vector<std::vector<size_t>> adj(nj);
+    for (const auto &s : m_segments) {
+        if (!s.hasStartJoint() || !s.hasEndJoint() || (s.startJoint == s.endJoint)) continue;
+        adj[s.startJoint].push_back(s.endJoint);
+        adj[s.endJoint  ].push_back(s.startJoint);
+    }
+    for (auto &a : adj) {
+        std::sort(a.begin(), a.end());
+        a.erase(std::unique(a.begin(), a.end()), a.end());
+    }
+    auto lessDegree = [&](size_t a, size_t b) { return adj[a].size() < adj[b].size(); };
+
+    // Breadth-first distances from `root`; returns the root's connected
+    // component in BFS order (the last entry is at maximal distance).
+    std::vector<size_t> dist(nj, NONE);
+    auto distances = [&](size_t root) {
+        std::vector<size_t> visited{root};
+        dist[root] = 0;
+        for (size_t i = 0; i < visited.size(); ++i) {
+            const size_t u = visited[i];
+            for (size_t v : adj[u]) {
+                if (dist[v] != NONE) continue;
+                dist[v] = dist[u] + 1;
+                visited.push_back(v);
+            }
+        }
+        return visited;
+    };
+
+    // Cuthill-McKee ordering of each connected component, started from a
+    // pseudo-peripheral joint (George-Liu: repeatedly jump to a minimum-degree
+    // joint of the last BFS level while the eccentricity increases).
+    std::vector<size_t> byDegree(nj);
+    std::iota(byDegree.begin(), byDegree.end(), 0);
+    std::stable_sort(byDegree.begin(), byDegree.end(), lessDegree);
+
+    std::vector<size_t> jointOrder;
+    jointOrder.reserve(nj);
+    std::vector<bool> numbered(nj, false);
+    for (size_t start : byDegree) {
+        if (numbered[start]) continue;
+        size_t root = start;
+        std::vector<size_t> component = distances(root);
+        size_t eccentricity = dist[component.back()];
+        while (true) {
+            size_t candidate = component.back();
+            for (size_t u : component)
+                if ((dist[u] == eccentricity) && lessDegree(u, candidate)) candidate = u;
+            for (size_t u : component) dist[u] = NONE;
+            std::vector<size_t> candidateComponent = distances(candidate);
+            const size_t e = dist[candidateComponent.back()];
+            if (e <= eccentricity) {
+                for (size_t u : candidateComponent) dist[u] = NONE;
+                break;
+            }
+            root = candidate;
+            eccentricity = e;
+            component = std::move(candidateComponent);
+        }
+
+        const size_t begin = jointOrder.size();
+        jointOrder.push_back(root);
+        numbered[root] = true;
+        for (size_t i = begin; i < jointOrder.size(); ++i) {
+            const size_t end = jointOrder.size();
+            for (size_t v : adj[jointOrder[i]]) {
+                if (numbered[v]) continue;
+                numbered[v] = true;
+                jointOrder.push_back(v);
+            }
+            std::stable_sort(jointOrder.begin() + end, jointOrder.end(), lessDegree);
+        }
+    }
+    std::reverse(jointOrder.begin(), jointOrder.end()); // reverse Cuthill-McKee
+
+    std::vector<size_t> newJointIndex(nj);
+    for (size_t ji = 0; ji < nj; ++ji) newJointIndex[jointOrder[ji]] = ji;
+    auto remapJoint = [&](size_t ji) { return (ji == NONE) ? NONE : newJointIndex[ji]; };
+
+    // Segments follow their lowest-numbered joint (ties broken by the other
+    // joint), so each joint's incident segments are numbered next to it.
+    std::vector<std::pair<size_t, size_t>> segmentKey(ns);
+    for (size_t si = 0; si < ns; ++si) {
+        const size_t a = remapJoint(m_segments[si].startJoint),
+                     b = remapJoint(m_segments[si].endJoint);
+        segmentKey[si] = std::make_pair(std::min(a, b), std::max(a, b));
+    }
+    std::vector<size_t> segmentOrder(ns);
+    std::iota(segmentOrder.begin(), segmentOrder.end(), 0);
+    std::stable_sort(segmentOrder.begin(), segmentOrder.end(), [&](size_t a, size_t b) { return segmentKey[a] < segmentKey[b]; });
+
+    m_permute(jointOrder, segmentOrder);
+}
+
+template<typename Real_>
+void RodLinkage_T<Real_>::restoreOriginalOrder() {
+    if (m_originalSegmentIndex.empty() && m_originalJointIndex.empty()) return;
+    const size_t nj = numJoints(), ns = numSegments();
+    std::vector<size_t> jointOrder(nj), segmentOrder(ns);
+    for (size_t ji = 0; ji < nj; ++ji) jointOrder  .at(originalJointIndex  (ji)) = ji;
+    for (size_t si = 0; si < ns; ++si) segmentOrder.at(originalSegmentIndex(si)) = si;
+    m_permute(jointOrder, segmentOrder);
+    m_originalSegmentIndex.clear();
+    m_originalJointIndex.clear();
+}
+
+// Renumber the joints and segments so that new joint `ji` is old joint
+// `jointOrder[ji]` (and likewise for the segments), permuting all per-joint
+// and per-segment data.
+template<typename Real_>
+void RodLinkage_T<Real_>::m_permute(const std::vector<size_t> &jointOrder, const std::vector<size_t> &segmentOrder) {
+    const size_t nj = numJoints(), ns = numSegments();
+    if ((jointOrder.size() != nj) || (segmentOrder.size() != ns)) throw std::runtime_error("Invalid permutation size");
+    std::vector<size_t> newJointIndex(nj, NONE);
+    for (size_t ji = 0; ji < nj; ++ji) newJointIndex.at(jointOrder[ji]) = ji;
+    auto remapJoint = [&](size_t ji) { return (ji == NONE) ? NONE : newJointIndex[ji]; };
+
+    std::vector<size_t> newSegmentIndex(ns, NONE);
+    for (size_t si = 0; si < ns; ++si) newSegmentIndex.at(segmentOrder[si]) = si;
+    if ((std::find(newJointIndex.begin(), newJointIndex.end(), NONE) != newJointIndex.end()) ||
+        (std::find(newSegmentIndex.begin(), newSegmentIndex.end(), NONE) != newSegmentIndex.end()))
+        throw std::runtime_error("Invalid permutation");
+
+    // Permute the segment rest length -> edge rest length map (transposed).
+    // Its rows are segments, and its columns are the free edges of each
+    // segment (in segment order) followed by the two joint edges of each joint.
+    {
+        const auto &oldMap = m_segmentRestLenToEdgeRestLenMapTranspose;
+        std::vector<size_t> firstColumnForSegment(ns + 1, 0);
+        for (size_t si = 0; si < ns; ++si) firstColumnForSegment[si + 1] = firstColumnForSegment[si] + m_segments[si].numFreeEdges();
+        const size_t firstJointColumn = firstColumnForSegment[ns];
+        if (size_t(oldMap.n) != firstJointColumn + 2 * nj) throw std::logic_error("Unexpected segmentRestLenToEdgeRestLenMapTranspose size");
+
+        SuiteSparseMatrix result(oldMap.m, oldMap.n);
+        result.nz = oldMap.nz;
+        result.Ap.reserve(oldMap.n + 1);
+        result.Ai.reserve(oldMap.nz);
+        result.Ax.reserve(oldMap.nz);
+        result.Ap.push_back(0);
+        std::vector<std::pair<SuiteSparse_long, double>> column;
+        auto copyColumn = [&](size_t j) {
+            column.clear();
+            for (auto idx = oldMap.Ap[j]; idx < oldMap.Ap[j + 1]; ++idx)
+                column.emplace_back(newSegmentIndex.at(oldMap.Ai[idx]), oldMap.Ax[idx]);
+            std::sort(column.begin(), column.end());
+            for (const auto &entry : column) {
+                result.Ai.push_back(entry.first);
+                result.Ax.push_back(entry.second);
+            }
+            result.Ap.push_back(result.Ai.size());
+        };
+        for (size_t si : segmentOrder) {
+            for (size_t j = firstColumnForSegment[si]; j < firstColumnForSegment[si + 1]; ++j)
+                copyColumn(j);
+        }
+        for (size_t ji : jointOrder) {
+            copyColumn(firstJointColumn + 2 * ji + 0);
+            copyColumn(firstJointColumn + 2 * ji + 1);
+        }
+        m_segmentRestLenToEdgeRestLenMapTranspose = std::move(result);
+    }
+
+    {
+        std::vector<RodSegment> segments;
+        segments.reserve(ns);
+        for (size_t si : segmentOrder)
+            segments.emplace_back(remapJoint(m_segments[si].startJoint), remapJoint(m_segments[si].endJoint), std::move(m_segments[si].rod));
+        m_segments = std::move(segments);
+    }
+    {
+        std::vector<Joint> joints;
+        joints.reserve(nj);
+        for (size_t ji : jointOrder) {
+            joints.emplace_back(std::move(m_joints[ji]));
+            joints.back().remapSegmentIndices(newSegmentIndex);
+        }
+        m_joints = std::move(joints);
+        for (auto &j : m_joints) j.updateLinkagePointer(this);
+    }
+
+    VecX perSegmentRestLen(ns);
+    for (size_t si = 0; si < ns; ++si) perSegmentRestLen[si] = m_perSegmentRestLen[segmentOrder[si]];
+    m_perSegmentRestLen = perSegmentRestLen;
+
+    if (m_rod_orientation_indicator.size() == ns) {
+        std::vector<bool> indicator(ns);
+        for (size_t si = 0; si < ns; ++si) indicator[si] = m_rod_orientation_indicator[segmentOrder[si]];
+        m_rod_orientation_indicator = std::move(indicator);
+    }
+
+    // Compose with any previous renumbering.
+    std::vector<size_t> originalSegmentIndex(ns), originalJointIndex(nj);
+    for (size_t si = 0; si < ns; ++si) originalSegmentIndex[si] = this->originalSegmentIndex(segmentOrder[si]);
+    for (size_t ji = 0; ji < nj; ++ji) originalJointIndex  [ji] = this->originalJointIndex  (jointOrder  [ji]);
+    m_originalSegmentIndex = std::move(originalSegmentIndex);
+    m_originalJointIndex   = std::move(originalJointIndex);
+
+    m_networkPoints.clear();
+    m_networkThetas.clear();
+
+    // Rebuild the design parameter cache (rest kappas are stored in segment
+    // order) and the DoF offsets; this also clears the topology caches.
+    setDesignParameterConfig(m_linkage_dPC.restLen, m_linkage_dPC.restKappa);
+}
+
 // Construct the *transpose* of the map from a vector holding the (rest) lengths
 // of each segment to a vector holding a (rest) length for every rod length in the
 // entire network. The vector output by this map is ordered as follows: all
@@ -1585,7 +1816,7 @@ VecX_T<Real_> RodLinkage_T<Real_>::getDoFs() const {
 // joint parameters; see joint.applyConfiguration.
 template<typename Real_>
 void RodLinkage_T<Real_>::setDoFs(const Eigen::Ref<const VecX> &params, bool spatialCoherence, bool initializeOffset) {
-    BENCHMARK_SCOPED_TIMER_SECTION timer(mangledName() + ".setDoFs");
+    PROFILE_SCOPE(mangledName() + ".setDoFs");
     const size_t n = numDoF();
     if (size_t(params.size()) != n) throw std::runtime_error("Invalid number of parameters");
 
@@ -2240,7 +2471,7 @@ Eigen::MatrixXd RodLinkage_T<Real_>::rivetNetForceAndTorques(EnergyType eType) c
 
 template<typename Real_>
 VecX_T<Real_> RodLinkage_T<Real_>::gradient(bool updatedSource, EnergyType eType, bool variableDesignParameters, bool designParameterOnly, const bool skipBRods) const {
-    BENCHMARK_SCOPED_TIMER_SECTION timer(mangledName() + ".gradient");
+    PROFILE_SCOPE(mangledName() + ".gradient");
     VecX g(variableDesignParameters ? numExtendedDoF() : numDoF());
     g.setZero();
 
@@ -2368,7 +2599,8 @@ using dv_dr_type = std::vector<std::vector<dv_dr_entry<Real_>>>;
 
 // For correct autodiff code, we must still keep zero entries if they have nonzero derivatives!
 bool entryIdenticallyZero(double val) { return val == 0; }
-bool entryIdenticallyZero(ADReal val) { return (val == 0) && (val.derivatives().squaredNorm() == 0); }
+template<typename DerType>
+bool entryIdenticallyZero(const Eigen::AutoDiffScalar<DerType> &val) { return (val == 0) && (val.derivatives().squaredNorm() == 0); }
 
 template<typename Real_, typename LTESPtr>
 void
@@ -2899,7 +3131,7 @@ auto RodLinkage_T<Real_>::hessianPerSegmentRestlenSparsityPattern(Real_ val) con
 template<typename Real_>
 void RodLinkage_T<Real_>::hessianPerSegmentRestlen(CSCMat &H, EnergyType eType) const {
     assert(H.symmetry_mode == CSCMat::SymmetryMode::UPPER_TRIANGLE);
-    BENCHMARK_SCOPED_TIMER_SECTION timer("hessianPerSegmentRestlen");
+    PROFILE_SCOPE("hessianPerSegmentRestlen");
     const size_t restLenOffset = numDoF() + m_linkage_dPC.restKappa * numRestKappaVars();
     const size_t ndof = restLenOffset + numSegments() * m_linkage_dPC.restLen;
     assert((size_t(H.m) == ndof) && (size_t(H.n) == ndof));
@@ -2968,13 +3200,20 @@ auto RodLinkage_T<Real_>::hessianPerSegmentRestlen(EnergyType eType) const -> TM
     return H.getTripletMatrix();
 }
 
+template<typename Real_>
+auto RodLinkage_T<Real_>::traceRods() const -> const RodTrace & {
+    std::lock_guard<std::mutex> lock(m_cachedRodTrace.mutex);
+    if (!m_cachedRodTrace.trace) m_cachedRodTrace.trace = std::make_unique<RodTrace>(m_traceRods());
+    return *m_cachedRodTrace.trace;
+}
+
 // Partition the segment indices into list of segments making up each rod (i.e., polylines)
 // Within each rod, segment indices are listed in order. We attempt to pick a
 // consistent direction for all "A" rods and all "B" rods (with A and B oriented oppositely).
 template<typename Real_>
-std::vector<std::tuple<bool, std::vector<size_t>>> RodLinkage_T<Real_>::traceRods() const {
+auto RodLinkage_T<Real_>::m_traceRods() const -> RodTrace {
     // Could be optimized...
-    std::vector<std::tuple<bool, std::vector<size_t>>> result;
+    RodTrace result;
 
     size_t numVisited = 0;
     const size_t ns = numSegments();
@@ -3166,7 +3405,7 @@ std::tuple<std::vector<std::vector<size_t>>,
            std::vector<std::vector<double>>,
            std::vector<std::vector<double>>>
 RodLinkage_T<Real_>::rodStresses() const {
-    std::vector<std::tuple<bool, std::vector<size_t>>> rods = traceRods();
+    const RodTrace &rods = traceRods();
     const size_t numRods = rods.size();
 
     // The stress values at distinct points along a rod.
@@ -3259,7 +3498,7 @@ florinVisualizationGeometry(std::vector<std::vector<size_t>> &polylinesA,
                             std::vector<Point3D> &points, std::vector<Vector3D> &normals,
                             std::vector<Real> &stresses) const
 {
-    std::vector<std::tuple<bool, std::vector<size_t>>> rods = traceRods();
+    const RodTrace &rods = traceRods();
     const size_t numRods = rods.size();
 
     polylinesA.clear();
@@ -3352,7 +3591,7 @@ florinVisualizationGeometry(std::vector<std::vector<size_t>> &polylinesA,
 template<typename Real_>
 void RodLinkage_T<Real_>::hessian(CSCMat &H, EnergyType eType, const bool variableDesignParameters) const {
     assert(H.symmetry_mode == CSCMat::SymmetryMode::UPPER_TRIANGLE);
-    BENCHMARK_SCOPED_TIMER_SECTION timer(mangledName() + ".hessian");
+    PROFILE_SCOPE(mangledName() + ".hessian");
 
     const size_t ndof = variableDesignParameters ? numExtendedDoF() : numDoF();
     assert((size_t(H.m) == ndof) && (size_t(H.n) == ndof));
@@ -3548,7 +3787,7 @@ auto RodLinkage_T<Real_>::hessian(EnergyType eType, bool variableDesignParameter
 
 template<typename Real_>
 void RodLinkage_T<Real_>::massMatrix(CSCMat &M, bool updatedSource, bool useLumped) const {
-    BENCHMARK_SCOPED_TIMER_SECTION timer(mangledName() + ".massMatrix");
+    PROFILE_SCOPE(mangledName() + ".massMatrix");
     assert(M.symmetry_mode == CSCMat::SymmetryMode::UPPER_TRIANGLE);
 
     {
@@ -3899,6 +4138,148 @@ void RodLinkage_T<Real_>::coloredVisualizationGeometry(std::vector<MeshIO::IOVer
         s.rod.coloredVisualizationGeometry(vertices, quads, averagedMaterialFrames, averagedCrossSections, height);
 }
 
+template<typename Real_>
+size_t RodLinkage_T<Real_>::numVisualizationVertices() const {
+    size_t result = 0;
+    for (const auto &s : m_segments) result += s.rod.numVisualizationVertices();
+    return result;
+}
+
+template<typename Real_>
+size_t RodLinkage_T<Real_>::numVisualizationQuads() const {
+    size_t result = 0;
+    for (const auto &s : m_segments) result += s.rod.numVisualizationQuads();
+    return result;
+}
+
+template<typename Real_>
+void RodLinkage_T<Real_>::visualizationQuads(std::vector<MeshIO::IOElement> &quads) const {
+    quads.reserve(quads.size() + numVisualizationQuads());
+    size_t offset = 0;
+    for (const auto &s : m_segments) {
+        s.rod.visualizationQuads(quads, offset);
+        offset += s.rod.numVisualizationVertices();
+    }
+}
+
+template<typename Real_>
+template<typename OutReal>
+void RodLinkage_T<Real_>::m_visualizationPositions(OutReal *positions, OutReal *normals,
+                                                   const bool averagedMaterialFrames,
+                                                   const bool averagedCrossSections) const {
+    const size_t ns = m_segments.size();
+    std::vector<size_t> offsets(ns + 1, 0);
+    for (size_t si = 0; si < ns; ++si)
+        offsets[si + 1] = offsets[si] + 3 * m_segments[si].rod.numVisualizationVertices();
+
+    auto processSegment = [&](size_t si) {
+        m_segments[si].rod.visualizationPositions(positions + offsets[si], normals ? normals + offsets[si] : nullptr,
+                                                  averagedMaterialFrames, averagedCrossSections);
+    };
+#if MESHFEM_WITH_TBB
+    parallel_for_range(ns, processSegment);
+#else
+    for (size_t si = 0; si < ns; ++si) processSegment(si);
+#endif
+}
+
+template<typename Real_>
+void RodLinkage_T<Real_>::visualizationPositions(double *positions, double *normals,
+                                                 const bool averagedMaterialFrames,
+                                                 const bool averagedCrossSections) const {
+    m_visualizationPositions(positions, normals, averagedMaterialFrames, averagedCrossSections);
+}
+
+template<typename Real_>
+void RodLinkage_T<Real_>::visualizationPositions(float *positions, float *normals,
+                                                 const bool averagedMaterialFrames,
+                                                 const bool averagedCrossSections) const {
+    m_visualizationPositions(positions, normals, averagedMaterialFrames, averagedCrossSections);
+}
+
+template<typename Real_>
+template<typename OutReal>
+void RodLinkage_T<Real_>::m_stressVisualizationFields(unsigned fieldMask, const StressFieldOutputs_T<OutReal> &out) const {
+    constexpr size_t nf = size_t(StressField::Count);
+    auto requested = [fieldMask](StressField f) { return bool(fieldMask & (1u << unsigned(f))); };
+    for (size_t f = 0; f < nf; ++f) {
+        if (requested(StressField(f)) && (out[f] == nullptr)) throw std::runtime_error("Missing output for requested stress field");
+    }
+
+    const size_t ns = m_segments.size();
+    std::array<std::vector<Eigen::VectorXd>, nf> fields;
+    for (size_t f = 0; f < nf; ++f)
+        if (requested(StressField(f))) fields[f].resize(ns);
+
+    // Evaluate the rod fields; the bending stresses are computed once for both the max and min fields.
+    auto processSegment = [&](size_t si) {
+        const auto &r = m_segments[si].rod;
+        if (requested(StressField::SqrtBendingEnergy)) fields[size_t(StressField::SqrtBendingEnergy)][si] = r.sqrtBendingEnergies();
+        if (requested(StressField::MaxBendingStress) || requested(StressField::MinBendingStress)) {
+            const Eigen::MatrixX2d sigma = r.bendingStresses();
+            if (requested(StressField::MaxBendingStress)) fields[size_t(StressField::MaxBendingStress)][si] = sigma.col(0);
+            if (requested(StressField::MinBendingStress)) fields[size_t(StressField::MinBendingStress)][si] = sigma.col(1);
+        }
+        if (requested(StressField::VonMisesStress))   fields[size_t(StressField::VonMisesStress)  ][si] = r.maxVonMisesStresses();
+        if (requested(StressField::TwistingStress))   fields[size_t(StressField::TwistingStress)  ][si] = r.twistingStresses();
+        if (requested(StressField::StretchingStress)) fields[size_t(StressField::StretchingStress)][si] = r.stretchingStresses();
+    };
+#if MESHFEM_WITH_TBB
+    parallel_for_range(ns, processSegment);
+#else
+    for (size_t si = 0; si < ns; ++si) processSegment(si);
+#endif
+
+    for (size_t f = 0; f < nf; ++f) {
+        if (requested(StressField(f)) && (StressField(f) != StressField::StretchingStress))
+            makeVertexFieldsContinuous(fields[f]);
+    }
+
+    // Expand to the visualization mesh (same layout as visualizationField).
+    std::vector<size_t> vtxOffsets(ns + 1, 0), quadOffsets(ns + 1, 0);
+    for (size_t si = 0; si < ns; ++si) {
+        vtxOffsets [si + 1] = vtxOffsets [si] + m_segments[si].rod.numVisualizationVertices();
+        quadOffsets[si + 1] = quadOffsets[si] + m_segments[si].rod.numVisualizationQuads();
+    }
+
+    auto expandSegment = [&](size_t si) {
+        const auto &r = m_segments[si].rod;
+        for (size_t f = 0; f < nf; ++f) {
+            if (!requested(StressField(f))) continue;
+            const Eigen::VectorXd &field = fields[f][si];
+            if (StressField(f) == StressField::StretchingStress) {
+                OutReal *dst = out[f] + quadOffsets[si];
+                for (size_t j = 0; j < r.numEdges(); ++j) {
+                    const size_t numCrossSectionEdges = r.material(j).crossSectionBoundaryEdges.size();
+                    for (size_t i = 0; i < numCrossSectionEdges; ++i) *dst++ = field[j];
+                }
+            }
+            else {
+                OutReal *dst = out[f] + vtxOffsets[si];
+                for (size_t j = 0; j < r.numEdges(); ++j) {
+                    const size_t numCrossSectionPts = r.material(j).crossSectionBoundaryPts.size();
+                    for (size_t i = 0; i < numCrossSectionPts; ++i) { *dst++ = field[j]; *dst++ = field[j + 1]; }
+                }
+            }
+        }
+    };
+#if MESHFEM_WITH_TBB
+    parallel_for_range(ns, expandSegment);
+#else
+    for (size_t si = 0; si < ns; ++si) expandSegment(si);
+#endif
+}
+
+template<typename Real_>
+void RodLinkage_T<Real_>::stressVisualizationFields(unsigned fieldMask, const StressFieldOutputs &out) const {
+    m_stressVisualizationFields(fieldMask, out);
+}
+
+template<typename Real_>
+void RodLinkage_T<Real_>::stressVisualizationFields(unsigned fieldMask, const StressFieldOutputsF &out) const {
+    m_stressVisualizationFields(fieldMask, out);
+}
+
 template<typename Real_>
 void RodLinkage_T<Real_>::saveVisualizationGeometry(const std::string &path, const bool averagedMaterialFrames, const bool averagedCrossSections) const {
     std::vector<MeshIO::IOVertex > vertices;
@@ -4238,9 +4619,42 @@ void RodLinkage_T<Real_>::triangulation(std::vector<MeshIO::IOVertex> &vertices,
     }
 }
 
+template<typename Real_>
+MemoryReport RodLinkage_T<Real_>::memoryReport() const {
+    MemoryReport result;
+    result.add("segments", heapBytes(m_segments));
+    for (const auto &s : m_segments) result.add("segments", s.rod.memoryReport());
+    result.add("joints", heapBytes(m_joints));
+
+    result.add("dof_offsets", heapBytes(m_dofOffsetForSegment) + heapBytes(m_dofOffsetForJoint) + heapBytes(m_dofOffsetForCenterlinePos)
+                            + heapBytes(m_restLenDofOffsetForSegment) + heapBytes(m_restKappaDofOffsetForSegment)
+                            + heapBytes(m_designParameterDoFOffsetForJoint) + m_rod_orientation_indicator.capacity() / 8);
+    result.add("design_parameters", heapBytes(m_perSegmentRestLen) + heapBytes(m_designParametersPSRL)
+                                  + m_segmentRestLenToEdgeRestLenMapTranspose.memoryUsage());
+    result.add("network_state", nestedHeapBytes(m_networkPoints) + nestedHeapBytes(m_networkThetas));
+    result.add("materials", m_homogeneousMaterial.memoryUsage());
+
+    result.add("sensitivity_cache", heapBytes(m_sensitivityCache.sensitivityForTerminalEdge));
+    size_t sparsity = 0;
+    for (const auto &H : { &m_cachedHessianSparsity, &m_cachedHessianVarRLSparsity, &m_cachedHessianPSRLSparsity })
+        if (*H) sparsity += (*H)->memoryUsage();
+    result.add("hessian_sparsity_cache", sparsity);
+    size_t trace = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_cachedRodTrace.mutex);
+        if (m_cachedRodTrace.trace) {
+            trace = heapBytes(*m_cachedRodTrace.trace);
+            for (const auto &r : *m_cachedRodTrace.trace) trace += heapBytes(std::get<1>(r));
+        }
+    }
+    result.add("rod_trace_cache", trace);
+    return result;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
-// Explicit instantiation for ordinary double type and autodiff type.
+// Explicit instantiation for ordinary double type and autodiff types.
 ////////////////////////////////////////////////////////////////////////////////
 template struct RodLinkage_T<Real>;
 template struct RodLinkage_T<ADReal>;
+template struct RodLinkage_T<ADRealBatch>;
 // template RodLinkage_T<ADReal>::RodLinkage_T<Real>(const RodLinkage_T<Real> &);
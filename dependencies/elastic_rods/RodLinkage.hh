@@ -44,6 +44,7 @@
 #include <tuple>
 #include <unordered_set>
 #include <map>
+#include <mutex>
 
 #include <MeshFEM/Parallelism.hh>
 
@@ -100,11 +101,62 @@ struct RodLinkage_T {
 
     // Read the rod linkage from a line graph file.
     void read(const std::string &path, size_t subdivision = defaultSubdivision, bool initConsistentAngle = defaultConsistentAngle, InterleavingType rod_interleaving_type = InterleavingType::noOffset, std::vector<std::function<Pt3_T<Real_>(Real_, bool)>> edge_callbacks = {}, std::vector<Vec3> input_joint_normals = {});
+    // Read the rod linkage from a line graph file, discretizing each edge `ei` with `segmentSubdivisions[ei]` rod edges.
+    void read(const std::string &path, const std::vector<size_t> &segmentSubdivisions, bool initConsistentAngle = defaultConsistentAngle, InterleavingType rod_interleaving_type = InterleavingType::noOffset, std::vector<std::function<Pt3_T<Real_>(Real_, bool)>> edge_callbacks = {}, std::vector<Vec3> input_joint_normals = {});
 
     // Initialize by copying from another linkage
     template<typename Real2_>
     void set(const RodLinkage_T<Real2_> &linkage) {
         set(linkage.joints(), linkage.segments(), linkage.homogenousMaterial(), linkage.initialMinRestLength(), linkage.segmentRestLenToEdgeRestLenMapTranspose(), linkage.getPerSegmentRestLength(), linkage.getDesignParameterConfig());
+        m_parallelismArena = linkage.parallelismArena();
+        m_originalSegmentIndex = linkage.originalSegmentIndices();
+        m_originalJointIndex   = linkage.originalJointIndices();
+    }
+
+    // Whether `linkage` has the same joints, segments (including their
+    // endpoints and discretization) and numbering as this linkage, i.e.,
+    // whether `updateState` can be used to refresh this linkage from it.
+    template<typename Real2_>
+    bool hasSameTopology(const RodLinkage_T<Real2_> &linkage) const {
+        if ((linkage.numJoints() != numJoints()) || (linkage.numSegments() != numSegments()) || (linkage.numDoF() != numDoF()))
+            return false;
+        for (size_t si = 0; si < numSegments(); ++si) {
+            const auto &s = linkage.segment(si);
+            if ((s.startJoint != m_segments[si].startJoint) || (s.endJoint != m_segments[si].endJoint) ||
+                (s.rod.numVertices() != m_segments[si].rod.numVertices()))
+                return false;
+        }
+        return (linkage.originalSegmentIndices() == m_originalSegmentIndex) && (linkage.originalJointIndices() == m_originalJointIndex);
+    }
+
+    // Refresh this linkage in place from `linkage`, which must share this
+    // linkage's topology, discretization and materials (e.g., when updating an
+    // autodiff copy after the design parameters or equilibrium changed).
+    // Only the joint states, the rods' rest/deformed states, the rest lengths
+    // and the design parameters are transferred, reusing the existing storage.
+    // Use `set` instead if the topology or materials may have changed.
+    template<typename Real2_>
+    void updateState(const RodLinkage_T<Real2_> &linkage) {
+        if (!hasSameTopology(linkage))
+            throw std::runtime_error("Linkage topology mismatch in updateState; use set instead");
+
+        const auto &dPC = linkage.getDesignParameterConfig();
+        if ((dPC.restLen != m_linkage_dPC.restLen) || (dPC.restKappa != m_linkage_dPC.restKappa))
+            setDesignParameterConfig(dPC.restLen, dPC.restKappa, false);
+
+        for (size_t ji = 0; ji < numJoints(); ++ji) {
+            m_joints[ji] = Joint(linkage.joint(ji));
+            m_joints[ji].updateLinkagePointer(this);
+        }
+        for (size_t si = 0; si < numSegments(); ++si)
+            m_segments[si].rod.transferState(linkage.segment(si).rod);
+
+        m_initMinRestLen       = autodiffCast<Real_>(linkage.initialMinRestLength());
+        m_perSegmentRestLen    = autodiffCast<VecX>(linkage.getPerSegmentRestLength());
+        m_designParametersPSRL = autodiffCast<VecX>(linkage.getDesignParameters());
+
+        m_clearCache();
+        m_sensitivityCache.clear();
     }
 
     // Initialize by copying the passed joints, segments, homogeneous material (only used if later calling `set` to rebuild the rod segments), and initial rest length
@@ -120,6 +172,8 @@ struct RodLinkage_T {
         m_segments.clear();
         m_segments.reserve(segments.size());
         for (const auto &s : segments) m_segments.emplace_back(s);
+        m_originalSegmentIndex.clear();
+        m_originalJointIndex.clear();
 
         m_homogeneousMaterial = homogMat;
 
@@ -149,6 +203,13 @@ struct RodLinkage_T {
         read(path, subdivision, consistentAngle, rod_interleaving_type, edge_callbacks, input_joint_normals);
     }
 
+    void set(const std::string &path, const std::vector<size_t> &segmentSubdivisions,
+             bool consistentAngle = defaultConsistentAngle,
+             InterleavingType rod_interleaving_type = InterleavingType::noOffset, std::vector<std::function<Pt3_T<Real_>(Real_, bool)>> edge_callbacks = {}, std::vector<Vec3> input_joint_normals = {})
+    {
+        read(path, segmentSubdivisions, consistentAngle, rod_interleaving_type, edge_callbacks, input_joint_normals);
+    }
+
     // Initialize the rod linkage from a line graph.
     void set(std::vector<MeshIO::IOVertex > vertices, // copy edited inside
              std::vector<MeshIO::IOElement> edges,    // copy edited inside
@@ -156,6 +217,20 @@ struct RodLinkage_T {
              bool consistentAngle = defaultConsistentAngle,
              InterleavingType rod_interleaving_type = InterleavingType::noOffset,
              std::vector<std::function<Pt3_T<Real_>(Real_, bool)>> edge_callbacks = {}, 
+             std::vector<Vec3> input_joint_normals = {} ) {
+        const size_t ne = edges.size();
+        set(std::move(vertices), std::move(edges), std::vector<size_t>(ne, subdivision), consistentAngle, rod_interleaving_type, edge_callbacks, input_joint_normals);
+    }
+
+    // Initialize the rod linkage from a line graph, discretizing each edge
+    // `ei` with its own number of rod edges, `segmentSubdivisions[ei]` (e.g.,
+    // as chosen by adaptive refinement; see adaptive_subdivision.hh).
+    void set(std::vector<MeshIO::IOVertex > vertices, // copy edited inside
+             std::vector<MeshIO::IOElement> edges,    // copy edited inside
+             const std::vector<size_t> &segmentSubdivisions,
+             bool consistentAngle = defaultConsistentAngle,
+             InterleavingType rod_interleaving_type = InterleavingType::noOffset,
+             std::vector<std::function<Pt3_T<Real_>(Real_, bool)>> edge_callbacks = {}, 
              std::vector<Vec3> input_joint_normals = {} );
 
     /////////////////////////////////////////////////////////////////////////
@@ -178,6 +253,15 @@ struct RodLinkage_T {
              InterleavingType rod_interleaving_type = InterleavingType::noOffset,
              std::vector<std::function<Pt3_T<Real_>(Real_, bool)>> edge_callbacks = {}, 
              std::vector<Vec3> input_joint_normals = {}) {
+        set(vertices, edges, std::vector<size_t>(edges.rows(), subdivision), consistentAngle, rod_interleaving_type, edge_callbacks, input_joint_normals);
+    }
+
+    void set(const Eigen::MatrixX3d &vertices,
+             const Eigen::MatrixX2i &edges,
+             const std::vector<size_t> &segmentSubdivisions, bool consistentAngle = defaultConsistentAngle,
+             InterleavingType rod_interleaving_type = InterleavingType::noOffset,
+             std::vector<std::function<Pt3_T<Real_>(Real_, bool)>> edge_callbacks = {}, 
+             std::vector<Vec3> input_joint_normals = {}) {
         std::vector<MeshIO::IOVertex > ioVertices;
         std::vector<MeshIO::IOElement> ioEdges;
 
@@ -191,7 +275,7 @@ struct RodLinkage_T {
         for (size_t i = 0; i < ne; ++i)
             ioEdges.emplace_back(edges(i, 0), edges(i, 1));
 
-        set(ioVertices, ioEdges, subdivision, consistentAngle, rod_interleaving_type, edge_callbacks, input_joint_normals);
+        set(ioVertices, ioEdges, segmentSubdivisions, consistentAngle, rod_interleaving_type, edge_callbacks, input_joint_normals);
     }
 
     void set_interleaving_type(InterleavingType new_type);
@@ -328,6 +412,56 @@ struct RodLinkage_T {
     size_t restLenDofOffsetForSegment(size_t si) const { return m_restLenDofOffsetForSegment.at(si); }
     size_t restKappaDofOffsetForSegment(size_t si) const { return m_restKappaDofOffsetForSegment.at(si); }
 
+    // Renumber the segments and joints along a reverse Cuthill-McKee ordering
+    // of the joint graph so that adjacent joints (and the segments connecting
+    // them) receive nearby indices and, consequently, nearby DoF offsets.
+    // This narrows the bandwidth of the Hessian's segment-joint coupling and
+    // improves the memory locality of assembly, gradient scatter and
+    // Hessian-vector products; the DoFs remain ordered segments-then-joints.
+    // The geometry, deformed state and rest lengths are unchanged, but every
+    // index-based quantity (DoF vectors, fixed variables, joint/segment
+    // indices) must be expressed in the new numbering. The public indices are
+    // renumbered deliberately: the locality gain comes from the DoF offsets
+    // themselves following the joint graph, which translating indices at the
+    // accessors would undo. Call this before wrapping the linkage in a
+    // SurfaceAttractedLinkage or starting a solve, and use the original
+    // index maps below (or restoreOriginalOrder) to talk to code indexing
+    // joints by input vertex (e.g., the Grasshopper C API, which restores the
+    // original order of the linkages it loads).
+    void reorderForLocality();
+
+    // Undo all reorderForLocality calls, renumbering the joints and segments
+    // as they were when the linkage was built.
+    void restoreOriginalOrder();
+
+    // Index each (current) segment/joint had when the linkage was built.
+    // The maps compose over repeated reorderings and are empty until the
+    // first one (the identity); they are copied and serialized with the linkage.
+    size_t originalSegmentIndex(size_t si) const { return m_originalSegmentIndex.empty() ? si : m_originalSegmentIndex.at(si); }
+    size_t originalJointIndex  (size_t ji) const { return m_originalJointIndex  .empty() ? ji : m_originalJointIndex  .at(ji); }
+    const std::vector<size_t> &originalSegmentIndices() const { return m_originalSegmentIndex; }
+    const std::vector<size_t> &originalJointIndices()   const { return m_originalJointIndex; }
+    bool isReordered() const { return !m_originalSegmentIndex.empty() || !m_originalJointIndex.empty(); }
+
+    // Restore the original index maps (e.g., when deserializing); both must be
+    // empty or permutations of the current segment/joint indices.
+    void setOriginalIndices(const std::vector<size_t> &segmentIndices, const std::vector<size_t> &jointIndices) {
+        auto isPermutation = [](const std::vector<size_t> &p, size_t n) {
+            if (p.empty()) return true;
+            if (p.size() != n) return false;
+            std::vector<bool> seen(n, false);
+            for (size_t i : p) {
+                if ((i >= n) || seen[i]) return false;
+                seen[i] = true;
+            }
+            return true;
+        };
+        if (!isPermutation(segmentIndices, numSegments()) || !isPermutation(jointIndices, numJoints()))
+            throw std::runtime_error("Invalid original index maps");
+        m_originalSegmentIndex = segmentIndices;
+        m_originalJointIndex   = jointIndices;
+    }
+
     // Get the index of the joint closest of the center of the structure.
     // This is usually a good choice for the joint used to constrain the
     // structures global rigid motion/drive it open.
@@ -494,6 +628,17 @@ struct RodLinkage_T {
         return result;
     }
 
+    // Task arena in which the equilibrium solves and design optimizations of
+    // this linkage run (empty: the caller's arena). It is shared by copies of
+    // the linkage but not serialized.
+    const ParallelismArena &parallelismArena() const { return m_parallelismArena; }
+    void setParallelismArena(const ParallelismArena &arena) { m_parallelismArena = arena; }
+
+    // Heap memory held by the linkage: its rods ("segments.*", summed over
+    // all segments), joints, DoF bookkeeping, design parameters and caches
+    // (terminal edge sensitivities, Hessian sparsity patterns, rod traces).
+    MemoryReport memoryReport() const;
+
     const DesignParameterConfig &getDesignParameterConfig() const {
         return m_linkage_dPC;
     }
@@ -741,6 +886,19 @@ struct RodLinkage_T {
         coloredVisualizationGeometry(vertices, quads, averagedMaterialFrames, averagedCrossSections);
     }
 
+    // Topology-stable visualization mesh (see ElasticRod::visualizationPositions):
+    // the quads only change with the topology or the cross-sections, while the
+    // positions (and optionally normals) are refreshed in parallel over the segments.
+    size_t numVisualizationVertices() const;
+    size_t numVisualizationQuads() const;
+    void visualizationQuads(std::vector<MeshIO::IOElement> &quads) const;
+    void visualizationPositions(double *positions, double *normals = nullptr,
+                                const bool averagedMaterialFrames = false,
+                                const bool averagedCrossSections = false) const;
+    void visualizationPositions(float *positions, float *normals = nullptr,
+                                const bool averagedMaterialFrames = false,
+                                const bool averagedCrossSections = false) const;
+
     template<typename Derived>
     Eigen::Matrix<typename Derived::Scalar, Eigen::Dynamic, Derived::ColsAtCompileTime>
     visualizationField(const std::vector<Derived> &perRodSegmentFields) const {
@@ -815,28 +973,45 @@ struct RodLinkage_T {
             if (type != currType) throw std::runtime_error("Rod scalar fields are of mixed types (illegal)");
         }
 
-        // Vertex-based scalar fields must be made continuous across joints.
-        // For example, bending and twisting stresses are zero at the segment
-        // end vertices and we should copy the values from the coinciding
-        // vertices of the continuation segments.
-        if (type == ScalarFieldType::PER_VERTEX) {
-            for (size_t su = 0; su < numSegments(); ++su) {
-                for (size_t lji = 0; lji < 2; ++lji) {
-                    size_t ji = segment(su).joint(lji);
-                    if (ji == NONE) continue;
-                    size_t sv, is_start_sv;
-                    std::tie(sv, is_start_sv) = joint(ji).continuationSegmentInfo(su);
-                    if (sv == NONE) continue;
-                    const Eigen::VectorXd &src = result[sv];
-                    Eigen::VectorXd &dest = result[su];
-                    dest[lji == 0 ? 0 : dest.size() - 1] = src[is_start_sv ? 1 : src.size() - 2];
-                }
-            }
-        }
+        if (type == ScalarFieldType::PER_VERTEX) makeVertexFieldsContinuous(result);
 
         return result;
     }
 
+    // Vertex-based scalar fields must be made continuous across joints.
+    // For example, bending and twisting stresses are zero at the segment
+    // end vertices and we should copy the values from the coinciding
+    // vertices of the continuation segments.
+    void makeVertexFieldsContinuous(std::vector<Eigen::VectorXd> &perSegmentFields) const {
+        for (size_t su = 0; su < numSegments(); ++su) {
+            for (size_t lji = 0; lji < 2; ++lji) {
+                size_t ji = segment(su).joint(lji);
+                if (ji == NONE) continue;
+                size_t sv, is_start_sv;
+                std::tie(sv, is_start_sv) = joint(ji).continuationSegmentInfo(su);
+                if (sv == NONE) continue;
+                const Eigen::VectorXd &src = perSegmentFields[sv];
+                Eigen::VectorXd &dest = perSegmentFields[su];
+                dest[lji == 0 ? 0 : dest.size() - 1] = src[is_start_sv ? 1 : src.size() - 2];
+            }
+        }
+    }
+
+    // Stress/energy fields that can be evaluated together by stressVisualizationFields.
+    // The field `f` is selected by bit `1 << f` of the field mask.
+    enum class StressField { SqrtBendingEnergy, MaxBendingStress, MinBendingStress, VonMisesStress, TwistingStress, StretchingStress, Count };
+    template<typename OutReal>
+    using StressFieldOutputs_T = std::array<OutReal *, size_t(StressField::Count)>;
+    using StressFieldOutputs   = StressFieldOutputs_T<double>;
+    using StressFieldOutputsF  = StressFieldOutputs_T<float>; // single-precision output (e.g., for display)
+
+    // Compute all fields selected by `fieldMask` in a single parallel pass
+    // over the segments and write them, expanded to the visualization mesh,
+    // to `out[f]`. Per-vertex fields have numVisualizationVertices() entries;
+    // the per-edge stretching stresses have numVisualizationQuads() entries.
+    void stressVisualizationFields(unsigned fieldMask, const StressFieldOutputs &out) const;
+    void stressVisualizationFields(unsigned fieldMask, const StressFieldOutputsF &out) const;
+
     std::vector<Eigen::VectorXd> maxVonMisesStresses() const { return collectRodScalarFields([](const Rod &r) { return r.maxStresses(CrossSectionStressAnalysis::StressType::VonMises); }); }
     std::vector<Eigen::VectorXd> sqrtBendingEnergies() const { return collectRodScalarFields([](const Rod &r) { return stripAutoDiff(r.energyBendPerVertex()).array().sqrt().eval(); }); }
     std::vector<Eigen::VectorXd>  stretchingStresses() const { return collectRodScalarFields([](const Rod &r) { return r.stretchingStresses(); }); }
@@ -847,7 +1022,11 @@ struct RodLinkage_T {
     // Partition the segment indices into list of segments making up each rod (i.e., polylines)
     // Within each rod, segment indices are listed in order. We attempt to pick a
     // consistent direction for all "A" rods and all "B" rods (with A and B oriented oppositely).
-    std::vector<std::tuple<bool, std::vector<size_t>>> traceRods() const;
+    // The tracing is cached until the linkage's topology or rest configuration
+    // is reset (`set`, `reorderForLocality`, `setDesignParameterConfig`); call
+    // `setDesignParameterConfig` after editing rods' rest points directly.
+    using RodTrace = std::vector<std::tuple<bool, std::vector<size_t>>>;
+    const RodTrace &traceRods() const;
 
     // Get the "stress" (sqrt bending energy) values for each vertex along a full continuous rod.
     // Also get the "texture coordinates" of these stress values, where
@@ -1053,6 +1232,11 @@ struct RodLinkage_T {
 
         // Use with care!
         void updateLinkagePointer(RodLinkage_T *ptr) { m_linkage = ptr; }
+        // Renumber the incident segments (segment si becomes newIndex[si]).
+        void remapSegmentIndices(const std::vector<size_t> &newIndex) {
+            for (size_t &si : m_segmentsA) if (si != NONE) si = newIndex.at(si);
+            for (size_t &si : m_segmentsB) if (si != NONE) si = newIndex.at(si);
+        }
 
         // Sadly cannot be deduced from getState()'s return (with auto)
         using SerializedState = std::tuple<Pt3, Vec3, Real_, Real_, Real_, Real_, Vec3, Vec3,
@@ -1362,6 +1546,11 @@ struct RodLinkage_T {
 
     std::string mangledName() const { return "RodLinkage<" + autodiffOrNotString<Real_>() + ">"; }
 protected:
+    template<typename OutReal>
+    void m_visualizationPositions(OutReal *positions, OutReal *normals, const bool averagedMaterialFrames, const bool averagedCrossSections) const;
+    template<typename OutReal>
+    void m_stressVisualizationFields(unsigned fieldMask, const StressFieldOutputs_T<OutReal> &out) const;
+
     std::vector<Joint> m_joints;
     std::vector<RodSegment> m_segments;
     void m_set_indication_for_rod_orientation(std::vector<RodSegment>& temp_segments, std::vector<Joint>& temp_joints);
@@ -1380,6 +1569,10 @@ protected:
                         m_designParameterDoFOffsetForJoint;
 
     std::vector<bool> m_rod_orientation_indicator;
+
+    // Original indices of the segments/joints after reorderForLocality (empty: identity)
+    std::vector<size_t> m_originalSegmentIndex, m_originalJointIndex;
+    void m_permute(const std::vector<size_t> &jointOrder, const std::vector<size_t> &segmentOrder);
     
     Real_ m_initMinRestLen = 0;
 
@@ -1395,6 +1588,7 @@ protected:
     std::vector<std::vector<Real_>> m_networkThetas;
 
     AngleBoundEnforcement m_angleBoundEnforcement = AngleBoundEnforcement::Penalty;
+    ParallelismArena m_parallelismArena;
 
     ConstraintBarrier m_constraintBarrier;
     struct SensitivityCache {
@@ -1426,7 +1620,20 @@ protected:
     // Cache for hessian sparsity patterns
     ////////////////////////////////////////////////////////////////////////////
     mutable std::unique_ptr<CSCMat> m_cachedHessianSparsity, m_cachedHessianVarRLSparsity, m_cachedHessianPSRLSparsity;
-    void m_clearCache() { m_cachedHessianSparsity.reset(), m_cachedHessianVarRLSparsity.reset(), m_cachedHessianPSRLSparsity.reset(); }
+    // Cache for the rod tracing, built on first use (possibly by concurrent
+    // const callers, hence the mutex) and dropped with the sparsity caches
+    // whenever the topology or rest configuration is reset. Copies start empty.
+    struct RodTraceCache {
+        RodTraceCache() { }
+        RodTraceCache(const RodTraceCache &) { }
+        RodTraceCache &operator=(const RodTraceCache &) { reset(); return *this; }
+        void reset() { std::lock_guard<std::mutex> lock(mutex); trace.reset(); }
+        std::mutex mutex;
+        std::unique_ptr<RodTrace> trace;
+    };
+    mutable RodTraceCache m_cachedRodTrace;
+    RodTrace m_traceRods() const;
+    void m_clearCache() { m_cachedHessianSparsity.reset(), m_cachedHessianVarRLSparsity.reset(), m_cachedHessianPSRLSparsity.reset(); m_cachedRodTrace.reset(); }
 };
 
 #endif /* end of include guard: RODLINKAGE_HH */
@@ -43,7 +43,7 @@ RodHessianApplier<F, Real_> make_rod_hessian_applier(F &f, size_t nvars, RHALoca
 
 template<typename Real_>
 auto RodLinkage_T<Real_>::applyHessian(const VecX &v, bool variableDesignParameters, const HessianComputationMask &mask) const -> VecX {
-    BENCHMARK_SCOPED_TIMER_SECTION timer(mangledName() + ".applyHessian");
+    PROFILE_SCOPE(mangledName() + ".applyHessian");
     const size_t ndof = variableDesignParameters ? numExtendedDoF() : numDoF();
     if (size_t(v.size()) != ndof) throw std::runtime_error("Input vector size mismatch");
 
@@ -237,7 +237,7 @@ auto RodLinkage_T<Real_>::applyHessian(const VecX &v, bool variableDesignParamet
 
 template<typename Real_>
 auto RodLinkage_T<Real_>::applyHessianPerSegmentRestlen(const VecX &v, const HessianComputationMask &mask) const -> VecX {
-    BENCHMARK_SCOPED_TIMER_SECTION timer(mangledName() + ".applyHessianPSRL");
+    PROFILE_SCOPE(mangledName() + ".applyHessianPSRL");
     const size_t ndof = numExtendedDoFPSRL();
     if (size_t(v.size()) != ndof) throw std::runtime_error("Input vector size mismatch");
 
@@ -457,10 +457,18 @@ RodMaterial::m_computeStiffnesses(Real E, Real nu,
     return std::make_pair(cm, Q.transpose());
 }
 
+// The analysis object is shared between copies of this material, which may be
+// evaluated concurrently (e.g., by different rods of a linkage), so it is
+// never modified in place: if this material's moduli no longer match the
+// shared analysis, the material switches to its own updated copy.
 const CrossSectionStressAnalysis &RodMaterial::stressAnalysis() const {
     if (m_crossSectionStressAnalysis) {
-        m_crossSectionStressAnalysis->youngModulus = youngModulus;
-        m_crossSectionStressAnalysis->shearModulus = shearModulus;
+        if ((m_crossSectionStressAnalysis->youngModulus != youngModulus) || (m_crossSectionStressAnalysis->shearModulus != shearModulus)) {
+            auto analysis = std::make_shared<CrossSectionStressAnalysis>(*m_crossSectionStressAnalysis);
+            analysis->youngModulus = youngModulus;
+            analysis->shearModulus = shearModulus;
+            m_crossSectionStressAnalysis = std::move(analysis);
+        }
         return *m_crossSectionStressAnalysis;
     }
     if (!m_crossSectionMesh) throw std::runtime_error("A cross-section mesh is needed to construct a stress analysis object!");
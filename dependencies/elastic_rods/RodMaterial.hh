@@ -25,6 +25,7 @@
 #include "CrossSectionStressAnalysis.hh"
 
 #include <Eigen/StdVector> // Work around alignment issues with std::vector
+#include <MeshFEM/MemoryReport.hh>
 
 // Forward declare CrossSectionMesh to avoid bringing in FEMMesh when unnecessary
 class CrossSectionMesh;
@@ -177,6 +178,10 @@ struct RodMaterial {
 
     const CrossSectionStressAnalysis &stressAnalysis() const;
 
+    // Heap memory owned by this copy of the material (the cross-section,
+    // its mesh and stress analysis are shared between copies and excluded).
+    size_t memoryUsage() const { return heapBytes(crossSectionBoundaryPts) + heapBytes(crossSectionBoundaryEdges); }
+
     // For serialization
     std::shared_ptr<CrossSectionStressAnalysis> stressAnalysisPtr() const { return m_crossSectionStressAnalysis; }
     void setStressAnalysisPtr(std::shared_ptr<CrossSectionStressAnalysis> ptr) { m_crossSectionStressAnalysis = ptr; }
@@ -19,6 +19,8 @@ struct SurfaceAttractedLinkage_T;
 
 using SurfaceAttractedLinkage = SurfaceAttractedLinkage_T<Real>;
 
+struct LinkageBinaryIO;
+
 template<typename Real_>
 struct SurfaceAttractedLinkage_T : public RodLinkage_T<Real_> {
     using Base = RodLinkage_T<Real_>;
@@ -125,6 +127,18 @@ struct SurfaceAttractedLinkage_T : public RodLinkage_T<Real_> {
         m_E0 = linkage.get_E0();
     }
 
+    // In-place refresh from a linkage with identical topology/materials (see RodLinkage_T::updateState).
+    template<typename Real2_>
+    void updateState(const SurfaceAttractedLinkage_T<Real2_> &linkage) {
+        Base::updateState(linkage);
+        attraction_weight = linkage.attraction_weight;
+        m_attraction_tgt_joint_weight = linkage.get_attraction_tgt_joint_weight();
+        target_surface_fitter = linkage.get_target_surface_fitter();
+
+        m_l0 = linkage.get_l0();
+        m_E0 = linkage.get_E0();
+    }
+
 
     template<typename Real2_>
     void set(const std::string &surface_path, const bool useCenterline, 
@@ -202,7 +216,7 @@ struct SurfaceAttractedLinkage_T : public RodLinkage_T<Real_> {
     }
 
     VecX gradient(bool updatedSource = false, SurfaceAttractionEnergyType surface_eType = SurfaceAttractionEnergyType::Full, bool variableDesignParameters = false, bool designParameterOnly = false, const bool skipBRods = false) const {
-        BENCHMARK_SCOPED_TIMER_SECTION timer(mangledName() + ".gradient");
+        PROFILE_SCOPE(mangledName() + ".gradient");
         VecX gradient(variableDesignParameters ? Base::numExtendedDoF() : Base::numDoF());
         gradient.setZero();
         if ((surface_eType == SurfaceAttractionEnergyType::Full) || (surface_eType == SurfaceAttractionEnergyType::Elastic))
@@ -216,15 +230,15 @@ struct SurfaceAttractedLinkage_T : public RodLinkage_T<Real_> {
     }
 
     VecX gradientBend(bool updatedSource = false, bool variableDesignParameters = false, bool designParameterOnly = false, const bool skipBRods = false) const {
-        BENCHMARK_SCOPED_TIMER_SECTION timer(mangledName() + ".gradientBend");
+        PROFILE_SCOPE(mangledName() + ".gradientBend");
         return Base::gradient(updatedSource, EnergyType::Bend, variableDesignParameters, designParameterOnly, skipBRods);
     }
     VecX gradientTwist(bool updatedSource = false, bool variableDesignParameters = false, bool designParameterOnly = false, const bool skipBRods = false) const {
-        BENCHMARK_SCOPED_TIMER_SECTION timer(mangledName() + ".gradientTwist");
+        PROFILE_SCOPE(mangledName() + ".gradientTwist");
         return Base::gradient(updatedSource, EnergyType::Twist, variableDesignParameters, designParameterOnly, skipBRods);
     }
     VecX gradientStretch(bool updatedSource = false, bool variableDesignParameters = false, bool designParameterOnly = false, const bool skipBRods = false) const {
-        BENCHMARK_SCOPED_TIMER_SECTION timer(mangledName() + ".gradientStretch");
+        PROFILE_SCOPE(mangledName() + ".gradientStretch");
         return Base::gradient(updatedSource, EnergyType::Stretch, variableDesignParameters, designParameterOnly, skipBRods);
     }
     
@@ -273,7 +287,7 @@ struct SurfaceAttractedLinkage_T : public RodLinkage_T<Real_> {
     // Accumulate the Hessian into the sparse matrix "H," which must already be initialized
     // with the sparsity pattern.
     void hessian(CSCMat &H, SurfaceAttractionEnergyType surface_eType = SurfaceAttractionEnergyType::Full, const bool variableDesignParameters = false) const {
-        BENCHMARK_SCOPED_TIMER_SECTION timer(mangledName() + ".hessian");
+        PROFILE_SCOPE(mangledName() + ".hessian");
         if ((surface_eType == SurfaceAttractionEnergyType::Full) || (surface_eType == SurfaceAttractionEnergyType::Elastic))
             Base::hessian(H, EnergyType::Full, variableDesignParameters);
         if ((surface_eType == SurfaceAttractionEnergyType::Full) || (surface_eType == SurfaceAttractionEnergyType::Attraction))
@@ -396,6 +410,8 @@ struct SurfaceAttractedLinkage_T : public RodLinkage_T<Real_> {
     }
     virtual ~SurfaceAttractedLinkage_T() { }
 protected:
+    friend struct LinkageBinaryIO; // serializes/restores the fitter state directly
+
     TargetSurfaceFitter target_surface_fitter;
     std::string m_surface_path;
     Real m_l0 = 1, m_E0  = 1;
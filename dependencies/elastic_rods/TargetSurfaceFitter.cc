@@ -92,7 +92,7 @@ void TargetSurfaceFitter::forceUpdateClosestPoints(const RodLinkage_T<Real_> &li
     // update each joint's closest surface point.
     if ((size_t(linkage_closest_surf_pts.size()) == 3 * numSamplePts) && (Wsurf_diag_linkage_sample_pos.norm() == 0.0)) return;
 
-    BENCHMARK_SCOPED_TIMER_SECTION timer("Update closest points");
+    PROFILE_SCOPE("Update closest points");
     linkage_closest_surf_pts.resize(3 * numSamplePts);
     linkage_closest_surf_pt_sensitivities.resize(numSamplePts);
     linkage_closest_surf_tris.resize(numSamplePts);
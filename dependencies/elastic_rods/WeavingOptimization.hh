@@ -31,13 +31,15 @@ struct WeavingOptimization : public LinkageOptimization<Object>{
     using LO::m_equilibriumSolveSuccessful;
     using LO::m_adjointStateIsCurrent;
     using LO::m_autodiffLinkagesAreCurrent;
+    using LO::m_autodiffLinkagesNeedRebuild;
+    using LO::m_refreshAutodiffLinkage;
     using LO::prediction_order;
     using LO::numParams;
-#if HAS_KNITRO
     using LO::optimize;
-#endif
 
     WeavingOptimization(Object<Real> &weaver, std::string input_surface_path, bool useCenterline, const NewtonOptimizerOptions &eopts = NewtonOptimizerOptions(), int pinJoint = -1, bool useFixedJoint = true, const std::vector<size_t> &fixedVars = std::vector<size_t>());
+    // Construct with the target surface mesh passed directly (vertices and triangles) instead of read from a file.
+    WeavingOptimization(Object<Real> &weaver, const Eigen::MatrixXd &targetV, const Eigen::MatrixXi &targetF, bool useCenterline, const NewtonOptimizerOptions &eopts = NewtonOptimizerOptions(), int pinJoint = -1, bool useFixedJoint = true, const std::vector<size_t> &fixedVars = std::vector<size_t>());
 
     Eigen::VectorXd gradp_J(const Eigen::Ref<const Eigen::VectorXd> &params, OptEnergyType opt_eType = OptEnergyType::Full);
 
@@ -136,6 +138,11 @@ struct WeavingOptimization : public LinkageOptimization<Object>{
         invalidateAdjointState();
     }
 
+    void setTargetSurface(const Eigen::MatrixXd &V, const Eigen::MatrixXi &F) {
+        target_surface_fitter.setTargetSurface(m_base, V, F);
+        invalidateAdjointState();
+    }
+
     void setEquilibriumOptions(const NewtonOptimizerOptions &eopts) { getWeaverOptimizer().options = eopts; }
     NewtonOptimizerOptions getEquilibriumOptions() const { return m_weaver_optimizer->options; }
     NewtonOptimizerOptions &equilibriumOptions() { return m_weaver_optimizer->options; }
@@ -153,6 +160,9 @@ struct WeavingOptimization : public LinkageOptimization<Object>{
 
 
 private:
+    // Shared constructor implementation; `initTargetSurface` loads/sets the target surface.
+    void m_initialize(Object<Real> &weaver, const std::function<void()> &initTargetSurface, bool useCenterline, int pinJoint, bool useFixedJoint, const std::vector<size_t> &fixedVars);
+
     void m_forceEquilibriumUpdate();
     // Return whether "params" are actually new...
     bool m_updateEquilibria(const Eigen::Ref<const Eigen::VectorXd> &params);
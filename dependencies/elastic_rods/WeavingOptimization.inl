@@ -5,6 +5,19 @@ WeavingOptimization<Object>::WeavingOptimization(Object<Real> &weaver, const std
     : LinkageOptimization<Object>(weaver, eopts, weaver.energy(), BBox<Point3D>(weaver.deformedPoints()).dimensions().norm(), weaver.totalRestLength()),
       m_restKappaSmoothing(m_linesearch_base), m_restLengthMinimization(m_linesearch_base)
 {
+    m_initialize(weaver, [&]() { loadTargetSurface(input_surface_path); }, useCenterline, pinJoint, useFixedJoint, fixedVars);
+}
+
+template<template<typename> class Object>
+WeavingOptimization<Object>::WeavingOptimization(Object<Real> &weaver, const Eigen::MatrixXd &targetV, const Eigen::MatrixXi &targetF, bool useCenterline, const NewtonOptimizerOptions &eopts, int pinJoint, bool useFixedJoint, const std::vector<size_t> &fixedVars)
+    : LinkageOptimization<Object>(weaver, eopts, weaver.energy(), BBox<Point3D>(weaver.deformedPoints()).dimensions().norm(), weaver.totalRestLength()),
+      m_restKappaSmoothing(m_linesearch_base), m_restLengthMinimization(m_linesearch_base)
+{
+    m_initialize(weaver, [&]() { setTargetSurface(targetV, targetF); }, useCenterline, pinJoint, useFixedJoint, fixedVars);
+}
+
+template<template<typename> class Object>
+void WeavingOptimization<Object>::m_initialize(Object<Real> &weaver, const std::function<void()> &initTargetSurface, bool useCenterline, int pinJoint, bool useFixedJoint, const std::vector<size_t> &fixedVars) {
     std::runtime_error mismatch("Linkage mismatch");
     if (m_numParams != weaver.numDesignParams()) throw mismatch;
     // Initialize the auto diff
@@ -26,7 +39,7 @@ WeavingOptimization<Object>::WeavingOptimization(Object<Real> &weaver, const std
 
     // Unless the user specifies otherwise, use the current deployed linkage joint positions as the target
     target_surface_fitter.joint_pos_tgt = weaver.jointPositions();
-    loadTargetSurface(input_surface_path);
+    initTargetSurface();
 
     m_rigidMotionFixedVars.insert(std::end(m_rigidMotionFixedVars), std::begin(fixedVars), std::end(fixedVars));
 
@@ -147,7 +160,7 @@ bool WeavingOptimization<Object>::m_updateEquilibria(const Eigen::Ref<const Eige
     Eigen::VectorXd curr_x = m_base.getDoFs();
     Eigen::VectorXd best_x = curr_x;
     if (prediction_order > PredictionOrder::Zero) {
-        BENCHMARK_SCOPED_TIMER_SECTION timer("Predict equilibrium");
+        PROFILE_SCOPE("Predict equilibrium");
         // Return to using the Hessian for the last committed linkage
         // (i.e. for the equilibrium stored in m_flat and m_deployed).
         auto &opt_weaver = getWeaverOptimizer();
@@ -188,7 +201,8 @@ bool WeavingOptimization<Object>::m_updateEquilibria(const Eigen::Ref<const Eige
                 //      [H_3D a][delta_p^T d2x/dp^2 delta_p] = -[d3E/dx3 delta_x + d3E/dx2dp delta_p 0][delta_x     ] + [-(d3E/dxdpdx delta_x + d3E/dxdpdp delta_p) delta_p] = -[d3E/dx3 delta_x + d3E/dx2dp delta_p    d3E/dxdpdx delta_x + d3E/dxdpdp delta_p    0][delta_x     ]
                 //      [a^T  0][delta_p^T d2l/dp^2 delta_p]    [0                                   0][delta_lambda] + [                       0                          ]    [                0                                         0                       0][delta_p     ]
                 //                                                                                                                                                                                                                                                   [delta_lambda]
-                m_diff_linkage_weaver.set(m_base);
+                m_refreshAutodiffLinkage(m_diff_linkage_weaver, m_base, m_autodiffLinkagesNeedRebuild);
+                m_autodiffLinkagesNeedRebuild = false;
 
                 Eigen::VectorXd neg_d3E_delta_x;
                 {
@@ -277,7 +291,7 @@ template<template<typename> class Object>
 Eigen::VectorXd WeavingOptimization<Object>::apply_hess(const Eigen::Ref<const Eigen::VectorXd> &params,
                                                 const Eigen::Ref<const Eigen::VectorXd> &delta_p,
                                                 Real coeff_J, Real /* coeff_c */, Real /* coeff_angle_constraint */, OptEnergyType opt_eType) {
-    BENCHMARK_SCOPED_TIMER_SECTION timer("apply_hess_J");
+    PROFILE_SCOPE("apply_hess_J");
     BENCHMARK_START_TIMER_SECTION("Preamble");
     const size_t np = numParams(), nd = m_linesearch_base.numDoF();
     if (size_t( params.size()) != np) throw std::runtime_error("Incorrect parameter vector size");
@@ -285,9 +299,10 @@ Eigen::VectorXd WeavingOptimization<Object>::apply_hess(const Eigen::Ref<const E
     m_updateAdjointState(params);
 
     if (!m_autodiffLinkagesAreCurrent) {
-        BENCHMARK_SCOPED_TIMER_SECTION timer2("Update autodiff linkages");
-        m_diff_linkage_weaver.set(m_linesearch_base);
-        m_autodiffLinkagesAreCurrent = true;
+        PROFILE_SCOPE("Update autodiff linkages");
+        m_refreshAutodiffLinkage(m_diff_linkage_weaver, m_linesearch_base, m_autodiffLinkagesNeedRebuild);
+        m_autodiffLinkagesNeedRebuild = false;
+        m_autodiffLinkagesAreCurrent  = true;
     }
 
     auto &opt  = getWeaverOptimizer();
@@ -314,7 +329,7 @@ Eigen::VectorXd WeavingOptimization<Object>::apply_hess(const Eigen::Ref<const E
         //                          \_________________/
         //                                   b
         {
-            BENCHMARK_SCOPED_TIMER_SECTION timer2("solve delta x");
+            PROFILE_SCOPE("solve delta x");
             VecX_T<Real> b = m_linesearch_base.applyHessianPerSegmentRestlen(neg_deltap_padded, mask_dxdp).head(nd);
             m_delta_x = opt.extractFullSolution(H_3D.solve(opt.removeFixedEntries(b)));
         }
@@ -340,7 +355,7 @@ Eigen::VectorXd WeavingOptimization<Object>::apply_hess(const Eigen::Ref<const E
         //                            \__________________________________________________/
         //                                                        b
         if (coeff_J != 0.0) {
-            BENCHMARK_SCOPED_TIMER_SECTION timer2("solve delta w x");
+            PROFILE_SCOPE("solve delta w x");
             BENCHMARK_START_TIMER_SECTION("Hw");
             VecX_T<ADReal> w_padded(nd + np);
             w_padded.head(nd) = objective.adjointState();
@@ -369,7 +384,7 @@ Eigen::VectorXd WeavingOptimization<Object>::apply_hess(const Eigen::Ref<const E
     result.setZero(np);
     // Accumulate the J hessian matvec
     {
-        BENCHMARK_SCOPED_TIMER_SECTION timer3("evaluate hessian matvec");
+        PROFILE_SCOPE("evaluate hessian matvec");
         if (coeff_J != 0.0) {
             VecX_T<Real> delta_edofs(nd + np);
             delta_edofs.head(nd) = m_delta_w_x;
@@ -388,3 +403,4 @@ Eigen::VectorXd WeavingOptimization<Object>::apply_hess(const Eigen::Ref<const E
 
     return result;
 }
+
@@ -46,14 +46,14 @@ struct XShellOptimization : public LinkageOptimization<Object>{
     using LO::m_equilibriumSolveSuccessful;
     using LO::m_adjointStateIsCurrent;
     using LO::m_autodiffLinkagesAreCurrent;
+    using LO::m_autodiffLinkagesNeedRebuild;
+    using LO::m_refreshAutodiffLinkage;
     using LO::prediction_order;
     using LO::numParams;
     using LO::m_rl0;
     using LO::params;
     using LO::getRestLengthMinimizationWeight;
-#if HAS_KNITRO
     using LO::optimize;
-#endif
     using LO::apply_hess_J;
     using LO::J;
     // allowFlatActuation: whether we allow the application of average-angle actuation to enforce the minimum angle constraint at the beginning of optimization.
@@ -189,7 +189,7 @@ bool XShellOptimization<Object>::m_updateEquilibria(const Eigen::Ref<const Eigen
                     best_x2d = curr_x2d;
 
     if (prediction_order > PredictionOrder::Zero) {
-        BENCHMARK_SCOPED_TIMER_SECTION timer("Predict equilibrium");
+        PROFILE_SCOPE("Predict equilibrium");
         // Return to using the Hessian for the last committed linkage
         // (i.e. for the equilibrium stored in m_flat and m_deployed).
         auto &opt_2D = getFlatOptimizer();
@@ -250,8 +250,9 @@ bool XShellOptimization<Object>::m_updateEquilibria(const Eigen::Ref<const Eigen
                 //      [a^T  0][delta_p^T d2l/dp^2 delta_p]    [0                                   0][delta_lambda] + [                       0                          ]    [                0                                         0                       0][delta_p     ]
                 //                                                                                                                                                                                                                                                   [delta_lambda]
                 // Same system when optimizing for alpha too
-                m_diff_linkage_deployed.set(m_deployed);
-                m_diff_linkage_flat    .set(m_base);
+                m_refreshAutodiffLinkage(m_diff_linkage_deployed, m_deployed, m_autodiffLinkagesNeedRebuild);
+                m_refreshAutodiffLinkage(m_diff_linkage_flat,     m_base,     m_autodiffLinkagesNeedRebuild);
+                m_autodiffLinkagesNeedRebuild = false;
 
                 Eigen::VectorXd neg_d3E_delta_x3d, neg_d3E_delta_x2d;
                 {
@@ -595,7 +596,7 @@ template<template<typename> class Object>
 Eigen::VectorXd XShellOptimization<Object>::apply_hess(const Eigen::Ref<const Eigen::VectorXd> &params,
                                                 const Eigen::Ref<const Eigen::VectorXd> &delta_p,
                                                 Real coeff_J, Real coeff_c, Real coeff_angle_constraint, OptEnergyType opt_eType) {
-    BENCHMARK_SCOPED_TIMER_SECTION timer("apply_hess_J");
+    PROFILE_SCOPE("apply_hess_J");
     BENCHMARK_START_TIMER_SECTION("Preamble");
     const size_t np = numParams(), nd = m_linesearch_base.numDoF(), nfp = numFullParams();
     if (params.size()  != int(nfp))     throw std::runtime_error("Incorrect parameter vector size");
@@ -604,10 +605,11 @@ Eigen::VectorXd XShellOptimization<Object>::apply_hess(const Eigen::Ref<const Ei
     m_updateAdjointState(params, opt_eType);
 
     if (!m_autodiffLinkagesAreCurrent) {
-        BENCHMARK_SCOPED_TIMER_SECTION timer2("Update autodiff linkages");
-        m_diff_linkage_deployed.set(m_linesearch_deployed);
-        m_diff_linkage_flat    .set(m_linesearch_base);
-        m_autodiffLinkagesAreCurrent = true;
+        PROFILE_SCOPE("Update autodiff linkages");
+        m_refreshAutodiffLinkage(m_diff_linkage_deployed, m_linesearch_deployed, m_autodiffLinkagesNeedRebuild);
+        m_refreshAutodiffLinkage(m_diff_linkage_flat,     m_linesearch_base,     m_autodiffLinkagesNeedRebuild);
+        m_autodiffLinkagesNeedRebuild = false;
+        m_autodiffLinkagesAreCurrent  = true;
     }
 
     auto &opt_3D  = getDeployedOptimizer();
@@ -640,7 +642,7 @@ Eigen::VectorXd XShellOptimization<Object>::apply_hess(const Eigen::Ref<const Ei
         //                         b                                          \_________________/
         //                                                                             b
         // Depending on whether the closed linkage is actuated.
-        BENCHMARK_SCOPED_TIMER_SECTION timer2("solve delta x2d");
+        PROFILE_SCOPE("solve delta x2d");
         auto &opt_2D = getFlatOptimizer();
 
         Eigen::VectorXd b_reduced = opt_2D.removeFixedEntries(m_linesearch_base.applyHessianPerSegmentRestlen(neg_deltap_padded, mask_dxdp).head(nd));
@@ -668,7 +670,7 @@ Eigen::VectorXd XShellOptimization<Object>::apply_hess(const Eigen::Ref<const Ei
         //                          \_________________/
         //                                   b
         {
-            BENCHMARK_SCOPED_TIMER_SECTION timer2("solve delta x3d");
+            PROFILE_SCOPE("solve delta x3d");
             VecX_T<Real> b = m_linesearch_deployed.applyHessianPerSegmentRestlen(neg_deltap_padded, mask_dxdp).head(nd);
             if (m_optimizeTargetAngle){
                 m_delta_x3d = opt_3D.extractFullSolution(opt_3D.kkt_solver(H_3D, opt_3D.removeFixedEntries(b), delta_p[np]));
@@ -712,7 +714,7 @@ Eigen::VectorXd XShellOptimization<Object>::apply_hess(const Eigen::Ref<const Ei
         //                                                                      b
         
         if (coeff_J != 0.0) {
-            BENCHMARK_SCOPED_TIMER_SECTION timer2("solve delta w x");
+            PROFILE_SCOPE("solve delta w x");
             BENCHMARK_START_TIMER_SECTION("Hw");
             VecX_T<ADReal> w_padded(nd + np);
             w_padded.head(nd) = m_w_x;
@@ -758,7 +760,7 @@ Eigen::VectorXd XShellOptimization<Object>::apply_hess(const Eigen::Ref<const Ei
         if (m_minAngleConstraint && (coeff_angle_constraint != 0.0)) {
             auto &opt_2D = getFlatOptimizer();
 
-            BENCHMARK_SCOPED_TIMER_SECTION timer2("solve delta s x");
+            PROFILE_SCOPE("solve delta s x");
             BENCHMARK_START_TIMER_SECTION("Hs");
             VecX_T<ADReal> s_padded(nd + np);
             s_padded.head(nd) = m_s_x;
@@ -780,7 +782,7 @@ Eigen::VectorXd XShellOptimization<Object>::apply_hess(const Eigen::Ref<const Ei
         // where delta H_2D = d3E/dx dx dx delta_x + d3E/dx dx dp delta_p.
         if (coeff_c != 0.0) {
             auto &opt_2D = getFlatOptimizer();
-            BENCHMARK_SCOPED_TIMER_SECTION timer2("solve delta y");
+            PROFILE_SCOPE("solve delta y");
             BENCHMARK_START_TIMER_SECTION("Hy");
             VecX_T<ADReal> y_padded(nd + np);
             y_padded.head(nd) = m_y;
@@ -816,7 +818,7 @@ Eigen::VectorXd XShellOptimization<Object>::apply_hess(const Eigen::Ref<const Ei
 
     // Accumulate the J hessian matvec
     {
-        BENCHMARK_SCOPED_TIMER_SECTION timer3("evaluate hessian matvec");
+        PROFILE_SCOPE("evaluate hessian matvec");
 
         if (coeff_J != 0.0) {
 
@@ -0,0 +1,159 @@
+////////////////////////////////////////////////////////////////////////////////
+// adaptive_subdivision.hh
+////////////////////////////////////////////////////////////////////////////////
+/*! @file
+//  Adaptive per-segment discretization of linkages. Instead of applying one
+//  global `subdivision` to every segment, the number of rod edges of each
+//  segment is chosen so that the deformed centerline's turning angle between
+//  consecutive edges (curvature times edge length) stays near a target:
+//  highly bent segments are refined while nearly straight ones are
+//  coarsened. The linkage is then rebuilt from its line graph with the new
+//  per-segment subdivisions, and its rest lengths and deformed state are
+//  transferred to the new discretization (see multilevel_equilibrium.hh).
+*/
+////////////////////////////////////////////////////////////////////////////////
+#ifndef ADAPTIVE_SUBDIVISION_HH
+#define ADAPTIVE_SUBDIVISION_HH
+
+#include "RodLinkage.hh"
+#include "compute_equilibrium.hh"
+#include "multilevel_equilibrium.hh"
+
+#include <vector>
+#include <memory>
+#include <cmath>
+#include <algorithm>
+
+struct AdaptiveSubdivisionOptions {
+    Real targetTurningAngle = 0.05; // desired maximum angle (radians) between consecutive edges of each segment
+    size_t minSubdivision = 7;      // rods in a linkage need at least 7 edges
+    size_t maxSubdivision = 200;
+    bool allowCoarsening = true;    // coarsen segments whose turning angles are below half the target
+    size_t maxPasses = 3;           // maximum number of re-discretizations in compute_equilibrium_adaptive
+
+    // Line graph construction settings (must match those of the linkage being adapted).
+    bool consistentAngle = RodLinkage::defaultConsistentAngle;
+    InterleavingType interleavingType = InterleavingType::noOffset;
+};
+
+// Current number of rod edges of each segment, indexed by the segments'
+// original indices (i.e., by the edges of the line graph).
+inline std::vector<size_t> segmentSubdivisions(const RodLinkage &linkage) {
+    std::vector<size_t> result(linkage.numSegments());
+    for (size_t si = 0; si < linkage.numSegments(); ++si)
+        result.at(linkage.originalSegmentIndex(si)) = linkage.segment(si).rod.numEdges();
+    return result;
+}
+
+// Maximum turning angle between consecutive edges of each segment's
+// deformed centerline, indexed by the segments' original indices.
+inline std::vector<Real> segmentTurningAngles(const RodLinkage &linkage) {
+    std::vector<Real> result(linkage.numSegments());
+    parallel_for_range(linkage.numSegments(), [&](size_t si) {
+        const auto &t = linkage.segment(si).rod.deformedConfiguration().tangent;
+        Real maxAngle = 0;
+        for (size_t i = 1; i < t.size(); ++i)
+            maxAngle = std::max(maxAngle, std::atan2(t[i - 1].cross(t[i]).norm(), t[i - 1].dot(t[i])));
+        result.at(linkage.originalSegmentIndex(si)) = maxAngle;
+    });
+    return result;
+}
+
+// Per-segment subdivisions for which the turning angles are predicted to
+// satisfy `opts`, assuming they scale inversely with the number of edges.
+// Segments above the target are refined to reach it; those below half the
+// target are coarsened to half the target (leaving a band of hysteresis so
+// that repeated adaptation does not oscillate).
+inline std::vector<size_t> adaptedSubdivisions(const RodLinkage &linkage, const AdaptiveSubdivisionOptions &opts = AdaptiveSubdivisionOptions()) {
+    if (opts.targetTurningAngle <= 0) throw std::runtime_error("targetTurningAngle must be positive");
+    const size_t minSubdivision = std::max<size_t>(opts.minSubdivision, 7);
+    if (opts.maxSubdivision < minSubdivision) throw std::runtime_error("maxSubdivision must be at least minSubdivision");
+
+    std::vector<size_t> result = segmentSubdivisions(linkage);
+    const std::vector<Real> angles = segmentTurningAngles(linkage);
+    for (size_t i = 0; i < result.size(); ++i) {
+        Real predicted = result[i];
+        if      (angles[i] > opts.targetTurningAngle)                              predicted *= angles[i] / opts.targetTurningAngle;
+        else if (opts.allowCoarsening && (angles[i] < 0.5 * opts.targetTurningAngle)) predicted *= angles[i] / (0.5 * opts.targetTurningAngle);
+        else continue;
+        result[i] = std::min(std::max(size_t(std::ceil(predicted)), minSubdivision), opts.maxSubdivision);
+    }
+    return result;
+}
+
+// Throw if `linkage` has data that cannot be transferred to a
+// re-discretization built from the straight edges of its line graph:
+// per-joint materials, stiffened regions or nonzero rest curvatures.
+inline void checkResubdivisible(const RodLinkage &linkage) {
+    const RodMaterial &mat = linkage.homogenousMaterial();
+    for (const auto &s : linkage.segments()) {
+        const auto &r = s.rod;
+        bool homogeneous = (r.edgeMaterials().size() == 1);
+        for (Real k : r.stretchingStiffnesses()) homogeneous = homogeneous && (k == mat.stretchingStiffness);
+        for (Real k : r.twistingStiffnesses())   homogeneous = homogeneous && (k == mat.twistingStiffness);
+        for (const auto &k : r.bendingStiffnesses())
+            homogeneous = homogeneous && (k.lambda_1 == mat.bendingStiffness.lambda_1) && (k.lambda_2 == mat.bendingStiffness.lambda_2);
+        if (!homogeneous) throw std::runtime_error("Only linkages with a homogeneous material (no joint materials or stiffened regions) can be re-discretized");
+    }
+    const auto restKappa = linkage.getRestKappaVars();
+    if ((restKappa.size() > 0) && (restKappa.cwiseAbs().maxCoeff() > 1e-10))
+        throw std::runtime_error("Only linkages with straight rest segments (zero rest curvature) can be re-discretized");
+}
+
+// Rebuild `linkage` from its line graph (`vertices`, `edges` in any format
+// accepted by RodLinkage::set) with per-edge subdivisions `subdivisions`.
+// The homogeneous material, per-segment rest lengths and deformed state are
+// transferred, and the new linkage is renumbered if `linkage` was (see
+// RodLinkage::reorderForLocality). Linkages with per-joint materials,
+// stiffened regions or rest curvature design parameters are rejected (see
+// checkResubdivisible), since these would be lost.
+template<class Vertices, class Edges>
+std::unique_ptr<RodLinkage> resubdivided(const RodLinkage &linkage, const Vertices &vertices, const Edges &edges,
+                                         const std::vector<size_t> &subdivisions,
+                                         const AdaptiveSubdivisionOptions &opts = AdaptiveSubdivisionOptions()) {
+    checkResubdivisible(linkage);
+    auto result = std::make_unique<RodLinkage>(vertices, edges, subdivisions, opts.consistentAngle, opts.interleavingType);
+    if (!linkage.originalSegmentIndices().empty()) result->reorderForLocality();
+    result->setMaterial(linkage.homogenousMaterial());
+
+    // Per-segment rest lengths measure the distance between the joint pivots
+    // and are therefore independent of the discretization.
+    const auto oldSegment = multilevel_detail::segmentCorrespondence(linkage, *result);
+    const auto oldPSRL = linkage.getPerSegmentRestLength();
+    RodLinkage::VecX psrl(result->numSegments());
+    for (size_t si = 0; si < result->numSegments(); ++si) psrl[si] = oldPSRL[oldSegment[si]];
+    result->setPerSegmentRestLength(psrl);
+
+    prolongateDeformedState(linkage, *result);
+    return result;
+}
+
+// Solve for the equilibrium of `linkage`, alternately re-discretizing it
+// with adaptedSubdivisions and re-solving (warm started from the transferred
+// previous equilibrium) until the discretization stops changing or
+// `aopts.maxPasses` re-discretizations have been done. `linkage` is replaced
+// with the final discretization, so it must satisfy checkResubdivisible;
+// `fixedVars` may only contain joint variables. Returns the report of the
+// last solve.
+template<class Vertices, class Edges>
+ConvergenceReport compute_equilibrium_adaptive(RodLinkage &linkage, const Vertices &vertices, const Edges &edges, Real targetAverageAngle,
+                                               const NewtonOptimizerOptions &opts = NewtonOptimizerOptions(),
+                                               const AdaptiveSubdivisionOptions &aopts = AdaptiveSubdivisionOptions(),
+                                               const std::vector<size_t> &fixedVars = std::vector<size_t>(),
+                                               CallbackFunction customCallback = nullptr) {
+    checkResubdivisible(linkage);
+    std::vector<size_t> currentFixedVars = fixedVars;
+    ConvergenceReport report = compute_equilibrium(linkage, targetAverageAngle, opts, currentFixedVars, customCallback);
+    for (size_t pass = 0; (pass < aopts.maxPasses) && !report.cancelled; ++pass) {
+        const auto subdivisions = adaptedSubdivisions(linkage, aopts);
+        if (subdivisions == segmentSubdivisions(linkage)) break;
+
+        auto adapted = resubdivided(linkage, vertices, edges, subdivisions, aopts);
+        currentFixedVars = transferJointVars(linkage, *adapted, currentFixedVars);
+        linkage.set(*adapted);
+        report = compute_equilibrium(linkage, targetAverageAngle, opts, currentFixedVars, customCallback);
+    }
+    return report;
+}
+
+#endif /* end of include guard: ADAPTIVE_SUBDIVISION_HH */
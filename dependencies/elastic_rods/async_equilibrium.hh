@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////////////////
+// async_equilibrium.hh
+////////////////////////////////////////////////////////////////////////////////
+/*! @file
+//  Equilibrium solves running on a background thread. A job copies the
+//  linkage when it is started and solves the copy, so the caller can keep
+//  using (e.g., visualizing or editing) the original while the solve runs;
+//  `publish` then copies the solved equilibrium back in a single call. Since
+//  each job owns its snapshot, several jobs can run at the same time.
+*/
+////////////////////////////////////////////////////////////////////////////////
+#ifndef ASYNC_EQUILIBRIUM_HH
+#define ASYNC_EQUILIBRIUM_HH
+
+#include "compute_equilibrium.hh"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Type-independent part of a job: completion, cancellation and results.
+class AsyncEquilibriumSolveBase {
+public:
+    AsyncEquilibriumSolveBase() = default;
+    AsyncEquilibriumSolveBase(const AsyncEquilibriumSolveBase &) = delete;
+    AsyncEquilibriumSolveBase &operator=(const AsyncEquilibriumSolveBase &) = delete;
+
+    virtual ~AsyncEquilibriumSolveBase() {
+        cancel();
+        m_join();
+    }
+
+    bool finished() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_finished;
+    }
+
+    // Block until the solve finishes or `timeoutSeconds` have elapsed
+    // (negative: no time limit). Returns whether the solve has finished.
+    bool wait(double timeoutSeconds = -1) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        auto isFinished = [this]() { return m_finished; };
+        if (timeoutSeconds < 0) m_cv.wait(lock, isFinished);
+        else m_cv.wait_for(lock, std::chrono::duration<double>(timeoutSeconds), isFinished);
+        return m_finished;
+    }
+
+    // Ask the solve to stop after its current iteration (the report is then
+    // flagged as cancelled).
+    void cancel() { m_cancelRequested = true; }
+
+    // Last completed iteration and its energy, for progress display.
+    size_t iteration() const { return m_iteration; }
+    Real energy() const { return m_energy; }
+
+    // Wait for the solve and return its report; an exception thrown by the
+    // solve is rethrown here.
+    const ConvergenceReport &report() {
+        wait();
+        if (m_error) std::rethrow_exception(m_error);
+        return m_report;
+    }
+
+    // Memory held by the job's linkage snapshot ("linkage.*") and solver
+    // ("solver.*"); waits for the solve to finish.
+    virtual MemoryReport memoryReport() = 0;
+
+protected:
+    // Run `solve` on the worker thread. Must be called at the end of the
+    // derived class's constructor.
+    void m_start(std::function<ConvergenceReport()> solve) {
+        m_thread = std::thread([this, solve]() {
+            ConvergenceReport report;
+            std::exception_ptr error;
+            try { report = solve(); }
+            catch (...) { error = std::current_exception(); }
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_report = std::move(report);
+                m_error = error;
+                m_finished = true;
+            }
+            m_cv.notify_all();
+        });
+    }
+
+    // Must be called by the derived class's destructor before the snapshot is destroyed.
+    void m_join() { if (m_thread.joinable()) m_thread.join(); }
+
+    // Chain the job's progress tracking and cancellation with the caller's callback.
+    NewtonProgressCallback m_progressCallback(NewtonProgressCallback callback) {
+        return [this, callback](const NewtonProgress &p) {
+            m_iteration = p.iteration;
+            m_energy    = p.energy;
+            bool stop = m_cancelRequested.load();
+            if (callback && callback(p)) stop = true;
+            return stop;
+        };
+    }
+
+private:
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_finished = false;
+    std::atomic<bool> m_cancelRequested{false};
+    std::atomic<size_t> m_iteration{0};
+    std::atomic<Real> m_energy{0.0};
+    ConvergenceReport m_report;
+    std::exception_ptr m_error;
+};
+
+// `Object` is RodLinkage or SurfaceAttractedLinkage. A `progressCallback` set
+// in `opts` is called on the worker thread.
+template<class Object>
+class AsyncEquilibriumSolve : public AsyncEquilibriumSolveBase {
+public:
+    AsyncEquilibriumSolve(const Object &obj, const NewtonOptimizerOptions &opts,
+                          const std::vector<size_t> &fixedVars = std::vector<size_t>(),
+                          const Eigen::VectorXd &externalForces = Eigen::VectorXd(),
+                          Real targetAverageAngle = TARGET_ANGLE_NONE)
+        : m_snapshot(obj)
+    {
+        auto problem = equilibrium_problem(m_snapshot, targetAverageAngle, fixedVars);
+        if (externalForces.size() > 0) problem->external_forces = externalForces;
+        m_optimizer = std::make_unique<NewtonOptimizer>(std::move(problem));
+        m_optimizer->options = opts;
+        m_optimizer->options.progressCallback = m_progressCallback(opts.progressCallback);
+        m_start([this]() { return m_optimizer->optimize(); });
+    }
+
+    ~AsyncEquilibriumSolve() {
+        cancel();
+        m_join();
+    }
+
+    // Wait for the solve and copy its equilibrium into `target`, which must
+    // have the same topology as the object the job was started from. The
+    // solve updates the joints' rotation parametrizations and the rods' source
+    // frames, so the full deformed state (not just the DoFs, which are
+    // relative to those frames) is transferred. Only deformed quantities are
+    // copied: the target's joint connectivity, rest state and design
+    // parameters are left untouched (the equilibrium is that of the design
+    // the job was started with).
+    void publish(Object &target) {
+        report();
+        if ((target.numJoints() != m_snapshot.numJoints()) || (target.numSegments() != m_snapshot.numSegments()) ||
+            (target.numDoF() != m_snapshot.numDoF()))
+            throw std::runtime_error("Target topology does not match the solved linkage");
+        for (size_t si = 0; si < target.numSegments(); ++si) {
+            const auto &ts = target.segment(si), &ss = m_snapshot.segment(si);
+            if ((ts.startJoint != ss.startJoint) || (ts.endJoint != ss.endJoint) || (ts.rod.numVertices() != ss.rod.numVertices()))
+                throw std::runtime_error("Target topology does not match the solved linkage");
+        }
+        for (size_t ji = 0; ji < target.numJoints(); ++ji) {
+            const auto &sj = m_snapshot.joint(ji);
+            auto &tj = target.joint(ji);
+            if ((tj.segmentsA() != sj.segmentsA()) || (tj.segmentsB() != sj.segmentsB()) ||
+                (tj.isStartA()  != sj.isStartA())  || (tj.isStartB()  != sj.isStartB()))
+                throw std::runtime_error("Target topology does not match the solved linkage");
+            typename Object::Joint::SerializedState state = tj.getState();
+            std::get<0>(state) = sj.pos();
+            std::get<1>(state) = sj.omega();
+            std::get<2>(state) = sj.alpha();
+            std::get<3>(state) = sj.len_A();
+            std::get<4>(state) = sj.len_B();
+            std::get<6>(state) = sj.source_tangent();
+            std::get<7>(state) = sj.source_normal();
+            tj = typename Object::Joint(state);
+            tj.updateLinkagePointer(&target);
+        }
+        for (size_t si = 0; si < target.numSegments(); ++si)
+            target.segment(si).rod.setDeformedConfiguration(m_snapshot.segment(si).rod.deformedConfiguration());
+        // Refresh everything derived from the DoFs (e.g., the closest points of a SurfaceAttractedLinkage).
+        target.setDoFs(m_snapshot.getDoFs());
+    }
+
+    // The solved copy (only to be accessed once the solve has finished).
+    const Object &snapshot() const { return m_snapshot; }
+
+    MemoryReport memoryReport() override {
+        wait();
+        MemoryReport result;
+        result.add("linkage", m_snapshot.memoryReport());
+        result.add("solver", m_optimizer->memoryReport());
+        return result;
+    }
+
+private:
+    Object m_snapshot;
+    std::unique_ptr<NewtonOptimizer> m_optimizer;
+};
+
+#endif /* end of include guard: ASYNC_EQUILIBRIUM_HH */
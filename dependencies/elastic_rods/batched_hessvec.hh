@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+// batched_hessvec.hh
+////////////////////////////////////////////////////////////////////////////////
+/*! @file
+//  Evaluate several Hessian-vector products (or directional derivatives of a
+//  Hessian-vector product) in a single pass over the linkage by propagating
+//  AD_BATCH_SIZE tangent directions at once with the ADRealBatch type.
+//  The geometric kernels (frames, curvature binormals, material frame
+//  transport...) are then evaluated once per batch instead of once per
+//  direction.
+*/
+////////////////////////////////////////////////////////////////////////////////
+#ifndef BATCHED_HESSVEC_HH
+#define BATCHED_HESSVEC_HH
+
+#include <MeshFEM/AutomaticDifferentiation.hh>
+#include <MeshFEM/GlobalBenchmark.hh>
+#include "RodLinkage.hh"
+
+// Apply the Hessian of the elastic energy of `obj` to each column of `V`
+// (one column per DoF direction) by differentiating the gradient of the
+// autodiff copy `diff_obj`. `diff_obj` must have been initialized from `obj`
+// (e.g., with `diff_obj.set(obj)`); its DoFs are overwritten.
+template<class Object, class ADObject>
+Eigen::MatrixXd applyHessianBatched(const Object &obj, ADObject &diff_obj, const Eigen::MatrixXd &V) {
+    PROFILE_SCOPE("applyHessianBatched");
+    constexpr int K = AD_BATCH_SIZE;
+    const Eigen::VectorXd x = obj.getDoFs();
+    if (V.rows() != x.size()) throw std::runtime_error("Direction size mismatch");
+
+    Eigen::MatrixXd result(V.rows(), V.cols());
+    for (int offset = 0; offset < V.cols(); offset += K) {
+        const int numDirs = std::min<int>(K, V.cols() - offset);
+        diff_obj.setDoFs(seedDirections<K>(x, V, offset));
+        result.middleCols(offset, numDirs) = extractDirectionalDerivatives<K>(diff_obj.gradient()).leftCols(numDirs);
+    }
+    return result;
+}
+
+// Compute the directional derivatives
+//      d/dt [H_PSRL(xp + t u_k) w]
+// of the per-segment-rest-length Hessian matvec with the fixed vector `w` for
+// each column `u_k` of `U` (extended PSRL DoF directions). This is the
+// third-derivative contraction needed by the design optimization Hessian
+// matvec; each batch of AD_BATCH_SIZE columns costs a single
+// `applyHessianPerSegmentRestlen` evaluation.
+template<class Object, class ADObject>
+Eigen::MatrixXd applyHessianPerSegmentRestlenDirectionalDerivativeBatched(const Object &obj, ADObject &diff_obj,
+                                                                          const Eigen::MatrixXd &U, const Eigen::VectorXd &w,
+                                                                          const HessianComputationMask &mask = HessianComputationMask()) {
+    PROFILE_SCOPE("applyHessianPerSegmentRestlenDirectionalDerivativeBatched");
+    constexpr int K = AD_BATCH_SIZE;
+    const Eigen::VectorXd xp = obj.getExtendedDoFsPSRL();
+    if ((U.rows() != xp.size()) || (w.size() != xp.size())) throw std::runtime_error("Direction size mismatch");
+
+    const VecX_T<ADRealK<K>> ad_w = w.template cast<ADRealK<K>>();
+    Eigen::MatrixXd result(U.rows(), U.cols());
+    for (int offset = 0; offset < U.cols(); offset += K) {
+        const int numDirs = std::min<int>(K, U.cols() - offset);
+        diff_obj.setExtendedDoFsPSRL(seedDirections<K>(xp, U, offset));
+        result.middleCols(offset, numDirs) = extractDirectionalDerivatives<K>(diff_obj.applyHessianPerSegmentRestlen(ad_w, mask)).leftCols(numDirs);
+    }
+    return result;
+}
+
+#endif /* end of include guard: BATCHED_HESSVEC_HH */
@@ -1,3 +1,6 @@
+# Kernel and solver timings over the bundled example linkages, written as JSON;
+# pass "-b baseline.json" to compare against a previous run (exit code 1 on a regression).
+# ../build/tools/benchmark_linkages -o results.json ../examples/cross_sections/Rectangle_16x8.json ../examples/*.obj
 # ../build/tools/open_linkage ../python/examples/optimized/data/simple_two_bumps_3/flat_opt.msh ../examples/cross_sections/Rectangle_16x8.json 1.6580627893946132 1e-6 1e-4 0.06 > simple_two_bumps.txt
 #       opt timing from ../build/final_simple_two_bumps_ncg.txt; ./linkage_editor/linkage_editor ~/Downloads/20190108_164134_meshID_1d1c1dc9-4638-474e-8f7f-6b95998b8a32.obj ../examples/cross_sections/Rectangle_16x8.json > final_simple_two_bumps_ncg.txt
 # ../build/tools/open_linkage ../examples/AsymmOverhanging2BumpsArchitecturalScale.obj ../examples/cross_sections/190108_section_test_R01.obj 1.6231562043547265 2 1e-1 0.13 > asymm_overhanging_2_bumps.txt
@@ -0,0 +1,275 @@
+////////////////////////////////////////////////////////////////////////////////
+// bound_constrained_optimizer.hh
+////////////////////////////////////////////////////////////////////////////////
+/*! @file
+//  Open-source bound-constrained solvers for the design optimization problems
+//  (used when Knitro is unavailable or a native algorithm is requested):
+//   - L-BFGS-B: a projected limited-memory BFGS method with Armijo
+//     backtracking along the projected search path. The history size and
+//     line search parameters are taken from LBFGSpp's `LBFGSParam`.
+//   - Trust-region Newton-CG: a projected trust-region method whose steps are
+//     computed with Steihaug's truncated CG on the free variables using exact
+//     Hessian-vector products.
+//
+//  Both solvers work with any problem exposing:
+//      size_t          numVars();
+//      Real            eval      (const Eigen::VectorXd &x);
+//      Eigen::VectorXd grad      (const Eigen::VectorXd &x);
+//      Eigen::VectorXd apply_hess(const Eigen::VectorXd &x, const Eigen::VectorXd &delta_x); // (Newton-CG only)
+//      void            newPt     (const Eigen::VectorXd &x);
+//  The objective is always evaluated at a point before its gradient and
+//  Hessian-vector products are requested there (after a rejected
+//  trust-region step, the current iterate is re-evaluated before the next
+//  Hessian-vector products), and `newPt` is called once per
+//  accepted iterate (like Knitro's new point callback). This lets the
+//  problem reuse its warm-started equilibria and cached adjoint
+//  factorizations between evaluations.
+*/
+////////////////////////////////////////////////////////////////////////////////
+#ifndef BOUND_CONSTRAINED_OPTIMIZER_HH
+#define BOUND_CONSTRAINED_OPTIMIZER_HH
+
+#include <MeshFEM/Types.hh>
+#include <MeshFEM/GlobalBenchmark.hh>
+#include <LBFGS/Param.h>
+
+#include <deque>
+#include <limits>
+#include <iostream>
+#include <functional>
+
+// Status codes follow Knitro's convention that 0 indicates success.
+enum class BoundConstrainedStatus : int { CONVERGED = 0, MAX_ITERATIONS = 1, STEP_FAILURE = 2, USER_TERMINATION = 3 };
+
+struct BoundConstrainedOptimizerOptions {
+    size_t niter = 100;
+    Real gradTol = 1e-6;                  // tolerance on the infinity norm of the projected gradient
+    Real trustRegionRadius = 1.0;         // initial trust region radius (Newton-CG)
+    Real maxTrustRegionRadius = 1e6;
+    size_t cgMaxIter = 0;                 // maximum Steihaug CG iterations per step (0 ==> number of variables)
+    LBFGSpp::LBFGSParam<Real> lbfgs;      // history size `m`, Armijo `ftol`, `max_linesearch` and `min_step` (L-BFGS-B)
+    int verbose = 1;
+};
+
+namespace bound_constrained {
+
+inline Eigen::VectorXd project(const Eigen::VectorXd &x, const Eigen::VectorXd &lb, const Eigen::VectorXd &ub) {
+    return x.cwiseMax(lb).cwiseMin(ub);
+}
+
+// Infinity norm of the projected gradient step x - P(x - g): zero at a
+// first-order critical point of the bound-constrained problem.
+inline Real projectedGradientNorm(const Eigen::VectorXd &x, const Eigen::VectorXd &g, const Eigen::VectorXd &lb, const Eigen::VectorXd &ub) {
+    return (project(x - g, lb, ub) - x).lpNorm<Eigen::Infinity>();
+}
+
+// Indicator (1.0 or 0.0) of the variables that are not held at a bound by the
+// gradient, i.e., whose steepest descent direction points into the box.
+inline Eigen::VectorXd freeVariables(const Eigen::VectorXd &x, const Eigen::VectorXd &g, const Eigen::VectorXd &lb, const Eigen::VectorXd &ub) {
+    Eigen::VectorXd result(x.size());
+    for (int i = 0; i < x.size(); ++i) {
+        const bool active = ((x[i] <= lb[i]) && (g[i] > 0)) || ((x[i] >= ub[i]) && (g[i] < 0));
+        result[i] = active ? 0.0 : 1.0;
+    }
+    return result;
+}
+
+inline void reportIteration(const BoundConstrainedOptimizerOptions &opts, const char *name, size_t it, Real f, Real pgNorm, Real stepSize) {
+    if (opts.verbose <= 0) return;
+    std::cout << name << " iteration " << it << "\tJ: " << f << "\tprojected gradient norm: " << pgNorm << "\tstep: " << stepSize << std::endl;
+}
+
+}
+
+// Minimize `problem` subject to lb <= x <= ub with a projected L-BFGS method.
+// `x` holds the initial guess and is overwritten with the final iterate.
+// `callback` is invoked (with the iteration index) after each accepted step;
+// returning `true` stops the optimization with status USER_TERMINATION.
+template<class Problem>
+BoundConstrainedStatus lbfgsb_optimize(Problem &problem, Eigen::VectorXd &x,
+                                       const Eigen::VectorXd &lb, const Eigen::VectorXd &ub,
+                                       const BoundConstrainedOptimizerOptions &opts,
+                                       const std::function<bool(size_t)> &callback = [](size_t) { return false; }) {
+    using namespace bound_constrained;
+    PROFILE_SCOPE("lbfgsb_optimize");
+    const auto &param = opts.lbfgs;
+    param.check_param();
+    if ((lb.size() != x.size()) || (ub.size() != x.size())) throw std::runtime_error("Bound size mismatch");
+
+    x = project(x, lb, ub);
+    Real f = problem.eval(x);
+    Eigen::VectorXd g = problem.grad(x);
+
+    std::deque<Eigen::VectorXd> S, Y;
+    std::deque<Real> rho;
+    Real stepSize = 0;
+
+    size_t it = 0;
+    while (true) {
+        const Real pgNorm = projectedGradientNorm(x, g, lb, ub);
+        reportIteration(opts, "L-BFGS-B", it, f, pgNorm, stepSize);
+        if (pgNorm < opts.gradTol) return BoundConstrainedStatus::CONVERGED;
+        if (it == opts.niter)      return BoundConstrainedStatus::MAX_ITERATIONS;
+
+        // Two-loop recursion for the quasi-Newton direction, restricted
+        // afterward to the variables not held at their bounds.
+        const Eigen::VectorXd free = freeVariables(x, g, lb, ub);
+        Eigen::VectorXd d = g;
+        {
+            std::vector<Real> a(S.size());
+            for (int i = int(S.size()) - 1; i >= 0; --i) {
+                a[i] = rho[i] * S[i].dot(d);
+                d -= a[i] * Y[i];
+            }
+            if (!S.empty()) d *= S.back().dot(Y.back()) / Y.back().squaredNorm();
+            for (size_t i = 0; i < S.size(); ++i) {
+                const Real b = rho[i] * Y[i].dot(d);
+                d += (a[i] - b) * S[i];
+            }
+        }
+        d = -d.cwiseProduct(free);
+        if (!(d.dot(g) < 0)) {
+            // The projected quasi-Newton direction is not a descent direction; restart from steepest descent.
+            S.clear(), Y.clear(), rho.clear();
+            d = -g.cwiseProduct(free);
+        }
+
+        // Armijo backtracking along the projected path P(x + alpha d).
+        // Without curvature information, the first trial step has unit length.
+        Real alpha = S.empty() ? std::min<Real>(1.0, 1.0 / d.norm()) : 1.0;
+        Eigen::VectorXd x_new;
+        Real f_new = f;
+        bool accepted = false;
+        for (int ls = 0; ls < param.max_linesearch; ++ls) {
+            x_new = project(x + alpha * d, lb, ub);
+            f_new = problem.eval(x_new);
+            if (f_new <= f + param.ftol * g.dot(x_new - x)) { accepted = true; break; }
+            alpha *= 0.5;
+            if (alpha < param.min_step) break;
+        }
+        if (!accepted) {
+            if (S.empty()) return BoundConstrainedStatus::STEP_FAILURE;
+            if (opts.verbose > 0) std::cout << "Line search failed; discarding the L-BFGS history" << std::endl;
+            S.clear(), Y.clear(), rho.clear();
+            continue;
+        }
+
+        Eigen::VectorXd g_new = problem.grad(x_new);
+        Eigen::VectorXd s = x_new - x, y = g_new - g;
+        const Real sy = s.dot(y);
+        if (sy > std::numeric_limits<Real>::epsilon() * y.squaredNorm()) {
+            S.push_back(s), Y.push_back(y), rho.push_back(1.0 / sy);
+            if (S.size() > size_t(param.m)) S.pop_front(), Y.pop_front(), rho.pop_front();
+        }
+
+        stepSize = s.norm();
+        x = x_new;
+        f = f_new;
+        g = g_new;
+        problem.newPt(x);
+        if (callback(it)) return BoundConstrainedStatus::USER_TERMINATION;
+        ++it;
+    }
+}
+
+// Minimize `problem` subject to lb <= x <= ub with a projected trust-region
+// Newton-CG method. Each step is computed by Steihaug's truncated CG on the
+// variables that are not held at their bounds and then projected onto the box.
+// `x` holds the initial guess and is overwritten with the final iterate.
+// `callback` is invoked (with the iteration index) after each accepted step;
+// returning `true` stops the optimization with status USER_TERMINATION.
+template<class Problem>
+BoundConstrainedStatus trust_region_newton_cg_optimize(Problem &problem, Eigen::VectorXd &x,
+                                                       const Eigen::VectorXd &lb, const Eigen::VectorXd &ub,
+                                                       const BoundConstrainedOptimizerOptions &opts,
+                                                       const std::function<bool(size_t)> &callback = [](size_t) { return false; }) {
+    using namespace bound_constrained;
+    PROFILE_SCOPE("trust_region_newton_cg_optimize");
+    if ((lb.size() != x.size()) || (ub.size() != x.size())) throw std::runtime_error("Bound size mismatch");
+    const Real acceptanceRatio = 1e-4;
+
+    x = project(x, lb, ub);
+    Real f = problem.eval(x);
+    Eigen::VectorXd g = problem.grad(x);
+    Real radius = opts.trustRegionRadius;
+    Real stepSize = 0;
+
+    size_t it = 0;
+    while (true) {
+        const Real pgNorm = projectedGradientNorm(x, g, lb, ub);
+        reportIteration(opts, "Trust-region Newton-CG", it, f, pgNorm, stepSize);
+        if (pgNorm < opts.gradTol) return BoundConstrainedStatus::CONVERGED;
+        if (it == opts.niter)      return BoundConstrainedStatus::MAX_ITERATIONS;
+
+        const Eigen::VectorXd free = freeVariables(x, g, lb, ub);
+        auto applyReducedHessian = [&](const Eigen::VectorXd &v) -> Eigen::VectorXd {
+            return problem.apply_hess(x, v).cwiseProduct(free);
+        };
+
+        // Steihaug CG for min_p g_F.p + 1/2 p.H_FF p subject to ||p|| <= radius.
+        // We also track H p so the model reduction needs no extra Hessian application.
+        const Eigen::VectorXd gF = g.cwiseProduct(free);
+        const Real gFNorm = gF.norm();
+        const Real cgTol = std::min<Real>(0.5, std::sqrt(gFNorm)) * gFNorm;
+        const size_t cgMaxIter = (opts.cgMaxIter == 0) ? size_t(x.size()) : opts.cgMaxIter;
+
+        Eigen::VectorXd p = Eigen::VectorXd::Zero(x.size()), Hp = Eigen::VectorXd::Zero(x.size());
+        Eigen::VectorXd r = gF, d = -gF;
+        auto toBoundary = [&](const Eigen::VectorXd &dir, const Eigen::VectorXd &Hdir) {
+            // Largest tau >= 0 with ||p + tau dir|| = radius
+            const Real a = dir.squaredNorm(), b = 2 * p.dot(dir), c = p.squaredNorm() - radius * radius;
+            const Real tau = (-b + std::sqrt(std::max<Real>(b * b - 4 * a * c, 0.0))) / (2 * a);
+            p  += tau * dir;
+            Hp += tau * Hdir;
+        };
+        for (size_t k = 0; k < cgMaxIter; ++k) {
+            const Eigen::VectorXd Hd = applyReducedHessian(d);
+            const Real dHd = d.dot(Hd);
+            if (dHd <= 0) { toBoundary(d, Hd); break; } // negative curvature: follow it to the trust region boundary
+            const Real rr = r.squaredNorm();
+            const Real cg_alpha = rr / dHd;
+            if ((p + cg_alpha * d).norm() >= radius) { toBoundary(d, Hd); break; }
+            p  += cg_alpha * d;
+            Hp += cg_alpha * Hd;
+            r  += cg_alpha * Hd;
+            if (r.norm() < cgTol) break;
+            d = -r + (r.squaredNorm() / rr) * d;
+        }
+
+        // Project the step onto the feasible box and evaluate the model
+        // reduction for the step actually taken.
+        const Eigen::VectorXd x_trial = project(x + p, lb, ub);
+        const Eigen::VectorXd s = x_trial - x;
+        Eigen::VectorXd Hs = Hp;
+        if ((s - p).squaredNorm() > 0) Hs = problem.apply_hess(x, s);
+        const Real predicted = -(g.dot(s) + 0.5 * s.dot(Hs));
+
+        const Real f_trial = problem.eval(x_trial);
+        const Real ratio = (predicted > 0) ? (f - f_trial) / predicted : -1.0;
+
+        if (ratio < 0.25)                                      radius = 0.25 * s.norm();
+        else if ((ratio > 0.75) && (p.norm() >= 0.99 * radius)) radius = std::min(2 * radius, opts.maxTrustRegionRadius);
+
+        if (ratio > acceptanceRatio) {
+            stepSize = s.norm();
+            x = x_trial;
+            f = f_trial;
+            g = problem.grad(x);
+            problem.newPt(x);
+            if (callback(it)) return BoundConstrainedStatus::USER_TERMINATION;
+            ++it;
+        }
+        else {
+            if (radius < std::numeric_limits<Real>::epsilon() * std::max<Real>(1.0, x.norm()))
+                return BoundConstrainedStatus::STEP_FAILURE;
+            if (opts.verbose > 0)
+                std::cout << "Rejected step (reduction ratio " << ratio << "); shrinking trust region radius to " << radius << std::endl;
+            // The problem was last evaluated at the rejected trial point;
+            // return it to the current iterate before the next Hessian-vector
+            // products are requested.
+            problem.eval(x);
+        }
+    }
+}
+
+#endif /* end of include guard: BOUND_CONSTRAINED_OPTIMIZER_HH */
@@ -68,7 +68,7 @@ private:
 };
 
 Eigen::VectorXd negativeCurvatureDirection(CholmodFactorizer &Hshift_inv, const SuiteSparseMatrix &M, Real tol) {
-    BENCHMARK_SCOPED_TIMER_SECTION timer("negativeCurvatureDirection");
+    PROFILE_SCOPE("negativeCurvatureDirection");
     if (Hshift_inv.m() != size_t(M.m)) throw std::runtime_error("Argument matrices Hshift_inv and M must be the same size");
 
     std::unique_ptr<CholmodFactorizer> M_LLt;
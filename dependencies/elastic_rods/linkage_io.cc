@@ -0,0 +1,658 @@
+#include "linkage_io.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace {
+
+constexpr char MAGIC[8] = {'E', 'R', 'O', 'D', 'B', 'I', 'N', '\0'};
+
+// Reject sizes that cannot come from a valid file before allocating for them.
+constexpr uint64_t MAX_ENTRIES = uint64_t(1) << 40;
+
+using Kind = LinkageBinaryIO::Kind;
+
+struct BinaryWriter {
+    BinaryWriter(std::ostream &os) : m_os(os) { }
+
+    template<typename T>
+    void pod(const T &val) { m_os.write(reinterpret_cast<const char *>(&val), sizeof(T)); }
+
+    void size(size_t n) { pod(uint64_t(n)); }
+    void real(Real val) { pod(double(val)); }
+
+    template<typename T>
+    void raw(const T *data, size_t n) { m_os.write(reinterpret_cast<const char *>(data), n * sizeof(T)); }
+
+    void string(const std::string &s) { size(s.size()); raw(s.data(), s.size()); }
+
+    void vec3(const Eigen::Vector3d &v) { real(v[0]); real(v[1]); real(v[2]); }
+
+    void reals(const std::vector<Real> &v) { size(v.size()); raw(v.data(), v.size()); }
+
+    // Dense Eigen matrices are written column-major with their dimensions.
+    template<class Mat>
+    void matrix(const Mat &m) {
+        size(m.rows()); size(m.cols());
+        raw(m.data(), m.size());
+    }
+
+    template<class Container, class F>
+    void sequence(const Container &c, F &&writeItem) {
+        size(c.size());
+        for (const auto &item : c) writeItem(item);
+    }
+
+    void header(Kind kind) {
+        raw(MAGIC, sizeof(MAGIC));
+        pod(LinkageBinaryIO::VERSION);
+        pod(uint32_t(kind));
+    }
+
+    void finish() {
+        if (!m_os) throw std::runtime_error("Failed to write linkage binary data");
+    }
+
+private:
+    std::ostream &m_os;
+};
+
+struct BinaryReader {
+    BinaryReader(std::istream &is) : m_is(is) { }
+
+    template<typename T>
+    T pod() {
+        T val;
+        raw(&val, 1);
+        return val;
+    }
+
+    size_t size() {
+        uint64_t n = pod<uint64_t>();
+        if (n > MAX_ENTRIES) throw std::runtime_error("Corrupt linkage binary data (invalid size)");
+        return n;
+    }
+
+    Real real() { return pod<double>(); }
+
+    template<typename T>
+    void raw(T *data, size_t n) {
+        m_is.read(reinterpret_cast<char *>(data), n * sizeof(T));
+        if (!m_is) throw std::runtime_error("Truncated linkage binary data");
+    }
+
+    std::string string() {
+        std::string s(size(), '\0');
+        raw(&s[0], s.size());
+        return s;
+    }
+
+    Eigen::Vector3d vec3() {
+        Eigen::Vector3d v;
+        v[0] = real(); v[1] = real(); v[2] = real();
+        return v;
+    }
+
+    std::vector<Real> reals() {
+        std::vector<Real> v(size());
+        raw(v.data(), v.size());
+        return v;
+    }
+
+    template<class Mat>
+    void matrix(Mat &m) {
+        const size_t rows = size(), cols = size();
+        if (((Mat::RowsAtCompileTime != Eigen::Dynamic) && (rows != size_t(Mat::RowsAtCompileTime))) ||
+            ((Mat::ColsAtCompileTime != Eigen::Dynamic) && (cols != size_t(Mat::ColsAtCompileTime))))
+            throw std::runtime_error("Corrupt linkage binary data (matrix dimension mismatch)");
+        m.resize(rows, cols);
+        raw(m.data(), m.size());
+    }
+
+    template<class Container, class F>
+    void sequence(Container &c, F &&readItem) {
+        const size_t n = size();
+        c.clear();
+        c.reserve(n);
+        for (size_t i = 0; i < n; ++i) readItem(c);
+    }
+
+    // Returns the kind of object stored; throws if the data is not in our format
+    // or was written by a newer version.
+    Kind header() {
+        char magic[sizeof(MAGIC)];
+        raw(magic, sizeof(MAGIC));
+        if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) throw std::runtime_error("Not a linkage binary file");
+        const uint32_t version = pod<uint32_t>();
+        if ((version == 0) || (version > LinkageBinaryIO::VERSION))
+            throw std::runtime_error("Unsupported linkage binary version " + std::to_string(version));
+        m_version = version;
+        const uint32_t kind = pod<uint32_t>();
+        if (kind > uint32_t(Kind::PeriodicRod)) throw std::runtime_error("Unknown object kind in linkage binary data");
+        return Kind(kind);
+    }
+
+    void expectHeader(Kind expected) {
+        if (header() != expected) throw std::runtime_error("Linkage binary data holds a different kind of object");
+    }
+
+    // Format version of the data being read (set by `header`).
+    uint32_t version() const { return m_version; }
+
+private:
+    std::istream &m_is;
+    uint32_t m_version = LinkageBinaryIO::VERSION;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Materials
+////////////////////////////////////////////////////////////////////////////////
+void writeMaterial(BinaryWriter &w, const RodMaterial &mat) {
+    w.real(mat.area);
+    w.real(mat.stretchingStiffness);
+    w.real(mat.twistingStiffness);
+    w.real(mat.bendingStiffness.lambda_1); w.real(mat.bendingStiffness.lambda_2);
+    w.real(mat.momentOfInertia .lambda_1); w.real(mat.momentOfInertia .lambda_2);
+    w.real(mat.torsionStressCoefficient);
+    w.real(mat.youngModulus);
+    w.real(mat.shearModulus);
+    w.real(mat.crossSectionHeight);
+
+    auto writePoints = [&](const CrossSection::AlignedPointCollection &pts) { w.sequence(pts, [&](const Point2D &p) { w.real(p[0]); w.real(p[1]); }); };
+    auto writeEdges  = [&](const CrossSection::EdgeCollection         &es ) { w.sequence(es,  [&](const CrossSection::Edge &e) { w.size(e.first); w.size(e.second); }); };
+    writePoints(mat.crossSectionBoundaryPts);
+    writeEdges (mat.crossSectionBoundaryEdges);
+
+    const auto csa = mat.stressAnalysisPtr();
+    w.pod(uint8_t(csa != nullptr));
+    if (csa) {
+        writePoints(csa->boundaryV);
+        writeEdges (csa->boundaryE);
+        w.matrix(csa->unitTwistShearStrain);
+        w.real(csa->youngModulus);
+        w.real(csa->shearModulus);
+    }
+}
+
+RodMaterial readMaterial(BinaryReader &r) {
+    RodMaterial mat;
+    mat.area                     = r.real();
+    mat.stretchingStiffness      = r.real();
+    mat.twistingStiffness        = r.real();
+    mat.bendingStiffness.lambda_1 = r.real(); mat.bendingStiffness.lambda_2 = r.real();
+    mat.momentOfInertia .lambda_1 = r.real(); mat.momentOfInertia .lambda_2 = r.real();
+    mat.torsionStressCoefficient = r.real();
+    mat.youngModulus             = r.real();
+    mat.shearModulus             = r.real();
+    mat.crossSectionHeight       = r.real();
+
+    auto readPoints = [&](CrossSection::AlignedPointCollection &pts) { r.sequence(pts, [&](CrossSection::AlignedPointCollection &c) { Real x = r.real(); c.emplace_back(x, r.real()); }); };
+    auto readEdges  = [&](CrossSection::EdgeCollection         &es ) { r.sequence(es,  [&](CrossSection::EdgeCollection &c) { size_t a = r.size(); c.emplace_back(a, r.size()); }); };
+    auto validEdges = [](const CrossSection::EdgeCollection &es, size_t numPoints) {
+        return std::all_of(es.begin(), es.end(), [numPoints](const CrossSection::Edge &e) { return (e.first < numPoints) && (e.second < numPoints); });
+    };
+    readPoints(mat.crossSectionBoundaryPts);
+    readEdges (mat.crossSectionBoundaryEdges);
+    if (!validEdges(mat.crossSectionBoundaryEdges, mat.crossSectionBoundaryPts.size()))
+        throw std::runtime_error("Corrupt linkage binary data (invalid cross-section boundary edge)");
+
+    if (r.pod<uint8_t>()) {
+        CrossSection::AlignedPointCollection bV;
+        CrossSection::EdgeCollection bE;
+        Eigen::MatrixX2d unitTwistShearStrain;
+        readPoints(bV);
+        readEdges(bE);
+        r.matrix(unitTwistShearStrain);
+        if (!validEdges(bE, bV.size()) || (size_t(unitTwistShearStrain.rows()) != bV.size()))
+            throw std::runtime_error("Corrupt linkage binary data (invalid stress analysis boundary)");
+        const Real E = r.real();
+        const Real G = r.real();
+        mat.setStressAnalysisPtr(std::make_shared<CrossSectionStressAnalysis>(bV, bE, unitTwistShearStrain, E, G));
+    }
+    return mat;
+}
+
+// Materials are typically shared by all edges of a rod (and often by all
+// rods), so each distinct material is stored once and referenced by index.
+// Materials are compared by their serialized representation.
+struct MaterialTable {
+    uint32_t add(const RodMaterial &mat) {
+        std::ostringstream os(std::ios::binary);
+        BinaryWriter w(os);
+        writeMaterial(w, mat);
+        std::string data = os.str();
+        auto it = m_index.find(data);
+        if (it != m_index.end()) return it->second;
+        const uint32_t id = m_entries.size();
+        m_index.emplace(data, id);
+        m_entries.push_back(std::move(data));
+        return id;
+    }
+
+    std::vector<uint32_t> add(const std::vector<RodMaterial> &mats) {
+        std::vector<uint32_t> ids;
+        ids.reserve(mats.size());
+        for (const auto &mat : mats) ids.push_back(add(mat));
+        return ids;
+    }
+
+    void write(BinaryWriter &w) const {
+        w.size(m_entries.size());
+        for (const auto &data : m_entries) w.raw(data.data(), data.size());
+    }
+
+    static std::vector<RodMaterial> read(BinaryReader &r) {
+        std::vector<RodMaterial> materials;
+        r.sequence(materials, [&](std::vector<RodMaterial> &c) { c.push_back(readMaterial(r)); });
+        return materials;
+    }
+
+private:
+    std::vector<std::string> m_entries;
+    std::map<std::string, uint32_t> m_index;
+};
+
+const RodMaterial &lookupMaterial(const std::vector<RodMaterial> &materials, uint32_t id) {
+    if (id >= materials.size()) throw std::runtime_error("Corrupt linkage binary data (invalid material index)");
+    return materials[id];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Rods
+// (The field order and the restoration sequence match the ElasticRod pickle.)
+////////////////////////////////////////////////////////////////////////////////
+void writeDirectors(BinaryWriter &w, const std::vector<ElasticRod::Directors> &d) {
+    w.sequence(d, [&](const ElasticRod::Directors &dir) { w.vec3(dir.d1); w.vec3(dir.d2); });
+}
+
+std::vector<ElasticRod::Directors> readDirectors(BinaryReader &r) {
+    std::vector<ElasticRod::Directors> d;
+    r.sequence(d, [&](std::vector<ElasticRod::Directors> &c) { Eigen::Vector3d d1 = r.vec3(); c.emplace_back(d1, r.vec3()); });
+    return d;
+}
+
+void writePoints(BinaryWriter &w, const std::vector<Point3D> &pts) {
+    w.sequence(pts, [&](const Point3D &p) { w.vec3(p); });
+}
+
+std::vector<Point3D> readPoints(BinaryReader &r) {
+    std::vector<Point3D> pts;
+    r.sequence(pts, [&](std::vector<Point3D> &c) { c.push_back(r.vec3()); });
+    return pts;
+}
+
+void writeRod(BinaryWriter &w, const ElasticRod &rod, const std::vector<uint32_t> &materialIds) {
+    writePoints(w, rod.restPoints());
+    writeDirectors(w, rod.restDirectors());
+    w.sequence(rod.restKappas(), [&](const Eigen::Vector2d &k) { w.real(k[0]); w.real(k[1]); });
+    w.reals(rod.restTwists());
+    w.reals(rod.restLengths());
+
+    w.sequence(materialIds, [&](uint32_t id) { w.pod(id); });
+
+    w.sequence(rod.bendingStiffnesses(), [&](const RodMaterial::BendingStiffness &b) { w.real(b.lambda_1); w.real(b.lambda_2); });
+    w.reals(rod.twistingStiffnesses());
+    w.reals(rod.stretchingStiffnesses());
+    w.pod(uint32_t(rod.bendingEnergyType()));
+
+    const auto &dc = rod.deformedConfiguration();
+    writePoints(w, dc.points());
+    w.reals(dc.thetas());
+    w.sequence(dc.sourceTangent, [&](const Eigen::Vector3d &t) { w.vec3(t); });
+    writeDirectors(w, dc.sourceReferenceDirectors);
+    w.reals(dc.sourceTheta);
+    w.reals(dc.sourceReferenceTwist);
+
+    w.reals(rod.densities());
+    w.real(rod.initialMinRestLength());
+}
+
+ElasticRod readRod(BinaryReader &r, const std::vector<RodMaterial> &materials) {
+    ElasticRod rod(readPoints(r));
+    const size_t nv = rod.numVertices(), ne = rod.numEdges();
+    auto expectSize = [](size_t size, size_t expected, const char *what) {
+        if (size != expected) throw std::runtime_error(std::string("Corrupt linkage binary data (") + what + " size mismatch)");
+    };
+
+    const auto restDirectors = readDirectors(r);
+    expectSize(restDirectors.size(), ne, "rest directors");
+    rod.setRestDirectors(restDirectors);
+    ElasticRod::StdVectorVector2D restKappas;
+    r.sequence(restKappas, [&](ElasticRod::StdVectorVector2D &c) { Real k0 = r.real(); c.emplace_back(k0, r.real()); });
+    expectSize(restKappas.size(), nv, "rest kappas");
+    rod.setRestKappas(restKappas);
+    const auto restTwists = r.reals();
+    expectSize(restTwists.size(), nv, "rest twists");
+    rod.setRestTwists(restTwists);
+    const auto restLengths = r.reals();
+    expectSize(restLengths.size(), ne, "rest lengths");
+    rod.setRestLengths(restLengths);
+
+    std::vector<uint32_t> materialIds;
+    r.sequence(materialIds, [&](std::vector<uint32_t> &c) { c.push_back(r.pod<uint32_t>()); });
+    if ((materialIds.size() != 1) && (materialIds.size() != ne))
+        throw std::runtime_error("Corrupt linkage binary data (invalid rod material count)");
+    std::vector<RodMaterial> edgeMaterials;
+    edgeMaterials.reserve(materialIds.size());
+    for (uint32_t id : materialIds) edgeMaterials.push_back(lookupMaterial(materials, id));
+    rod.setMaterial(edgeMaterials);
+
+    std::vector<RodMaterial::BendingStiffness> bendingStiffnesses;
+    r.sequence(bendingStiffnesses, [&](std::vector<RodMaterial::BendingStiffness> &c) { Real l1 = r.real(); c.push_back(RodMaterial::BendingStiffness{l1, r.real()}); });
+    expectSize(bendingStiffnesses.size(), nv, "bending stiffnesses");
+    rod.setBendingStiffnesses(bendingStiffnesses);
+    const auto twistingStiffnesses = r.reals();
+    expectSize(twistingStiffnesses.size(), nv, "twisting stiffnesses");
+    rod.setTwistingStiffnesses(twistingStiffnesses);
+    const auto stretchingStiffnesses = r.reals();
+    expectSize(stretchingStiffnesses.size(), ne, "stretching stiffnesses");
+    rod.setStretchingStiffnesses(stretchingStiffnesses);
+    const uint32_t bendingEnergyType = r.pod<uint32_t>();
+    if (bendingEnergyType > uint32_t(ElasticRod::BendingEnergyType::Bergou2008))
+        throw std::runtime_error("Corrupt linkage binary data (invalid bending energy type)");
+    rod.setBendingEnergyType(ElasticRod::BendingEnergyType(bendingEnergyType));
+
+    ElasticRod::DeformedState dc;
+    const auto points = readPoints(r);
+    const auto thetas = r.reals();
+    r.sequence(dc.sourceTangent, [&](std::vector<Eigen::Vector3d> &c) { c.push_back(r.vec3()); });
+    dc.sourceReferenceDirectors = readDirectors(r);
+    dc.sourceTheta              = r.reals();
+    dc.sourceReferenceTwist     = r.reals();
+    if ((points.size() != nv) || (thetas.size() != ne) ||
+        (dc.sourceTangent.size() != ne) || (dc.sourceReferenceDirectors.size() != ne) ||
+        (dc.sourceTheta.size() != ne) || (dc.sourceReferenceTwist.size() != nv))
+        throw std::runtime_error("Corrupt linkage binary data (deformed state size mismatch)");
+    dc.update(points, thetas);
+    rod.setDeformedConfiguration(dc);
+
+    const auto densities = r.reals();
+    expectSize(densities.size(), ne, "densities");
+    rod.setDensities(densities);
+    rod.setInitialMinRestLen(r.real());
+    return rod;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Linkages
+////////////////////////////////////////////////////////////////////////////////
+void writeJoint(BinaryWriter &w, const RodLinkage::Joint &joint) {
+    const auto s = joint.getState();
+    w.vec3(std::get<0>(s));
+    w.vec3(std::get<1>(s));
+    w.real(std::get<2>(s)); w.real(std::get<3>(s)); w.real(std::get<4>(s)); w.real(std::get<5>(s));
+    w.vec3(std::get<6>(s));
+    w.vec3(std::get<7>(s));
+    for (size_t si : std::get< 8>(s)) w.size(si);
+    for (size_t si : std::get< 9>(s)) w.size(si);
+    for (bool   b  : std::get<10>(s)) w.pod(uint8_t(b));
+    for (bool   b  : std::get<11>(s)) w.pod(uint8_t(b));
+    w.pod(int32_t(std::get<12>(s)));
+    for (int sgn : std::get<13>(s)) w.pod(int32_t(sgn));
+}
+
+// The segment indices are validated by readLinkage once the number of
+// segments is known.
+RodLinkage::Joint::SerializedState readJoint(BinaryReader &r) {
+    RodLinkage::Joint::SerializedState s;
+    std::get<0>(s) = r.vec3();
+    std::get<1>(s) = r.vec3();
+    std::get<2>(s) = r.real(); std::get<3>(s) = r.real(); std::get<4>(s) = r.real(); std::get<5>(s) = r.real();
+    std::get<6>(s) = r.vec3();
+    std::get<7>(s) = r.vec3();
+    for (size_t &si : std::get< 8>(s)) si = r.pod<uint64_t>(); // may hold RodLinkage::NONE
+    for (size_t &si : std::get< 9>(s)) si = r.pod<uint64_t>();
+    for (bool   &b  : std::get<10>(s)) b  = r.pod<uint8_t>();
+    for (bool   &b  : std::get<11>(s)) b  = r.pod<uint8_t>();
+    const int32_t type = r.pod<int32_t>();
+    if ((type < RodLinkage::Joint::B_OVER_A) || (type > RodLinkage::Joint::A_OVER_B))
+        throw std::runtime_error("Corrupt linkage binary data (invalid joint type)");
+    std::get<12>(s) = RodLinkage::Joint::Type(type);
+    for (int &sgn : std::get<13>(s)) {
+        sgn = r.pod<int32_t>();
+        if ((sgn != 1) && (sgn != -1)) throw std::runtime_error("Corrupt linkage binary data (invalid joint normal sign)");
+    }
+    return s;
+}
+
+void writeCSC(BinaryWriter &w, const SuiteSparseMatrix &A) {
+    w.pod(int64_t(A.m));
+    w.pod(int64_t(A.n));
+    w.pod(int64_t(A.nz));
+    w.pod(uint32_t(A.symmetry_mode));
+    w.sequence(A.Ap, [&](SuiteSparse_long v) { w.pod(int64_t(v)); });
+    w.sequence(A.Ai, [&](SuiteSparse_long v) { w.pod(int64_t(v)); });
+    w.sequence(A.Ax, [&](Real v) { w.real(v); });
+}
+
+SuiteSparseMatrix readCSC(BinaryReader &r) {
+    SuiteSparseMatrix A;
+    A.m  = r.pod<int64_t>();
+    A.n  = r.pod<int64_t>();
+    A.nz = r.pod<int64_t>();
+    A.symmetry_mode = SuiteSparseMatrix::SymmetryMode(r.pod<uint32_t>());
+    r.sequence(A.Ap, [&](std::vector<SuiteSparse_long> &c) { c.push_back(r.pod<int64_t>()); });
+    r.sequence(A.Ai, [&](std::vector<SuiteSparse_long> &c) { c.push_back(r.pod<int64_t>()); });
+    r.sequence(A.Ax, [&](SuiteSparseMatrix::container_type &c) { c.push_back(r.real()); });
+    if ((A.m < 0) || (A.n < 0) || (A.Ap.size() != size_t(A.n + 1)) || (A.Ai.size() != size_t(A.nz)) || (A.Ax.size() != size_t(A.nz)) ||
+        (uint32_t(A.symmetry_mode) > uint32_t(SuiteSparseMatrix::SymmetryMode::LOWER_TRIANGLE)) ||
+        (A.Ap.front() != 0) || (A.Ap.back() != A.nz) || !std::is_sorted(A.Ap.begin(), A.Ap.end()) ||
+        !std::all_of(A.Ai.begin(), A.Ai.end(), [&](SuiteSparse_long i) { return (i >= 0) && (i < A.m); }))
+        throw std::runtime_error("Corrupt linkage binary data (invalid sparse matrix)");
+    return A;
+}
+
+void writeLinkage(BinaryWriter &w, const RodLinkage &l) {
+    MaterialTable materials;
+    const uint32_t homogMatId = materials.add(l.homogenousMaterial());
+    std::vector<std::vector<uint32_t>> segmentMaterialIds;
+    segmentMaterialIds.reserve(l.numSegments());
+    for (const auto &s : l.segments()) segmentMaterialIds.push_back(materials.add(s.rod.edgeMaterials()));
+
+    materials.write(w);
+    w.pod(homogMatId);
+
+    w.sequence(l.joints(), [&](const RodLinkage::Joint &j) { writeJoint(w, j); });
+
+    w.size(l.numSegments());
+    for (size_t si = 0; si < l.numSegments(); ++si) {
+        const auto &s = l.segment(si);
+        w.size(s.startJoint);
+        w.size(s.endJoint);
+        writeRod(w, s.rod, segmentMaterialIds[si]);
+    }
+
+    w.real(l.initialMinRestLength());
+    writeCSC(w, l.segmentRestLenToEdgeRestLenMapTranspose());
+    w.matrix(l.getPerSegmentRestLength());
+    const auto &dpc = l.getDesignParameterConfig();
+    w.pod(uint8_t(dpc.restLen));
+    w.pod(uint8_t(dpc.restKappa));
+
+    // Version 2: original indices of a reordered linkage (see RodLinkage::reorderForLocality).
+    w.sequence(l.originalSegmentIndices(), [&](size_t i) { w.size(i); });
+    w.sequence(l.originalJointIndices(),   [&](size_t i) { w.size(i); });
+}
+
+// Everything needed to call RodLinkage::set without rebuilding the linkage.
+struct LinkageState {
+    std::vector<RodLinkage::Joint> joints;
+    std::vector<RodLinkage::RodSegment> segments;
+    RodMaterial homogMat;
+    Real initMinRL;
+    SuiteSparseMatrix segmentRestLenToEdgeRestLenMapTranspose;
+    Eigen::VectorXd perSegmentRestLen;
+    DesignParameterConfig dpc;
+    std::vector<size_t> originalSegmentIndex, originalJointIndex;
+};
+
+LinkageState readLinkage(BinaryReader &r) {
+    LinkageState st;
+    const auto materials = MaterialTable::read(r);
+    st.homogMat = lookupMaterial(materials, r.pod<uint32_t>());
+
+    std::vector<RodLinkage::Joint::SerializedState> jointStates;
+    r.sequence(jointStates, [&](std::vector<RodLinkage::Joint::SerializedState> &c) { c.push_back(readJoint(r)); });
+    const size_t numJoints = jointStates.size();
+
+    const size_t numSegments = r.size();
+    st.segments.reserve(numSegments);
+    for (size_t si = 0; si < numSegments; ++si) {
+        const size_t startJoint = r.pod<uint64_t>();
+        const size_t endJoint   = r.pod<uint64_t>();
+        if (((startJoint >= numJoints) && (startJoint != RodLinkage::NONE)) || ((endJoint >= numJoints) && (endJoint != RodLinkage::NONE)))
+            throw std::runtime_error("Corrupt linkage binary data (invalid segment joint index)");
+        st.segments.emplace_back(startJoint, endJoint, readRod(r, materials));
+    }
+
+    st.joints.reserve(numJoints);
+    for (const auto &s : jointStates) {
+        auto validSegment = [numSegments](size_t si) { return (si < numSegments) || (si == RodLinkage::NONE); };
+        if (!std::all_of(std::get<8>(s).begin(), std::get<8>(s).end(), validSegment) ||
+            !std::all_of(std::get<9>(s).begin(), std::get<9>(s).end(), validSegment))
+            throw std::runtime_error("Corrupt linkage binary data (invalid joint segment index)");
+        st.joints.emplace_back(s);
+    }
+
+    st.initMinRL = r.real();
+    st.segmentRestLenToEdgeRestLenMapTranspose = readCSC(r);
+    r.matrix(st.perSegmentRestLen);
+    if (size_t(st.perSegmentRestLen.size()) != numSegments)
+        throw std::runtime_error("Corrupt linkage binary data (per-segment rest length size mismatch)");
+    st.dpc.restLen   = r.pod<uint8_t>();
+    st.dpc.restKappa = r.pod<uint8_t>();
+    if (r.version() >= 2) {
+        r.sequence(st.originalSegmentIndex, [&](std::vector<size_t> &c) { c.push_back(r.size()); });
+        r.sequence(st.originalJointIndex,   [&](std::vector<size_t> &c) { c.push_back(r.size()); });
+    }
+    return st;
+}
+
+} // anonymous namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// LinkageBinaryIO
+////////////////////////////////////////////////////////////////////////////////
+void LinkageBinaryIO::save(const RodLinkage &linkage, std::ostream &os) {
+    BinaryWriter w(os);
+    w.header(Kind::RodLinkage);
+    writeLinkage(w, linkage);
+    w.finish();
+}
+
+void LinkageBinaryIO::save(const SurfaceAttractedLinkage &linkage, std::ostream &os) {
+    BinaryWriter w(os);
+    w.header(Kind::SurfaceAttractedLinkage);
+    writeLinkage(w, linkage);
+
+    const auto &tsf = linkage.target_surface_fitter;
+    w.string(linkage.m_surface_path);
+    w.pod(uint8_t(tsf.getUseCenterline()));
+    w.real(linkage.attraction_weight);
+    w.real(linkage.m_attraction_tgt_joint_weight);
+    w.real(linkage.m_l0);
+    w.real(linkage.m_E0);
+    w.pod(uint8_t(tsf.holdClosestPointsFixed));
+
+    w.matrix(tsf.getV());
+    w.matrix(tsf.getF());
+    w.matrix(tsf.joint_pos_tgt);
+    w.matrix(tsf.W_diag_joint_pos);
+    w.matrix(tsf.Wsurf_diag_linkage_sample_pos);
+    w.matrix(tsf.linkage_closest_surf_pts);
+    w.sequence(tsf.linkage_closest_surf_pt_sensitivities, [&](const Eigen::Matrix3d &m) { w.raw(m.data(), 9); });
+    w.sequence(tsf.linkage_closest_surf_tris, [&](int t) { w.pod(int32_t(t)); });
+    w.finish();
+}
+
+void LinkageBinaryIO::save(const PeriodicRod &rod, std::ostream &os) {
+    BinaryWriter w(os);
+    w.header(Kind::PeriodicRod);
+    MaterialTable materials;
+    const auto materialIds = materials.add(rod.rod.edgeMaterials());
+    materials.write(w);
+    writeRod(w, rod.rod, materialIds);
+    w.real(rod.twist());
+    w.finish();
+}
+
+std::unique_ptr<RodLinkage> LinkageBinaryIO::loadRodLinkage(std::istream &is) {
+    BinaryReader r(is);
+    r.expectHeader(Kind::RodLinkage);
+    auto st = readLinkage(r);
+    auto l = std::make_unique<RodLinkage>(st.joints, st.segments, st.homogMat, st.initMinRL,
+                                          st.segmentRestLenToEdgeRestLenMapTranspose, st.perSegmentRestLen, st.dpc);
+    l->setOriginalIndices(st.originalSegmentIndex, st.originalJointIndex);
+    return l;
+}
+
+std::unique_ptr<SurfaceAttractedLinkage> LinkageBinaryIO::loadSurfaceAttractedLinkage(std::istream &is) {
+    BinaryReader r(is);
+    r.expectHeader(Kind::SurfaceAttractedLinkage);
+    auto st = readLinkage(r);
+    auto l = std::make_unique<SurfaceAttractedLinkage>();
+    static_cast<RodLinkage &>(*l).set(st.joints, st.segments, st.homogMat, st.initMinRL,
+                                      st.segmentRestLenToEdgeRestLenMapTranspose, st.perSegmentRestLen, st.dpc);
+    l->setOriginalIndices(st.originalSegmentIndex, st.originalJointIndex);
+
+    l->m_surface_path                 = r.string();
+    const bool useCenterline          = r.pod<uint8_t>();
+    l->attraction_weight              = r.real();
+    l->m_attraction_tgt_joint_weight  = r.real();
+    l->m_l0                           = r.real();
+    l->m_E0                           = r.real();
+    const bool holdClosestPointsFixed = r.pod<uint8_t>();
+
+    Eigen::MatrixXd V;
+    Eigen::MatrixXi F;
+    r.matrix(V);
+    r.matrix(F);
+    if ((V.cols() != 3) || (F.cols() != 3) || ((F.size() > 0) && ((F.minCoeff() < 0) || (F.maxCoeff() >= V.rows()))))
+        throw std::runtime_error("Corrupt linkage binary data (invalid target surface)");
+
+    // Rebuild the target surface's query structures, holding the closest
+    // points fixed so they are not recomputed; the stored fitter state below
+    // overwrites everything these calls initialize.
+    auto &tsf = l->target_surface_fitter;
+    tsf.holdClosestPointsFixed = true;
+    tsf.setTargetSurface(*l, V, F);
+    tsf.setUseCenterline(*l, useCenterline, l->m_attraction_tgt_joint_weight);
+
+    r.matrix(tsf.joint_pos_tgt);
+    r.matrix(tsf.W_diag_joint_pos);
+    r.matrix(tsf.Wsurf_diag_linkage_sample_pos);
+    r.matrix(tsf.linkage_closest_surf_pts);
+    r.sequence(tsf.linkage_closest_surf_pt_sensitivities, [&](std::vector<Eigen::Matrix3d> &c) { Eigen::Matrix3d m; r.raw(m.data(), 9); c.push_back(m); });
+    r.sequence(tsf.linkage_closest_surf_tris, [&](std::vector<int> &c) { c.push_back(r.pod<int32_t>()); });
+    tsf.holdClosestPointsFixed = holdClosestPointsFixed;
+
+    const size_t numSampleComponents = 3 * tsf.numSamplePoints(*l);
+    if ((size_t(tsf.joint_pos_tgt.size()) != 3 * l->numJoints()) || (size_t(tsf.W_diag_joint_pos.size()) != 3 * l->numJoints()) ||
+        (size_t(tsf.Wsurf_diag_linkage_sample_pos.size()) != numSampleComponents) || (size_t(tsf.linkage_closest_surf_pts.size()) != numSampleComponents) ||
+        (3 * tsf.linkage_closest_surf_pt_sensitivities.size() != numSampleComponents) || (3 * tsf.linkage_closest_surf_tris.size() != numSampleComponents))
+        throw std::runtime_error("Corrupt linkage binary data (target surface fitter size mismatch)");
+    if (!std::all_of(tsf.linkage_closest_surf_tris.begin(), tsf.linkage_closest_surf_tris.end(), [&](int t) { return (t >= 0) && (t < F.rows()); }))
+        throw std::runtime_error("Corrupt linkage binary data (invalid closest triangle index)");
+
+    return l;
+}
+
+std::unique_ptr<PeriodicRod> LinkageBinaryIO::loadPeriodicRod(std::istream &is) {
+    BinaryReader r(is);
+    r.expectHeader(Kind::PeriodicRod);
+    const auto materials = MaterialTable::read(r);
+    ElasticRod rod = readRod(r, materials);
+    return std::make_unique<PeriodicRod>(rod, r.real());
+}
+
+LinkageBinaryIO::Kind LinkageBinaryIO::peekKind(std::istream &is) {
+    const auto pos = is.tellg();
+    auto restore = [&]() { is.clear(); is.seekg(pos); };
+    BinaryReader r(is);
+    Kind kind;
+    try { kind = r.header(); }
+    catch (...) { restore(); throw; }
+    restore();
+    return kind;
+}
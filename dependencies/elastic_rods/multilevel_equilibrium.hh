@@ -0,0 +1,209 @@
+////////////////////////////////////////////////////////////////////////////////
+// multilevel_equilibrium.hh
+////////////////////////////////////////////////////////////////////////////////
+/*! @file
+//  Coarse-to-fine equilibrium solves for linkages. The equilibrium is first
+//  computed for a coarse discretization of the linkage (the same line graph
+//  built with a lower `subdivision`), where Newton iterations are cheap. The
+//  coarse deformed state is then prolongated onto the fine linkage, which
+//  only needs a few (expensive) full-resolution iterations to converge.
+//
+//  The prolongation copies each joint's configuration, interpolates the
+//  segments' centerlines at matching normalized rest arclength between the
+//  joint pivots, and sets each free edge's theta so that its material frame
+//  matches the interpolated coarse material frame.
+*/
+////////////////////////////////////////////////////////////////////////////////
+#ifndef MULTILEVEL_EQUILIBRIUM_HH
+#define MULTILEVEL_EQUILIBRIUM_HH
+
+#include "RodLinkage.hh"
+#include "compute_equilibrium.hh"
+
+#include <vector>
+#include <algorithm>
+
+namespace multilevel_detail {
+
+// Index map from `to`'s joints/segments to the corresponding entities of
+// `from`; the two linkages may have been renumbered differently (see
+// RodLinkage::reorderForLocality), so the correspondence goes through the
+// original indices.
+inline std::vector<size_t> correspondence(size_t n, const std::function<size_t(size_t)> &originalFrom,
+                                          const std::function<size_t(size_t)> &originalTo) {
+    std::vector<size_t> fromForOriginal(n, RodLinkage::NONE);
+    for (size_t i = 0; i < n; ++i) fromForOriginal.at(originalFrom(i)) = i;
+    std::vector<size_t> result(n);
+    for (size_t i = 0; i < n; ++i) {
+        result[i] = fromForOriginal.at(originalTo(i));
+        if (result[i] == RodLinkage::NONE) throw std::runtime_error("Inconsistent original index maps");
+    }
+    return result;
+}
+
+inline std::vector<size_t> jointCorrespondence(const RodLinkage &from, const RodLinkage &to) {
+    if (from.numJoints() != to.numJoints()) throw std::runtime_error("Linkages have different numbers of joints");
+    return correspondence(to.numJoints(), [&](size_t ji) { return from.originalJointIndex(ji); },
+                                          [&](size_t ji) { return   to.originalJointIndex(ji); });
+}
+
+inline std::vector<size_t> segmentCorrespondence(const RodLinkage &from, const RodLinkage &to) {
+    if (from.numSegments() != to.numSegments()) throw std::runtime_error("Linkages have different numbers of segments");
+    return correspondence(to.numSegments(), [&](size_t si) { return from.originalSegmentIndex(si); },
+                                            [&](size_t si) { return   to.originalSegmentIndex(si); });
+}
+
+// Normalized rest arclength coordinate of each vertex of segment `s`'s rod:
+// 0 at the start joint's pivot (the midpoint of the first edge) or the free
+// start vertex, 1 at the end joint's pivot or the free end vertex.
+inline std::vector<Real> vertexCoordinates(const RodLinkage::RodSegment &s) {
+    const auto &restLen = s.rod.restLengths();
+    const size_t nv = s.rod.numVertices();
+    std::vector<Real> u(nv);
+    u[0] = s.hasStartJoint() ? -0.5 * restLen.front() : 0.0;
+    for (size_t i = 1; i < nv; ++i) u[i] = u[i - 1] + restLen[i - 1];
+    const Real len = u.back() - (s.hasEndJoint() ? 0.5 * restLen.back() : 0.0);
+    for (Real &val : u) val /= len;
+    return u;
+}
+
+// Locate coordinate `u` in the increasing sequence `coords`, returning the
+// interval index `k` and the (possibly extrapolating) linear interpolation
+// weight `t` of coords[k + 1].
+inline std::pair<size_t, Real> locate(const std::vector<Real> &coords, Real u) {
+    assert(coords.size() >= 2);
+    size_t k = std::distance(coords.begin(), std::upper_bound(coords.begin(), coords.end(), u));
+    k = std::min(std::max<size_t>(k, 1), coords.size() - 1) - 1;
+    return std::make_pair(k, (u - coords[k]) / (coords[k + 1] - coords[k]));
+}
+
+}
+
+// Set the deformed configuration of `fine` by prolongating that of `coarse`.
+// Both linkages must be discretizations of the same line graph with the same
+// joint labeling (e.g., both constructed from the same file with different
+// `subdivision` values); they may differ in their number of edges per
+// segment and in their joint/segment numbering. Each segment may be refined
+// or coarsened independently (see adaptive_subdivision.hh).
+inline void prolongateDeformedState(const RodLinkage &coarse, RodLinkage &fine) {
+    using namespace multilevel_detail;
+    using Joint = RodLinkage::Joint;
+    const auto coarseJoint   = jointCorrespondence  (coarse, fine);
+    const auto coarseSegment = segmentCorrespondence(coarse, fine);
+    auto mapSegment = [&](size_t si) { return (si == RodLinkage::NONE) ? si : coarseSegment[si]; };
+    auto mapJoint   = [&](size_t ji) { return (ji == RodLinkage::NONE) ? ji : coarseJoint  [ji]; };
+    for (size_t si = 0; si < fine.numSegments(); ++si) {
+        const auto &fs = fine.segment(si);
+        const auto &cs = coarse.segment(coarseSegment[si]);
+        if ((mapJoint(fs.startJoint) != cs.startJoint) || (mapJoint(fs.endJoint) != cs.endJoint))
+            throw std::runtime_error("Incompatible orientation of segment " + std::to_string(si));
+    }
+
+    // Joints: transfer the full configuration (including the rotation
+    // parametrization's source frame), rescaling the joint edge lengths by
+    // the ratio of the two discretizations' rest lengths.
+    for (size_t ji = 0; ji < fine.numJoints(); ++ji) {
+        const Joint &cj = coarse.joint(coarseJoint[ji]);
+        Joint       &fj = fine.joint(ji);
+        for (size_t i = 0; i < 2; ++i) {
+            if ((mapSegment(fj.segmentsA()[i]) != cj.segmentsA()[i]) || (fj.isStartA()[i] != cj.isStartA()[i]) ||
+                (mapSegment(fj.segmentsB()[i]) != cj.segmentsB()[i]) || (fj.isStartB()[i] != cj.isStartB()[i]) ||
+                (fj.sign_B() != cj.sign_B()))
+                throw std::runtime_error("Incompatible rod labels at joint " + std::to_string(ji));
+        }
+        const RodLinkage::Vec2 lenScale = fj.getRestLengths().cwiseQuotient(cj.getRestLengths());
+
+        Joint::SerializedState state = fj.getState();
+        std::get<0>(state) = cj.pos();
+        std::get<1>(state) = cj.omega();
+        std::get<2>(state) = cj.alpha();
+        std::get<3>(state) = cj.len_A() * lenScale[0];
+        std::get<4>(state) = cj.len_B() * lenScale[1];
+        std::get<6>(state) = cj.source_tangent();
+        std::get<7>(state) = cj.source_normal();
+        fj = Joint(state);
+        fj.updateLinkagePointer(&fine);
+    }
+
+    // Segments: interpolate the centerline and material frame.
+    auto processSegment = [&](size_t si) {
+        const auto &cs = coarse.segment(coarseSegment[si]);
+        auto       &fs = fine.segment(si);
+        const auto &crod = cs.rod;
+        auto       &frod = fs.rod;
+
+        const std::vector<Real> uc = vertexCoordinates(cs),
+                                uf = vertexCoordinates(fs);
+        std::vector<Real> ucEdge(crod.numEdges());
+        for (size_t j = 0; j < ucEdge.size(); ++j) ucEdge[j] = 0.5 * (uc[j] + uc[j + 1]);
+
+        const auto &cpts = crod.deformedPoints();
+        std::vector<RodLinkage::Pt3> points(frod.numVertices());
+        for (size_t i = 0; i < points.size(); ++i) {
+            const auto loc = locate(uc, uf[i]);
+            points[i] = (1 - loc.second) * cpts[loc.first] + loc.second * cpts[loc.first + 1];
+        }
+
+        std::vector<Real> thetas = frod.thetas();
+        for (size_t j = 0; j < thetas.size(); ++j) {
+            const RodLinkage::Vec3 e = points[j + 1] - points[j];
+            RodLinkage::Vec3 d2 = crod.deformedMaterialFrameD2(0);
+            if (ucEdge.size() > 1) {
+                const auto loc = locate(ucEdge, 0.5 * (uf[j] + uf[j + 1]));
+                d2 = (1 - loc.second) * crod.deformedMaterialFrameD2(loc.first) + loc.second * crod.deformedMaterialFrameD2(loc.first + 1);
+            }
+            d2 -= (d2.dot(e) / e.squaredNorm()) * e;
+            if (d2.norm() < 1e-8) continue; // Degenerate frame; keep the current theta.
+            thetas[j] = frod.thetaForMaterialFrameD2(d2.normalized(), e, j, /* spatialCoherence = */ false);
+        }
+        frod.setDeformedConfiguration(points, thetas);
+    };
+    parallel_for_range(fine.numSegments(), processSegment);
+
+    // Re-apply the joint configurations to the segments' terminal edges.
+    fine.setDoFs(fine.getDoFs());
+    fine.updateSourceFrame();
+}
+
+// Translate variables of `from` to the corresponding variables of `to`; only
+// joint variables have a counterpart in a different discretization.
+inline std::vector<size_t> transferJointVars(const RodLinkage &from, const RodLinkage &to, const std::vector<size_t> &vars) {
+    const auto toJoint = multilevel_detail::jointCorrespondence(to, from);
+    std::vector<size_t> result;
+    result.reserve(vars.size());
+    for (size_t var : vars) {
+        size_t ji = 0;
+        while ((ji < from.numJoints()) && !((var >= from.dofOffsetForJoint(ji)) && (var < from.dofOffsetForJoint(ji) + from.joint(ji).numDoF()))) ++ji;
+        if (ji == from.numJoints()) throw std::runtime_error("Variable " + std::to_string(var) + " is not a joint variable");
+        result.push_back(to.dofOffsetForJoint(toJoint[ji]) + (var - from.dofOffsetForJoint(ji)));
+    }
+    return result;
+}
+
+// Compute the equilibrium of `fine` by first solving for the equilibrium of
+// `coarse` (a coarser discretization of the same linkage, which must have the
+// same materials and rest lengths) and then warm starting the fine solve with
+// the prolongated coarse equilibrium. `fixedVars` refers to the fine
+// linkage's variables and may only contain joint variables. The coarse solve
+// uses `coarseOpts` (e.g., with looser tolerances), and the report of the
+// fine solve is returned (or the coarse solve's report if it was cancelled).
+inline ConvergenceReport
+compute_equilibrium_multilevel(RodLinkage &coarse, RodLinkage &fine, Real targetAverageAngle,
+                               const NewtonOptimizerOptions &opts, const NewtonOptimizerOptions &coarseOpts,
+                               const std::vector<size_t> &fixedVars = std::vector<size_t>(), CallbackFunction customCallback = nullptr) {
+    const auto coarseFixedVars = transferJointVars(fine, coarse, fixedVars);
+    ConvergenceReport report = compute_equilibrium(coarse, targetAverageAngle, coarseOpts, coarseFixedVars);
+    if (report.cancelled) return report;
+
+    prolongateDeformedState(coarse, fine);
+    return compute_equilibrium(fine, targetAverageAngle, opts, fixedVars, customCallback);
+}
+
+inline ConvergenceReport
+compute_equilibrium_multilevel(RodLinkage &coarse, RodLinkage &fine, Real targetAverageAngle,
+                               const NewtonOptimizerOptions &opts = NewtonOptimizerOptions(),
+                               const std::vector<size_t> &fixedVars = std::vector<size_t>(), CallbackFunction customCallback = nullptr) {
+    return compute_equilibrium_multilevel(coarse, fine, targetAverageAngle, opts, opts, fixedVars, customCallback);
+}
+
+#endif /* end of include guard: MULTILEVEL_EQUILIBRIUM_HH */
@@ -4,14 +4,17 @@
 #include "RodLinkage.hh"
 #include "compute_equilibrium.hh"
 
-inline void open_linkage(RodLinkage &linkage, const Real deployedActuationAngle, NewtonOptimizerOptions eopts, const size_t rigidMotionConstrainedJoint, const Real maxStepSize = 0.02) {
+// Returns the report of the last equilibrium solve; the opening stops early if
+// a solve is cancelled through `eopts.progressCallback`.
+inline ConvergenceReport open_linkage(RodLinkage &linkage, const Real deployedActuationAngle, NewtonOptimizerOptions eopts, const size_t rigidMotionConstrainedJoint, const Real maxStepSize = 0.02) {
     const size_t jdo = linkage.dofOffsetForJoint(rigidMotionConstrainedJoint);
     std::vector<size_t> rigidMotionFixedVars = { jdo + 0, jdo + 1, jdo + 2, jdo + 3, jdo + 4, jdo + 5 };
 
     const Real closedActuationAngle = linkage.getAverageJointAngle();
     auto full_actuation_equilibrium = get_equilibrium_optimizer(linkage, closedActuationAngle, rigidMotionFixedVars);
     full_actuation_equilibrium->options = eopts;
-    full_actuation_equilibrium->optimize();
+    ConvergenceReport report = full_actuation_equilibrium->optimize();
+    if (report.cancelled) return report;
 
     int openingSteps = int(ceil(std::abs(deployedActuationAngle - closedActuationAngle) / maxStepSize));
 
@@ -24,9 +27,11 @@ inline void open_linkage(RodLinkage &linkage, const Real deployedActuationAngle,
         Real alpha_bar = closedActuationAngle * (1 - frac) + deployedActuationAngle * frac;
         std::cout << "Setting angle: " << alpha_bar << std::endl;
         setTargetAngle(alpha_bar);
-        full_actuation_equilibrium->optimize();
+        report = full_actuation_equilibrium->optimize();
+        if (report.cancelled) break;
     }
     // linkage.saveVisualizationGeometry("opened_linkage.msh");
+    return report;
 }
 
 #endif /* end of include guard: OPEN_LINKAGE_HH */
@@ -8,11 +8,14 @@
 #include "../PeriodicRod.hh"
 #include "../SurfaceAttractedLinkage.hh"
 #include "../compute_equilibrium.hh"
+#include "../multilevel_equilibrium.hh"
+#include "../adaptive_subdivision.hh"
 #include "../restlen_solve.hh"
 #include "../design_parameter_solve.hh"
 #include "../knitro_solver.hh"
 #include "../linkage_deformation_analysis.hh"
 #include "../DeploymentPathAnalysis.hh"
+#include "../linkage_io.hh"
 
 #include "../CrossSection.hh"
 #include "../cross_sections/Custom.hh"
@@ -81,6 +84,13 @@ CallbackFunction callbackWrapper(const PyCallbackFunction &pcb) {
     return [pcb](NewtonProblem &p, size_t i) -> void { if (pcb) pcb(&p, i); };
 }
 
+// Per-component byte counts of a MemoryReport, in report order.
+py::dict memoryReportDict(const MemoryReport &report) {
+    py::dict result;
+    for (const auto &c : report.components) result[py::str(c.first)] = c.second;
+    return result;
+}
+
 template<typename Object>
 void bindDesignParameterProblem(py::module &m, const std::string &typestr) {
     using DPP = DesignParameterProblem<Object>;
@@ -174,6 +184,7 @@ PYBIND11_MODULE(elastic_rods, m) {
         .def("setDeformedConfiguration", py::overload_cast<const std::vector<Point3D> &, const std::vector<Real> &>(&ElasticRod::setDeformedConfiguration))
         .def("setDeformedConfiguration", py::overload_cast<const ElasticRod::DeformedState &>(&ElasticRod::setDeformedConfiguration))
         .def("deformedPoints", &ElasticRod::deformedPoints)
+        .def("memoryReport",   [](const ElasticRod &r) { return memoryReportDict(r.memoryReport()); })
         .def("restDirectors",  &ElasticRod::restDirectors)
         .def("thetas",         &ElasticRod::thetas)
         .def("setMaterial",    py::overload_cast<const             RodMaterial  &>(&ElasticRod::setMaterial))
@@ -191,7 +202,7 @@ PYBIND11_MODULE(elastic_rods, m) {
         .def("restPoints", &ElasticRod::restPoints)
 
         // Outputs mesh with normals
-        .def("visualizationGeometry",             &getVisualizationGeometry<ElasticRod>, py::arg("averagedMaterialFrames") = true, py::arg("averagedCrossSections") = true)
+        .def("visualizationGeometry",             &getVisualizationGeometryFloat<ElasticRod>, py::arg("averagedMaterialFrames") = true, py::arg("averagedCrossSections") = true)
         .def("visualizationGeometryHeightColors", &getVisualizationGeometryCSHeightField<ElasticRod>, "Get a per-visualization-vertex field representing height above the centerline")
 
         .def("rawVisualizationGeometry", [](ElasticRod &r, const bool averagedMaterialFrames, const bool averagedCrossSections) {
@@ -712,6 +723,17 @@ PYBIND11_MODULE(elastic_rods, m) {
                 PeriodicRod::CSCMat H;
                 r.hessian(H, etype);
                 return H; },  py::arg("energyType") = ElasticRod::EnergyType::Full)
+        .def("saveBinary", [](const PeriodicRod &obj, const std::string &path) { saveBinary(obj, path); }, py::arg("path"), "Save in the versioned binary format of linkage_io.hh")
+        .def("toBinary",   [](const PeriodicRod &obj) { return py::bytes(serializeBinary(obj)); })
+        .def_static("loadBinary", [](const std::string &path) {
+                std::ifstream is(path, std::ios::binary);
+                if (!is.is_open()) throw std::runtime_error("Failed to open input file " + path);
+                return LinkageBinaryIO::loadPeriodicRod(is);
+            }, py::arg("path"))
+        .def_static("fromBinary", [](const py::bytes &data) {
+                std::istringstream is(std::string(data), std::ios::binary);
+                return LinkageBinaryIO::loadPeriodicRod(is);
+            }, py::arg("data"))
         .def("thetaOffset",  &PeriodicRod::thetaOffset)
         .def_readonly("rod", &PeriodicRod::rod, py::return_value_policy::reference)
         .def_property("twist", &PeriodicRod::twist, &PeriodicRod::setTwist, "Twist discontinuity passing from last edge back to (overlapping) first")
@@ -723,6 +745,8 @@ PYBIND11_MODULE(elastic_rods, m) {
     auto rod_linkage = py::class_<RodLinkage>(m, "RodLinkage")
         .def(py::init<const Eigen::MatrixX3d &, const Eigen::MatrixX2i &, size_t, bool, InterleavingType, std::vector<std::function<Pt3_T<Real>(Real, bool)>>, std::vector<Eigen::Vector3d>>(), py::arg("points"), py::arg("edges"), py::arg("subdivision") = 10, py::arg("initConsistentAngle") = true, py::arg("rod_interleaving_type") = InterleavingType::noOffset, py::arg("edge_callbacks") = std::vector<std::function<Pt3_T<Real>(Real, bool)>>(), py::arg("input_joint_normals") = std::vector<Eigen::Vector3d>())
         .def(py::init<const std::string &, size_t, bool, InterleavingType, std::vector<std::function<Pt3_T<Real>(Real, bool)>>, std::vector<Eigen::Vector3d>>(), py::arg("path"), py::arg("subdivision") = 10, py::arg("initConsistentAngle") = true, py::arg("rod_interleaving_type") = InterleavingType::noOffset, py::arg("edge_callbacks") = std::vector<std::function<Pt3_T<Real>(Real, bool)>>(), py::arg("input_joint_normals") = std::vector<Eigen::Vector3d>())
+        .def(py::init<const Eigen::MatrixX3d &, const Eigen::MatrixX2i &, const std::vector<size_t> &, bool, InterleavingType, std::vector<std::function<Pt3_T<Real>(Real, bool)>>, std::vector<Eigen::Vector3d>>(), py::arg("points"), py::arg("edges"), py::arg("segmentSubdivisions"), py::arg("initConsistentAngle") = true, py::arg("rod_interleaving_type") = InterleavingType::noOffset, py::arg("edge_callbacks") = std::vector<std::function<Pt3_T<Real>(Real, bool)>>(), py::arg("input_joint_normals") = std::vector<Eigen::Vector3d>())
+        .def(py::init<const std::string &, const std::vector<size_t> &, bool, InterleavingType, std::vector<std::function<Pt3_T<Real>(Real, bool)>>, std::vector<Eigen::Vector3d>>(), py::arg("path"), py::arg("segmentSubdivisions"), py::arg("initConsistentAngle") = true, py::arg("rod_interleaving_type") = InterleavingType::noOffset, py::arg("edge_callbacks") = std::vector<std::function<Pt3_T<Real>(Real, bool)>>(), py::arg("input_joint_normals") = std::vector<Eigen::Vector3d>())
         .def(py::init<const RodLinkage &>(), "Copy constructor", py::arg("rod"))
 
         .def("set", (void (RodLinkage::*)(const Eigen::MatrixX3d &, const Eigen::MatrixX2i &, size_t, bool, InterleavingType, std::vector<std::function<Pt3_T<Real>(Real, bool)>>, std::vector<Eigen::Vector3d>))(&RodLinkage::set), py::arg("points"), py::arg("edges"), py::arg("subdivision") = 10, py::arg("initConsistentAngle") = true, py::arg("rod_interleaving_type") = InterleavingType::noOffset, py::arg("edge_callbacks") = std::vector<std::function<Pt3_T<Real>(Real, bool)>>(), py::arg("input_joint_normals") = std::vector<Eigen::Vector3d>()) // py::overload_cast fails
@@ -770,6 +794,7 @@ PYBIND11_MODULE(elastic_rods, m) {
         .def("joints",   [](const RodLinkage &l) { return py::make_iterator(l.joints  ().cbegin(), l.joints  ().cend()); })
 
         .def("traceRods",   &RodLinkage::traceRods)
+        .def("memoryReport", [](const RodLinkage &l) { return memoryReportDict(l.memoryReport()); }, "Bytes held by each component of the linkage (see RodLinkage::memoryReport)")
         .def("rodStresses", &RodLinkage::rodStresses)
         .def("florinVisualizationGeometry", [](const RodLinkage &l) {
                 std::vector<std::vector<size_t>> polylinesA, polylinesB;
@@ -799,6 +824,7 @@ PYBIND11_MODULE(elastic_rods, m) {
 
         .def("set_design_parameter_config", &RodLinkage::setDesignParameterConfig, py::arg("use_restLen"), py::arg("use_restKappa"), py::arg("update_designParams_cache") = true)
         .def("get_design_parameter_config", &RodLinkage::getDesignParameterConfig)
+        .def_property("parallelismArena", &RodLinkage::parallelismArena, &RodLinkage::setParallelismArena, "ParallelismArena used by the equilibrium solves and design optimizations of this linkage")
 
         .def("setMaterial",               &RodLinkage::setMaterial, py::arg("material"))
         .def("setJointMaterials",         &RodLinkage::setJointMaterials, py::arg("jointMaterials"))
@@ -812,7 +838,7 @@ PYBIND11_MODULE(elastic_rods, m) {
         .def("writeTriangulation",        &RodLinkage::writeTriangulation)
 
         // Outputs mesh with normals
-        .def("visualizationGeometry", &getVisualizationGeometry<RodLinkage>, py::arg("averagedMaterialFrames") = true, py::arg("averagedCrossSections") = true)
+        .def("visualizationGeometry", &getVisualizationGeometryFloat<RodLinkage>, py::arg("averagedMaterialFrames") = true, py::arg("averagedCrossSections") = true)
         .def("visualizationGeometryHeightColors", &getVisualizationGeometryCSHeightField<RodLinkage>, "Get a per-visualization-vertex field representing height above the centerline")
 
         .def("sqrtBendingEnergies", &RodLinkage::sqrtBendingEnergies)
@@ -861,6 +887,15 @@ PYBIND11_MODULE(elastic_rods, m) {
         .def("restLenDofOffsetForSegment",   &RodLinkage::restLenDofOffsetForSegment,   py::arg("index"))
         .def("restKappaDofOffsetForSegment", &RodLinkage::restKappaDofOffsetForSegment, py::arg("index"))
 
+        .def("reorderForLocality",     &RodLinkage::reorderForLocality, "Renumber the segments and joints along a reverse Cuthill-McKee ordering of the joint graph (see RodLinkage::reorderForLocality). "
+                                                                          "This changes the public joint/segment indices and DoF layout: DoF vectors, fixed variables and joint/segment indices must use the new numbering.")
+        .def("restoreOriginalOrder",   &RodLinkage::restoreOriginalOrder, "Undo reorderForLocality, restoring the joint/segment numbering the linkage was built with")
+        .def("isReordered",            &RodLinkage::isReordered)
+        .def("originalSegmentIndex",   &RodLinkage::originalSegmentIndex, py::arg("si"))
+        .def("originalJointIndex",     &RodLinkage::originalJointIndex,   py::arg("ji"))
+        .def("originalSegmentIndices", &RodLinkage::originalSegmentIndices)
+        .def("originalJointIndices",   &RodLinkage::originalJointIndices)
+
         .def("getTerminalEdgeSensitivity", [](RodLinkage &l, size_t si, int which, bool updatedSource, bool evalHessian) {
                     if ((which < 0) || (which > 1)) throw std::runtime_error("`which` must be 0 (start) or 1 (end)");
                     return l.getTerminalEdgeSensitivity(si, static_cast<RodLinkage::TerminalEdge>(which), updatedSource, evalHessian);
@@ -879,6 +914,17 @@ PYBIND11_MODULE(elastic_rods, m) {
                                                                 t[5].cast<Eigen::VectorXd>(),
                                                                 t[6].cast<DesignParameterConfig>());
                         }))
+        .def("saveBinary", [](const RodLinkage &obj, const std::string &path) { saveBinary(obj, path); }, py::arg("path"), "Save in the versioned binary format of linkage_io.hh")
+        .def("toBinary",   [](const RodLinkage &obj) { return py::bytes(serializeBinary(obj)); })
+        .def_static("loadBinary", [](const std::string &path) {
+                std::ifstream is(path, std::ios::binary);
+                if (!is.is_open()) throw std::runtime_error("Failed to open input file " + path);
+                return LinkageBinaryIO::loadRodLinkage(is);
+            }, py::arg("path"))
+        .def_static("fromBinary", [](const py::bytes &data) {
+                std::istringstream is(std::string(data), std::ios::binary);
+                return LinkageBinaryIO::loadRodLinkage(is);
+            }, py::arg("data"))
 
         .def("fromGHState", [](const std::vector<RodLinkage::Joint> &joints, const std::vector<RodLinkage::RodSegment> &segments,
              const RodMaterial &homogMat, Real initMinRL, const std::vector<Real> &Ax, const std::vector<size_t> &Ai, const std::vector<size_t> &Ap, 
@@ -1128,6 +1174,17 @@ PYBIND11_MODULE(elastic_rods, m) {
                                                                 t[8].cast<DesignParameterConfig>());
 
                         }))
+        .def("saveBinary", [](const SurfaceAttractedLinkage &obj, const std::string &path) { saveBinary(obj, path); }, py::arg("path"), "Save in the versioned binary format of linkage_io.hh")
+        .def("toBinary",   [](const SurfaceAttractedLinkage &obj) { return py::bytes(serializeBinary(obj)); })
+        .def_static("loadBinary", [](const std::string &path) {
+                std::ifstream is(path, std::ios::binary);
+                if (!is.is_open()) throw std::runtime_error("Failed to open input file " + path);
+                return LinkageBinaryIO::loadSurfaceAttractedLinkage(is);
+            }, py::arg("path"))
+        .def_static("fromBinary", [](const py::bytes &data) {
+                std::istringstream is(std::string(data), std::ios::binary);
+                return LinkageBinaryIO::loadSurfaceAttractedLinkage(is);
+            }, py::arg("data"))
         ;
     ////////////////////////////////////////////////////////////////////////////////
     // Equilibrium solver
@@ -1198,6 +1255,54 @@ PYBIND11_MODULE(elastic_rods, m) {
           py::arg("fixedVars") = std::vector<size_t>(),
           py::arg("callback") = nullptr
     );
+    m.def("compute_equilibrium_multilevel",
+          [](RodLinkage &coarse, RodLinkage &fine, Real targetAverageAngle, const NewtonOptimizerOptions &options, const NewtonOptimizerOptions *coarseOptions, const std::vector<size_t> &fixedVars, const PyCallbackFunction &pcb) {
+              py::scoped_ostream_redirect stream1(std::cout, py::module::import("sys").attr("stdout"));
+              py::scoped_ostream_redirect stream2(std::cerr, py::module::import("sys").attr("stderr"));
+              auto cb = callbackWrapper(pcb);
+              return compute_equilibrium_multilevel(coarse, fine, targetAverageAngle, options, coarseOptions ? *coarseOptions : options, fixedVars, cb);
+          },
+          py::arg("coarse"),
+          py::arg("fine"),
+          py::arg("targetAverageAngle") = TARGET_ANGLE_NONE,
+          py::arg("options") = NewtonOptimizerOptions(),
+          py::arg("coarseOptions") = nullptr,
+          py::arg("fixedVars") = std::vector<size_t>(),
+          py::arg("callback") = nullptr
+    );
+    m.def("prolongateDeformedState", &prolongateDeformedState, py::arg("coarse"), py::arg("fine"));
+
+    py::class_<AdaptiveSubdivisionOptions>(m, "AdaptiveSubdivisionOptions")
+        .def(py::init<>())
+        .def_readwrite("targetTurningAngle", &AdaptiveSubdivisionOptions::targetTurningAngle)
+        .def_readwrite("minSubdivision",     &AdaptiveSubdivisionOptions::minSubdivision)
+        .def_readwrite("maxSubdivision",     &AdaptiveSubdivisionOptions::maxSubdivision)
+        .def_readwrite("allowCoarsening",    &AdaptiveSubdivisionOptions::allowCoarsening)
+        .def_readwrite("maxPasses",          &AdaptiveSubdivisionOptions::maxPasses)
+        .def_readwrite("consistentAngle",    &AdaptiveSubdivisionOptions::consistentAngle)
+        .def_readwrite("interleavingType",   &AdaptiveSubdivisionOptions::interleavingType)
+        ;
+    m.def("segmentSubdivisions",  &segmentSubdivisions,  py::arg("linkage"));
+    m.def("segmentTurningAngles", &segmentTurningAngles, py::arg("linkage"));
+    m.def("adaptedSubdivisions",  &adaptedSubdivisions,  py::arg("linkage"), py::arg("options") = AdaptiveSubdivisionOptions());
+    m.def("resubdivided", &resubdivided<Eigen::MatrixX3d, Eigen::MatrixX2i>,
+          py::arg("linkage"), py::arg("points"), py::arg("edges"), py::arg("segmentSubdivisions"), py::arg("options") = AdaptiveSubdivisionOptions());
+    m.def("compute_equilibrium_adaptive",
+          [](RodLinkage &linkage, const Eigen::MatrixX3d &points, const Eigen::MatrixX2i &edges, Real targetAverageAngle, const NewtonOptimizerOptions &options, const AdaptiveSubdivisionOptions &adaptiveOptions, const std::vector<size_t> &fixedVars, const PyCallbackFunction &pcb) {
+              py::scoped_ostream_redirect stream1(std::cout, py::module::import("sys").attr("stdout"));
+              py::scoped_ostream_redirect stream2(std::cerr, py::module::import("sys").attr("stderr"));
+              auto cb = callbackWrapper(pcb);
+              return compute_equilibrium_adaptive(linkage, points, edges, targetAverageAngle, options, adaptiveOptions, fixedVars, cb);
+          },
+          py::arg("linkage"),
+          py::arg("points"),
+          py::arg("edges"),
+          py::arg("targetAverageAngle") = TARGET_ANGLE_NONE,
+          py::arg("options") = NewtonOptimizerOptions(),
+          py::arg("adaptiveOptions") = AdaptiveSubdivisionOptions(),
+          py::arg("fixedVars") = std::vector<size_t>(),
+          py::arg("callback") = nullptr
+    );
     m.def("get_equilibrium_optimizer",
           [](RodLinkage &linkage, Real targetAverageAngle, const std::vector<size_t> &fixedVars) { return get_equilibrium_optimizer(linkage, targetAverageAngle, fixedVars); },
           py::arg("linkage"),
@@ -1413,14 +1518,16 @@ PYBIND11_MODULE(elastic_rods, m) {
     ////////////////////////////////////////////////////////////////////////////////
     // Benchmarking
     ////////////////////////////////////////////////////////////////////////////////
-    m.def("benchmark_reset", &BENCHMARK_RESET);
+    m.def("benchmark_reset", []() { Profiler::reset(); });
     m.def("benchmark_start_timer_section", &BENCHMARK_START_TIMER_SECTION, py::arg("name"));
     m.def("benchmark_stop_timer_section",  &BENCHMARK_STOP_TIMER_SECTION,  py::arg("name"));
     m.def("benchmark_start_timer",         &BENCHMARK_START_TIMER,         py::arg("name"));
     m.def("benchmark_stop_timer",          &BENCHMARK_STOP_TIMER,          py::arg("name"));
+    m.def("benchmark_set_enabled",         &Profiler::setEnabled,          py::arg("enable"));
+    m.def("benchmark_enabled",             &Profiler::enabled);
     m.def("benchmark_report", [](bool includeMessages) {
             py::scoped_ostream_redirect stream(std::cout, py::module::import("sys").attr("stdout"));
-            if (includeMessages) BENCHMARK_REPORT(); else BENCHMARK_REPORT_NO_MESSAGES();
+            if (includeMessages) BENCHMARK_REPORT(); else Profiler::report(std::cout);
         },
         py::arg("include_messages") = false)
         ;
@@ -258,6 +258,8 @@ PYBIND11_MODULE(linkage_optimization, m) {
     py::enum_<OptAlgorithm>(m, "OptAlgorithm")
         .value("NEWTON_CG", OptAlgorithm::NEWTON_CG)
         .value("BFGS",      OptAlgorithm::BFGS     )
+        .value("NATIVE_NEWTON_CG", OptAlgorithm::NATIVE_NEWTON_CG)
+        .value("NATIVE_LBFGSB",    OptAlgorithm::NATIVE_LBFGSB   )
         ;
 
 
@@ -307,14 +309,14 @@ PYBIND11_MODULE(linkage_optimization, m) {
     ////////////////////////////////////////////////////////////////////////////////
     // Benchmarking
     ////////////////////////////////////////////////////////////////////////////////
-    m.def("benchmark_reset", &BENCHMARK_RESET);
+    m.def("benchmark_reset", []() { Profiler::reset(); });
     m.def("benchmark_start_timer_section", &BENCHMARK_START_TIMER_SECTION, py::arg("name"));
     m.def("benchmark_stop_timer_section",  &BENCHMARK_STOP_TIMER_SECTION,  py::arg("name"));
     m.def("benchmark_start_timer",         &BENCHMARK_START_TIMER,         py::arg("name"));
     m.def("benchmark_stop_timer",          &BENCHMARK_STOP_TIMER,          py::arg("name"));
     m.def("benchmark_report", [](bool includeMessages) {
             py::scoped_ostream_redirect stream(std::cout, py::module::import("sys").attr("stdout"));
-            if (includeMessages) BENCHMARK_REPORT(); else BENCHMARK_REPORT_NO_MESSAGES();
+            if (includeMessages) BENCHMARK_REPORT(); else Profiler::report(std::cout);
         },
         py::arg("include_messages") = false)
         ;
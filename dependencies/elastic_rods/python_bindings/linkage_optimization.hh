@@ -157,8 +157,10 @@ void bindLinkageOptimization(py::module &m, const std::string &typestr) {
     .def("get_rl0",         &LO::get_rl0)
     .def("get_E0",          &LO::get_E0)
     .def("invalidateAdjointState",     &LO::invalidateAdjointState)
+    .def("invalidateAutodiffLinkages", &LO::invalidateAutodiffLinkages)
     .def("restKappaSmoothness", &LO::restKappaSmoothness)
     .def_readwrite("prediction_order", &LO::prediction_order)
+    .def_property("parallelismArena", &LO::parallelismArena, &LO::setParallelismArena)
     .def_property("beta",  &LO::getBeta , &LO::setBeta )
     .def_property("gamma", &LO::getGamma, &LO::setGamma)
     .def_property("rl_regularization_weight", &LO::getRestLengthMinimizationWeight, &LO::setRestLengthMinimizationWeight)
@@ -234,6 +236,7 @@ void bindWeavingOptimization(py::module &m, const std::string &typestr) {
     std::string pyclass_name = std::string("WeavingOptimization_") + typestr;
     py::class_<WO, LO>(m, pyclass_name.c_str())
     .def(py::init<Object<Real> &, const std::string, bool, const NewtonOptimizerOptions &, int, bool, const std::vector<size_t>>(), py::arg("weaver"), py::arg("input_surface_path"), py::arg("useCenterline"), py::arg("equilibrium_options") = NewtonOptimizerOptions(), py::arg("pinJoint") = -1, py::arg("useFixedJoint") = true, py::arg("fixedVars") = std::vector<size_t>())
+    .def(py::init<Object<Real> &, const Eigen::MatrixXd &, const Eigen::MatrixXi &, bool, const NewtonOptimizerOptions &, int, bool, const std::vector<size_t>>(), py::arg("weaver"), py::arg("target_vertices"), py::arg("target_faces"), py::arg("useCenterline"), py::arg("equilibrium_options") = NewtonOptimizerOptions(), py::arg("pinJoint") = -1, py::arg("useFixedJoint") = true, py::arg("fixedVars") = std::vector<size_t>())
     .def("gradp_J",        py::overload_cast<const Eigen::Ref<const Eigen::VectorXd> &, OptEnergyType>(&WO::gradp_J),        py::arg("params"), py::arg("energyType") = OptEnergyType::Full)
 
     .def("WeavingOptimize", &WO::optimize, py::arg("alg"), py::arg("num_steps"), py::arg("trust_region_scale"), py::arg("optimality_tol"), py::arg("update_viewer"), py::arg("minRestLen") = -1, py::arg("applyAngleConstraint") = false, py::arg("applyFlatnessConstraint") = false)
@@ -247,6 +250,7 @@ void bindWeavingOptimization(py::module &m, const std::string &typestr) {
     .def("setUseCenterline",           &WO::setUseCenterline, py::arg("useCenterline"), py::arg("jointPosWeight"), py::arg("jointPosValence2Multiplier"))
 
     .def("loadTargetSurface",          &WO::loadTargetSurface,          py::arg("path"))
+    .def("setTargetSurface",           &WO::setTargetSurface,           py::arg("V"), py::arg("F"))
     .def("set_target_joint_position",  &WO::set_target_joint_position,  py::arg("input_target_joint_pos"))
     .def("set_holdClosestPointsFixed", &WO::set_holdClosestPointsFixed, py::arg("holdClosestPointsFixed"))
     .def("scaleJointWeights",          &WO::scaleJointWeights, py::arg("jointPosWeight"), py::arg("featureMultiplier") = 1.0, py::arg("additional_feature_pts") = std::vector<size_t>())
@@ -5,10 +5,10 @@ using VisualizationGeometry = std::tuple<Eigen::Matrix<float,    Eigen::Dynamic,
                                          Eigen::Matrix<uint32_t, Eigen::Dynamic, 3>,  // Tris
                                          Eigen::Matrix<float,    Eigen::Dynamic, 3>>; // Normals
 
-// Convert MeshIO quad mesh to a triangulated mesh with normals.
-inline
-VisualizationGeometry visualizationGeometry(const std::vector<MeshIO::IOVertex > &vertices,
-                                            const std::vector<MeshIO::IOElement> &elements) {
+// Triangulate a planar quad mesh with per-face normals; `point(v)` returns
+// the float coordinates of quad vertex `v`.
+template<class PointGetter>
+VisualizationGeometry triangulatedQuadGeometry(const PointGetter &point, const std::vector<MeshIO::IOElement> &elements) {
     const size_t nq = elements.size(); // Elements are planar quads
     const size_t nt = 2 * nq;          // that we triangulate.
     const size_t nv = 4 * nq;          // We duplicate the quad's corners (for per-face normals)
@@ -25,10 +25,10 @@ VisualizationGeometry visualizationGeometry(const std::vector<MeshIO::IOVertex >
         const auto &quad = elements[i];
         if (quad.size() != 4) throw std::runtime_error("Expected quads");
 
-        pts.row(4 * i + 0) = vertices[quad[0]].point.cast<float>();
-        pts.row(4 * i + 1) = vertices[quad[1]].point.cast<float>();
-        pts.row(4 * i + 2) = vertices[quad[2]].point.cast<float>();
-        pts.row(4 * i + 3) = vertices[quad[3]].point.cast<float>();
+        pts.row(4 * i + 0) = point(quad[0]);
+        pts.row(4 * i + 1) = point(quad[1]);
+        pts.row(4 * i + 2) = point(quad[2]);
+        pts.row(4 * i + 3) = point(quad[3]);
 
         Eigen::Vector3f n = (pts.row(4 * i + 1) - pts.row(4 * i + 0)).cross(pts.row(4 * i + 3) - pts.row(4 * i + 0)).normalized();
         normals.row(4 * i + 0) = n;
@@ -43,6 +43,13 @@ VisualizationGeometry visualizationGeometry(const std::vector<MeshIO::IOVertex >
     return result;
 }
 
+// Convert MeshIO quad mesh to a triangulated mesh with normals.
+inline
+VisualizationGeometry visualizationGeometry(const std::vector<MeshIO::IOVertex > &vertices,
+                                            const std::vector<MeshIO::IOElement> &elements) {
+    return triangulatedQuadGeometry([&](size_t v) -> Eigen::Vector3f { return vertices[v].point.cast<float>(); }, elements);
+}
+
 template<class Object>
 VisualizationGeometry getVisualizationGeometry(const Object &obj, const bool averagedMaterialFrames = true, const bool averagedCrossSections = true) {
     std::vector<MeshIO::IOVertex > vertices;
@@ -52,6 +59,18 @@ VisualizationGeometry getVisualizationGeometry(const Object &obj, const bool ave
 
 }
 
+// Same as getVisualizationGeometry for objects exposing the split
+// quads/positions interface (ElasticRod, RodLinkage): the positions are
+// evaluated directly in single precision, skipping the IOVertex copy.
+template<class Object>
+VisualizationGeometry getVisualizationGeometryFloat(const Object &obj, const bool averagedMaterialFrames = true, const bool averagedCrossSections = true) {
+    std::vector<MeshIO::IOElement> elements;
+    obj.visualizationQuads(elements);
+    std::vector<float> positions(3 * obj.numVisualizationVertices());
+    obj.visualizationPositions(positions.data(), nullptr, averagedMaterialFrames, averagedCrossSections);
+    return triangulatedQuadGeometry([&](size_t v) { return Eigen::Map<const Eigen::Vector3f>(positions.data() + 3 * v); }, elements);
+}
+
 // Replicate per-quad/quad-corner data to per-triangle/triangle-corner data
 template<class FieldType>
 Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic>
@@ -0,0 +1,114 @@
+#include <iostream>
+#include <MeshFEM/MeshIO.hh>
+#include "../RodLinkage.hh"
+#include "../multilevel_equilibrium.hh"
+#include "../adaptive_subdivision.hh"
+
+// Checks of the per-segment subdivision construction and of the state
+// transfers between discretizations (prolongateDeformedState, resubdivided).
+int numFailures = 0;
+
+void check(bool success, const std::string &what) {
+    std::cout << (success ? "PASS: " : "FAIL: ") << what << std::endl;
+    if (!success) ++numFailures;
+}
+
+template<class F>
+bool throws(F &&f) {
+    try { f(); }
+    catch (const std::runtime_error &e) { std::cout << "    (" << e.what() << ")" << std::endl; return true; }
+    return false;
+}
+
+bool relClose(Real a, Real b, Real tol) { return std::abs(a - b) <= tol * std::max(std::abs(a), std::abs(b)); }
+
+bool sameJointPositions(const RodLinkage &a, const RodLinkage &b, Real tol) {
+    const auto bJoint = multilevel_detail::jointCorrespondence(b, a);
+    for (size_t ji = 0; ji < a.numJoints(); ++ji)
+        if ((a.joint(ji).pos() - b.joint(bJoint[ji]).pos()).norm() > tol) return false;
+    return true;
+}
+
+int main(int argc, const char * argv[]) {
+    if (argc != 2) {
+        std::cout << "usage: " << argv[0] << " linkage.msh" << std::endl;
+        exit(-1);
+    }
+
+    std::vector<MeshIO::IOVertex > vertices;
+    std::vector<MeshIO::IOElement> edges;
+    MeshIO::load(argv[1], vertices, edges);
+
+    RodMaterial mat("rectangle", 20000, 0.3, {0.1, 0.01});
+
+    // A uniform per-segment subdivision reproduces the scalar `subdivision` construction.
+    RodLinkage scalar(vertices, edges, 10);
+    RodLinkage uniform(vertices, edges, std::vector<size_t>(edges.size(), 10));
+    scalar.setMaterial(mat);
+    uniform.setMaterial(mat);
+    check(scalar.getDoFs() == uniform.getDoFs(), "uniform segmentSubdivisions DoFs");
+    check(scalar.getPerSegmentRestLength() == uniform.getPerSegmentRestLength(), "uniform segmentSubdivisions rest lengths");
+
+    // Invalid subdivisions are rejected before any segment is built.
+    for (size_t bad : {0, 1, 6}) {
+        std::vector<size_t> subdivisions(edges.size(), 10);
+        subdivisions.back() = bad;
+        check(throws([&]() { RodLinkage l(vertices, edges, subdivisions); }), "subdivision " + std::to_string(bad) + " rejected");
+    }
+
+    // Deform the linkage away from its rest configuration.
+    RodLinkage linkage(scalar);
+    linkage.setDoFs(linkage.getDoFs() + 1e-3 * Eigen::VectorXd::Random(linkage.numDoF()));
+    linkage.updateSourceFrame();
+
+    // Prolongating onto an identical discretization reproduces the deformed state.
+    {
+        RodLinkage copy(vertices, edges, 10);
+        copy.setMaterial(mat);
+        prolongateDeformedState(linkage, copy);
+        check(sameJointPositions(linkage, copy, 1e-12), "identical prolongation joint positions");
+        check(relClose(linkage.energy(), copy.energy(), 1e-8), "identical prolongation energy");
+    }
+
+    // Prolongating onto a finer discretization (also renumbered) keeps the
+    // joints in place and approximates the deformed centerlines.
+    {
+        RodLinkage fine(vertices, edges, 20);
+        fine.setMaterial(mat);
+        fine.reorderForLocality();
+        prolongateDeformedState(linkage, fine);
+        check(sameJointPositions(linkage, fine, 1e-12), "fine prolongation joint positions");
+        std::cout << "Energy coarse " << linkage.energy() << ", prolongated " << fine.energy() << std::endl;
+    }
+
+    // resubdivided transfers the rest lengths and deformed state.
+    {
+        std::vector<size_t> subdivisions = segmentSubdivisions(linkage);
+        for (size_t i = 0; i < subdivisions.size(); i += 2) subdivisions[i] *= 2;
+        auto adapted = resubdivided(linkage, vertices, edges, subdivisions);
+        check(segmentSubdivisions(*adapted) == subdivisions, "resubdivided subdivisions");
+        check(sameJointPositions(linkage, *adapted, 1e-12), "resubdivided joint positions");
+
+        const auto oldSegment = multilevel_detail::segmentCorrespondence(linkage, *adapted);
+        bool sameRestLengths = true;
+        for (size_t si = 0; si < adapted->numSegments(); ++si)
+            sameRestLengths = sameRestLengths && relClose(adapted->getPerSegmentRestLength()[si], linkage.getPerSegmentRestLength()[oldSegment[si]], 1e-12);
+        check(sameRestLengths, "resubdivided per-segment rest lengths");
+    }
+
+    // Data that a re-discretization would lose is rejected.
+    {
+        RodLinkage stiffened(linkage);
+        stiffened.segment(0).rod.twistingStiffness(1) *= 2;
+        check(throws([&]() { resubdivided(stiffened, vertices, edges, segmentSubdivisions(stiffened)); }), "stiffened linkage rejected");
+
+        RodLinkage jointMaterials(linkage);
+        std::vector<RodMaterial> materials(jointMaterials.numJoints(), mat);
+        materials[0] = RodMaterial("rectangle", 20000, 0.3, {0.2, 0.01});
+        jointMaterials.setJointMaterials(materials);
+        check(throws([&]() { resubdivided(jointMaterials, vertices, edges, segmentSubdivisions(jointMaterials)); }), "joint materials rejected");
+    }
+
+    std::cout << numFailures << " failures" << std::endl;
+    return (numFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,45 @@
+#include <iostream>
+#include "../RodLinkage.hh"
+#include "../batched_hessvec.hh"
+#include <MeshFEM/GlobalBenchmark.hh>
+
+// Compare the batched autodiff Hessian-vector products against the analytic
+// Hessian matvecs, one direction at a time.
+int main(int argc, const char * argv[]) {
+    if (argc != 2) {
+        std::cout << "usage: " << argv[0] << " linkage.msh" << std::endl;
+        exit(-1);
+    }
+
+    std::cout.precision(19);
+
+    RodLinkage linkage(argv[1], 10);
+    RodMaterial mat("rectangle", 20000, 0.3, {0.1, 0.01});
+    linkage.setMaterial(mat);
+
+    // Perturb away from the rest configuration so that all energy terms contribute.
+    const size_t ndofs = linkage.numDoF();
+    linkage.setDoFs(linkage.getDoFs() + 1e-2 * Eigen::VectorXd::Random(ndofs));
+    linkage.updateSourceFrame();
+
+    RodLinkage_T<ADRealBatch> diff_linkage(linkage);
+
+    const int ndir = 2 * AD_BATCH_SIZE + 1; // exercise a partially filled batch
+    Eigen::MatrixXd V = Eigen::MatrixXd::Random(ndofs, ndir);
+
+    BENCHMARK_START_TIMER("Batched");
+    Eigen::MatrixXd HV = applyHessianBatched(linkage, diff_linkage, V);
+    BENCHMARK_STOP_TIMER("Batched");
+
+    BENCHMARK_START_TIMER("Per-direction");
+    Eigen::MatrixXd HV_ref(ndofs, ndir);
+    for (int k = 0; k < ndir; ++k)
+        HV_ref.col(k) = linkage.applyHessian(V.col(k));
+    BENCHMARK_STOP_TIMER("Per-direction");
+
+    std::cout << "Batched Hessian matvec relative error: " << (HV - HV_ref).norm() / HV_ref.norm() << std::endl;
+
+    BENCHMARK_REPORT();
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <iostream>
+#include "../RodLinkage.hh"
+#include "../compute_equilibrium.hh"
+#include <MeshFEM/DomainDecompositionSolver.hh>
+
+// Compare the domain decomposition solver against a single CHOLMOD
+// factorization on linkage Hessians: the solutions must agree for positive
+// definite systems, both solvers must reject non-positive definite ones (which
+// the Newton solver's Hessian shift relies on), and equilibrium solves using
+// either solver must reach the same equilibrium.
+int numFailures = 0;
+
+void check(bool success, const std::string &what) {
+    std::cout << (success ? "PASS: " : "FAIL: ") << what << std::endl;
+    if (!success) ++numFailures;
+}
+
+template<class F>
+bool throws(F &&f) {
+    try { f(); }
+    catch (const std::runtime_error &e) { std::cout << "    (" << e.what() << ")" << std::endl; return true; }
+    return false;
+}
+
+int main(int argc, const char * argv[]) {
+    if (argc != 2) {
+        std::cout << "usage: " << argv[0] << " linkage.msh" << std::endl;
+        exit(-1);
+    }
+
+    RodMaterial mat("rectangle", 20000, 0.3, {0.1, 0.01});
+    RodLinkage linkage(argv[1], 10);
+    linkage.setMaterial(mat);
+    linkage.setDoFs(linkage.getDoFs() + 1e-2 * Eigen::VectorXd::Random(linkage.numDoF()));
+
+    SuiteSparseMatrix H = linkage.hessianSparsityPattern();
+    linkage.hessian(H);
+
+    // The Hessian has rigid motion null modes (and may be indefinite away
+    // from equilibrium); shift it by a multiple of the identity that makes
+    // it safely positive definite.
+    const Real scale = H.data().cwiseAbs().maxCoeff();
+    SuiteSparseMatrix Hpd = H;
+    Hpd.addScaledIdentity(1e-2 * scale);
+    {
+        CholmodFactorizer cholmod(Hpd, false, /* force_ll = */ true);
+        cholmod.factorize();
+        const Eigen::VectorXd b = Eigen::VectorXd::Random(Hpd.m);
+        Eigen::VectorXd x_ref(Hpd.m);
+        cholmod.solve(b, x_ref);
+
+        for (size_t numSubdomains : {2, 4, 8}) {
+            DomainDecompositionSolver dd(Hpd, numSubdomains);
+            dd.factorize(Hpd);
+            const Eigen::VectorXd x = dd.solve(b);
+            std::cout << numSubdomains << " subdomains, interface size " << dd.interfaceSize()
+                      << ", relative error " << (x - x_ref).norm() / x_ref.norm() << std::endl;
+            check((x - x_ref).norm() <= 1e-8 * x_ref.norm(), "solution with " + std::to_string(numSubdomains) + " subdomains");
+        }
+    }
+
+    // Shifting by a large negative multiple of the identity makes the system
+    // indefinite; both solvers must detect this.
+    SuiteSparseMatrix Hindef = H;
+    Hindef.addScaledIdentity(-1e-2 * scale);
+    check(throws([&]() { CholmodFactorizer cholmod(Hindef, false, true); cholmod.factorize(); }), "CHOLMOD rejects indefinite system");
+    check(throws([&]() { DomainDecompositionSolver dd(Hindef, 4); dd.factorize(Hindef); }), "domain decomposition rejects indefinite system");
+
+    // Equilibrium solves through the Newton solver's domain decomposition path.
+    const size_t jdo = linkage.dofOffsetForJoint(linkage.centralJoint());
+    std::vector<size_t> rigidMotionFixedVars = { jdo + 0, jdo + 1, jdo + 2, jdo + 3, jdo + 4, jdo + 5 };
+    NewtonOptimizerOptions opts;
+    opts.gradTol = 1e-8;
+    opts.niter = 100;
+
+    RodLinkage direct(linkage), decomposed(linkage);
+    const auto reportDirect = compute_equilibrium(direct, opts, rigidMotionFixedVars);
+    opts.numSubdomains = 4;
+    const auto reportDecomposed = compute_equilibrium(decomposed, opts, rigidMotionFixedVars);
+    check(reportDirect.success && reportDecomposed.success, "equilibrium solves converged");
+    check(std::abs(direct.energy() - decomposed.energy()) <= 1e-8 * std::abs(direct.energy()), "equilibrium energies agree");
+
+    std::cout << numFailures << " failures" << std::endl;
+    return (numFailures == 0) ? 0 : 1;
+}
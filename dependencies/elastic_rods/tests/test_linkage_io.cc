@@ -0,0 +1,103 @@
+#include <iostream>
+#include <sstream>
+#include "../RodLinkage.hh"
+#include "../SurfaceAttractedLinkage.hh"
+#include "../PeriodicRod.hh"
+#include "../linkage_io.hh"
+
+// Save/load round trips of each object kind supported by LinkageBinaryIO,
+// checking that the DoFs, energy and gradient are reproduced, followed by
+// checks that corrupt data is rejected.
+int numFailures = 0;
+
+void check(bool success, const std::string &what) {
+    std::cout << (success ? "PASS: " : "FAIL: ") << what << std::endl;
+    if (!success) ++numFailures;
+}
+
+template<class Obj>
+void checkRoundTrip(const Obj &orig, const Obj &loaded, const std::string &name) {
+    check(orig.getDoFs() == loaded.getDoFs(), name + " DoFs");
+    check(std::abs(orig.energy() - loaded.energy()) <= 1e-12 * std::abs(orig.energy()), name + " energy");
+    const Eigen::VectorXd g = orig.gradient(), gl = loaded.gradient();
+    check((g - gl).norm() <= 1e-12 * std::max(g.norm(), 1.0), name + " gradient");
+}
+
+template<class F>
+void checkThrows(F &&f, const std::string &what) {
+    bool threw = false;
+    try { f(); }
+    catch (const std::runtime_error &e) { threw = true; std::cout << "    (" << e.what() << ")" << std::endl; }
+    check(threw, what);
+}
+
+int main(int argc, const char * argv[]) {
+    if (argc != 3) {
+        std::cout << "usage: " << argv[0] << " linkage.msh target_surface.obj" << std::endl;
+        exit(-1);
+    }
+
+    RodMaterial mat("rectangle", 20000, 0.3, {0.1, 0.01});
+
+    // Perturb away from the rest configuration so that all energy terms contribute.
+    RodLinkage linkage(argv[1], 10);
+    linkage.setMaterial(mat);
+    linkage.setDoFs(linkage.getDoFs() + 1e-2 * Eigen::VectorXd::Random(linkage.numDoF()));
+    {
+        std::istringstream is(serializeBinary(linkage));
+        checkRoundTrip(linkage, *LinkageBinaryIO::loadRodLinkage(is), "RodLinkage");
+    }
+
+    // Reordered linkages keep their correspondence with the original numbering.
+    RodLinkage reordered(linkage);
+    reordered.reorderForLocality();
+    {
+        std::istringstream is(serializeBinary(reordered));
+        auto loaded = LinkageBinaryIO::loadRodLinkage(is);
+        checkRoundTrip(reordered, *loaded, "Reordered RodLinkage");
+        check((loaded->originalJointIndices()   == reordered.originalJointIndices()) &&
+              (loaded->originalSegmentIndices() == reordered.originalSegmentIndices()), "Reordered RodLinkage original indices");
+        loaded->restoreOriginalOrder();
+        check((loaded->getDoFs() - linkage.getDoFs()).norm() <= 1e-12 * linkage.getDoFs().norm(), "Reordered RodLinkage restored order");
+    }
+
+    SurfaceAttractedLinkage sl(argv[2], true, argv[1], 10);
+    sl.setMaterial(mat);
+    sl.setDoFs(sl.getDoFs() + 1e-2 * Eigen::VectorXd::Random(sl.numDoF()));
+    {
+        std::istringstream is(serializeBinary(sl));
+        check(LinkageBinaryIO::peekKind(is) == LinkageBinaryIO::Kind::SurfaceAttractedLinkage, "peekKind");
+        checkRoundTrip(sl, *LinkageBinaryIO::loadSurfaceAttractedLinkage(is), "SurfaceAttractedLinkage");
+    }
+
+    // Closed helix-like curve whose first and last edges overlap.
+    const size_t n = 20;
+    std::vector<Point3D> pts;
+    for (size_t i = 0; i < n + 2; ++i) {
+        const Real t = 2 * M_PI * (i % n) / n;
+        pts.emplace_back(std::cos(t), std::sin(t), 0.1 * std::sin(3 * t));
+    }
+    PeriodicRod prod(pts);
+    prod.rod.setMaterial(mat);
+    prod.setDoFs(prod.getDoFs() + 1e-2 * Eigen::VectorXd::Random(prod.getDoFs().size()));
+    {
+        std::istringstream is(serializeBinary(prod));
+        checkRoundTrip(prod, *LinkageBinaryIO::loadPeriodicRod(is), "PeriodicRod");
+    }
+
+    // A segment referencing a nonexistent joint must be rejected on load.
+    RodLinkage corrupt(linkage);
+    corrupt.segment(0).startJoint = corrupt.numJoints() + 1;
+    const std::string corruptData = serializeBinary(corrupt);
+    checkThrows([&]() { std::istringstream is(corruptData); LinkageBinaryIO::loadRodLinkage(is); }, "invalid segment joint index rejected");
+
+    // peekKind leaves the stream position unchanged even when it throws.
+    {
+        std::istringstream is("not a linkage binary file");
+        checkThrows([&]() { LinkageBinaryIO::peekKind(is); }, "peekKind rejects foreign data");
+        check(is.good() && (is.tellg() == std::streampos(0)), "peekKind restores the stream position");
+    }
+
+    std::cout << numFailures << " failures" << std::endl;
+    return (numFailures == 0) ? 0 : 1;
+}
@@ -5,6 +5,9 @@
 #include "../restlen_solve.hh"
 #include "../compute_equilibrium.hh"
 #include "../open_linkage.hh"
+#include "../bound_constrained_optimizer.hh"
+
+#if HAS_KNITRO
 #include "../knitro.hh"
 
 struct ActuationSparsifyingKnitroProblem : public KnitroProblem<ActuationSparsifyingKnitroProblem> {
@@ -94,6 +97,7 @@ struct ActuationSparsifyingKnitroNewPtCallback : public NewPtCallbackBase {
 private:
     ActuationSparsifier &m_sparsifier;
 };
+#endif // HAS_KNITRO
 
 void sparsify(RodLinkage &linkage, NewtonOptimizer &opt,
               Real eta, Real p) {
@@ -107,6 +111,7 @@ void sparsify(RodLinkage &linkage, NewtonOptimizer &opt,
     // Run optimization
     ////////////////////////////////////////////////////////////////////////////
     int num_steps = 5000;
+#if HAS_KNITRO
     ActuationSparsifyingKnitroProblem problem(sparsifier);
     std::vector<Real> x_init(sparsifier.numVars());
     Eigen::Map<Eigen::VectorXd>(x_init.data(), x_init.size()) = sparsifier.initialVarsFromElasticForces(linkage.gradient());
@@ -148,6 +153,23 @@ void sparsify(RodLinkage &linkage, NewtonOptimizer &opt,
     }
     problem.setNewPointCallback(nullptr);
 
+#else
+    // Without Knitro, use the native trust-region Newton-CG (the torques are
+    // only bound to be nonnegative for the L1/LP regularizations).
+    Eigen::VectorXd vars = sparsifier.initialVarsFromElasticForces(linkage.gradient());
+    Eigen::VectorXd lb = Eigen::VectorXd::Zero(vars.size()),
+                    ub = Eigen::VectorXd::Constant(vars.size(), std::numeric_limits<Real>::infinity());
+    BoundConstrainedOptimizerOptions opts;
+    opts.niter = num_steps;
+    opts.gradTol = 1e-6;
+
+    BENCHMARK_RESET();
+    auto solveStatus = trust_region_newton_cg_optimize(sparsifier, vars, lb, ub, opts);
+    BENCHMARK_REPORT_NO_MESSAGES();
+    if (solveStatus != BoundConstrainedStatus::CONVERGED)
+        std::cout << "Native optimizer failed to solve the problem, final status = " << int(solveStatus) << std::endl;
+#endif
+
     {
         std::ofstream outFile("torques.txt");
         outFile << sparsifier.extractTorques(linkage.gradient());
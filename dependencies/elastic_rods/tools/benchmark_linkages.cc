@@ -0,0 +1,290 @@
+////////////////////////////////////////////////////////////////////////////////
+// benchmark_linkages.cc
+////////////////////////////////////////////////////////////////////////////////
+/*! @file
+//  Reproducible performance benchmark over a set of linkages (e.g., the
+//  bundled examples/*.obj) at several subdivision levels. For each case it
+//  times the core kernels (setDoFs, gradient, Hessian assembly), a full
+//  deployment equilibrium solve (broken down into Hessian evaluation,
+//  factorization, back-substitution and line search using the profiler's
+//  Newton solver sections) and, optionally, a few weaving design
+//  optimization iterations. The results are written as JSON and can be
+//  compared against a stored baseline. A case that throws is recorded as a
+//  failure (with its error message) and counts as a regression; the exit
+//  code is 1 if any case failed or any timing regressed beyond the
+//  tolerances.
+*/
+////////////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <nlohmann/json.hpp>
+#include <MeshFEM/Profiler.hh>
+#include "../RodLinkage.hh"
+#include "../SurfaceAttractedLinkage.hh"
+#include "../restlen_solve.hh"
+#include "../compute_equilibrium.hh"
+#include "../infer_target_surface.hh"
+#include "../weaving_worker.hh"
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+struct BenchmarkOptions {
+    std::string crossSectionPath;
+    std::string outputPath = "benchmark_results.json";
+    std::string baselinePath;
+    std::vector<size_t> subdivisions{5, 10, 20};
+    size_t repeats = 5;
+    size_t designIterations = 0;
+    Real deploymentAngle = 0.2; // increment of the average joint angle for the equilibrium solve
+    Real relTol = 0.10;         // a timing regresses if it exceeds baseline * (1 + relTol) + absTol
+    Real absTol = 1e-3;         // seconds
+    std::vector<std::string> linkagePaths;
+};
+
+static void usage() {
+    std::cout << "Usage: benchmark_linkages [options] cross_section.json linkage1.obj [linkage2.obj ...]" << std::endl;
+    std::cout << "  -o results.json          output file (default: benchmark_results.json)" << std::endl;
+    std::cout << "  -b baseline.json         compare against a previous results file" << std::endl;
+    std::cout << "  -s 5,10,20               subdivision levels" << std::endl;
+    std::cout << "  -r 5                     repetitions of each kernel timing (the median is reported)" << std::endl;
+    std::cout << "  -d 0                     number of weaving design optimization iterations to time" << std::endl;
+    std::cout << "  -a 0.2                   deployment angle increment for the equilibrium solve" << std::endl;
+    std::cout << "  --rel-tol 0.1            relative tolerance of the baseline comparison" << std::endl;
+    std::cout << "  --abs-tol 1e-3           absolute tolerance (seconds) of the baseline comparison" << std::endl;
+    exit(-1);
+}
+
+static std::vector<size_t> parseList(const std::string &str) {
+    std::vector<size_t> result;
+    size_t start = 0;
+    while (start < str.size()) {
+        size_t end = str.find(',', start);
+        if (end == std::string::npos) end = str.size();
+        result.push_back(std::stoul(str.substr(start, end - start)));
+        start = end + 1;
+    }
+    return result;
+}
+
+static BenchmarkOptions parseOptions(int argc, const char *argv[]) {
+    BenchmarkOptions opts;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        auto value = [&]() -> std::string { if (i + 1 >= argc) usage(); return argv[++i]; };
+        if      (arg == "-o")        opts.outputPath       = value();
+        else if (arg == "-b")        opts.baselinePath     = value();
+        else if (arg == "-s")        opts.subdivisions     = parseList(value());
+        else if (arg == "-r")        opts.repeats          = std::stoul(value());
+        else if (arg == "-d")        opts.designIterations = std::stoul(value());
+        else if (arg == "-a")        opts.deploymentAngle  = std::stod(value());
+        else if (arg == "--rel-tol") opts.relTol           = std::stod(value());
+        else if (arg == "--abs-tol") opts.absTol           = std::stod(value());
+        else if (arg[0] == '-') usage();
+        else positional.push_back(arg);
+    }
+    if (positional.size() < 2) usage();
+    opts.crossSectionPath = positional[0];
+    opts.linkagePaths.assign(positional.begin() + 1, positional.end());
+    if (opts.repeats == 0) opts.repeats = 1;
+    return opts;
+}
+
+static double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Median wall time of `repeats` calls to `f`.
+template<typename F>
+double medianTime(size_t repeats, F &&f) {
+    std::vector<double> times;
+    for (size_t i = 0; i < repeats; ++i) {
+        auto start = Clock::now();
+        f();
+        times.push_back(secondsSince(start));
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+// Total time spent in sections named `name` anywhere in the profiler tree.
+static double sectionTime(const Profiler::Node &node, const std::string &name) {
+    double result = (node.name == name) ? node.seconds : 0.0;
+    for (const auto &c : node.children) result += sectionTime(c, name);
+    return result;
+}
+
+static std::string baseName(const std::string &path) {
+    const size_t pos = path.find_last_of("/\\");
+    return (pos == std::string::npos) ? path : path.substr(pos + 1);
+}
+
+static json benchmarkCase(const std::string &linkagePath, size_t subdivision, const RodMaterial &mat, const BenchmarkOptions &opts) {
+    json result;
+    result["linkage"]     = baseName(linkagePath);
+    result["subdivision"] = subdivision;
+    json &metrics = result["metrics"];
+    json &info    = result["info"];
+
+    auto start = Clock::now();
+    RodLinkage linkage(linkagePath, subdivision);
+    linkage.setMaterial(mat);
+    metrics["construction"] = secondsSince(start);
+    info["numDoF"]      = linkage.numDoF();
+    info["numSegments"] = linkage.numSegments();
+    info["numJoints"]   = linkage.numJoints();
+
+    start = Clock::now();
+    restlen_solve(linkage);
+    metrics["restlen_solve"] = secondsSince(start);
+
+    const Eigen::VectorXd dofs = linkage.getDoFs();
+    metrics["setDoFs"]  = medianTime(opts.repeats, [&]() { linkage.setDoFs(dofs); });
+    metrics["gradient"] = medianTime(opts.repeats, [&]() { linkage.gradient(); });
+    auto H = linkage.hessianSparsityPattern();
+    metrics["hessian"]  = medianTime(opts.repeats, [&]() { H.setZero(); linkage.hessian(H); });
+
+    // Deployment solve, with rigid motion pinned at the central joint.
+    const size_t jdo = linkage.dofOffsetForJoint(linkage.centralJoint());
+    const std::vector<size_t> fixedVars = { jdo + 0, jdo + 1, jdo + 2, jdo + 3, jdo + 4, jdo + 5 };
+    NewtonOptimizerOptions eopts;
+    eopts.beta = 1e-8;
+    eopts.gradTol = 1e-8;
+    eopts.niter = 100;
+    eopts.verboseNonPosDef = false;
+
+    const bool wasEnabled = Profiler::enabled();
+    Profiler::setEnabled(true);
+    Profiler::reset();
+    start = Clock::now();
+    auto report = compute_equilibrium(linkage, linkage.getAverageJointAngle() + opts.deploymentAngle, eopts, fixedVars);
+    metrics["equilibrium_solve"] = secondsSince(start);
+    const Profiler::Node profile = Profiler::report();
+    Profiler::setEnabled(wasEnabled);
+
+    const double newtonSolve = sectionTime(profile, "Newton solve"),
+                 backSolve   = sectionTime(profile, "Solve");
+    metrics["solve_hessian_eval"]  = sectionTime(profile, "hessEval");
+    metrics["solve_factorization"] = newtonSolve - backSolve;
+    metrics["solve_backsolve"]     = backSolve;
+    metrics["solve_line_search"]   = sectionTime(profile, "Backtracking");
+    info["newton_iterations"] = report.numIters();
+    info["converged"]         = report.success;
+
+    if (opts.designIterations > 0) {
+        Eigen::MatrixXd targetV;
+        Eigen::MatrixXi targetF;
+        infer_target_surface(linkage, targetV, targetF);
+        SurfaceAttractedLinkage sal(Eigen::MatrixX3d(targetV), Eigen::MatrixX3i(targetF), true, linkage);
+        sal.setDesignParameterConfig(true, true);
+
+        WeavingJob job;
+        job.numSteps = opts.designIterations;
+        std::vector<double> iterateTimes;
+        auto last = Clock::now();
+        start = last;
+        runWeavingJob(sal, job, [&](const WeavingIterate &it) {
+            if (it.iteration > 0) iterateTimes.push_back(secondsSince(last)); // iterate 0 is the initial design
+            last = Clock::now();
+            return false;
+        });
+        metrics["design_optimization"] = secondsSince(start);
+        if (!iterateTimes.empty())
+            metrics["design_iteration"] = std::accumulate(iterateTimes.begin(), iterateTimes.end(), 0.0) / iterateTimes.size();
+        info["design_iterations"] = iterateTimes.size();
+    }
+
+    return result;
+}
+
+static std::string caseKey(const json &c) {
+    return c.at("linkage").get<std::string>() + "@" + std::to_string(c.at("subdivision").get<size_t>());
+}
+
+// Print the comparison of `results` against `baseline`; returns the number of
+// regressions (failed cases included).
+static size_t compareToBaseline(const json &results, const json &baseline, const BenchmarkOptions &opts) {
+    std::map<std::string, const json *> baselineCases;
+    for (const auto &c : baseline.at("cases")) baselineCases[caseKey(c)] = &c;
+
+    size_t regressions = 0;
+    std::cout << "case\tmetric\tbaseline\tcurrent\tratio" << std::endl;
+    for (const auto &c : results.at("cases")) {
+        if (c.count("error")) {
+            ++regressions;
+            std::cout << caseKey(c) << "\t(failed: " << c.at("error").get<std::string>() << ")\tREGRESSION" << std::endl;
+            continue;
+        }
+        auto it = baselineCases.find(caseKey(c));
+        if (it == baselineCases.end()) { std::cout << caseKey(c) << "\t(not in baseline)" << std::endl; continue; }
+        const json &baselineMetrics = it->second->at("metrics");
+        for (const auto &m : c.at("metrics").items()) {
+            if (!baselineMetrics.count(m.key())) continue;
+            const double b = baselineMetrics.at(m.key()).get<double>(),
+                         t = m.value().get<double>();
+            const bool regressed = t > b * (1 + opts.relTol) + opts.absTol;
+            if (regressed) ++regressions;
+            std::cout << caseKey(c) << '\t' << m.key() << '\t' << b << '\t' << t << '\t' << ((b > 0) ? t / b : 0.0)
+                      << (regressed ? "\tREGRESSION" : "") << std::endl;
+        }
+    }
+    return regressions;
+}
+
+int main(int argc, const char *argv[]) {
+    const BenchmarkOptions opts = parseOptions(argc, argv);
+
+    RodMaterial mat;
+    if (opts.crossSectionPath.substr(opts.crossSectionPath.size() - 4) == "json") {
+        mat.set(*CrossSection::load(opts.crossSectionPath), RodMaterial::StiffAxis::D1, false);
+    }
+    else {
+        mat.setContour(20000, 0.3, opts.crossSectionPath, 1.0, RodMaterial::StiffAxis::D1);
+    }
+
+    json results;
+    results["cross_section"] = baseName(opts.crossSectionPath);
+    results["repeats"]       = opts.repeats;
+    results["cases"]         = json::array();
+    size_t failures = 0;
+    for (const auto &path : opts.linkagePaths) {
+        for (size_t subdivision : opts.subdivisions) {
+            std::cout << "Benchmarking " << baseName(path) << " at subdivision " << subdivision << std::endl;
+            try {
+                results["cases"].push_back(benchmarkCase(path, subdivision, mat, opts));
+            }
+            catch (const std::exception &e) {
+                std::cerr << "FAILED " << path << " (subdivision " << subdivision << "): " << e.what() << std::endl;
+                json failed;
+                failed["linkage"]     = baseName(path);
+                failed["subdivision"] = subdivision;
+                failed["error"]       = e.what();
+                failed["metrics"]     = json::object();
+                results["cases"].push_back(failed);
+                ++failures;
+            }
+        }
+    }
+
+    {
+        std::ofstream outFile(opts.outputPath);
+        if (!outFile.is_open()) throw std::runtime_error("Couldn't write results to " + opts.outputPath);
+        outFile << results.dump(4) << std::endl;
+    }
+
+    if (failures > 0) std::cout << failures << " failed case(s)" << std::endl;
+    if (opts.baselinePath.empty()) return (failures > 0) ? 1 : 0;
+
+    std::ifstream baselineFile(opts.baselinePath);
+    if (!baselineFile.is_open()) throw std::runtime_error("Couldn't open baseline " + opts.baselinePath);
+    json baseline;
+    baselineFile >> baseline;
+    const size_t regressions = compareToBaseline(results, baseline, opts);
+    std::cout << regressions << " regression(s)" << std::endl;
+    return ((regressions > 0) || (failures > 0)) ? 1 : 0;
+}
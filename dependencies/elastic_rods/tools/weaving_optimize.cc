@@ -0,0 +1,42 @@
+#include <iostream>
+#include "../SurfaceAttractedLinkage.hh"
+#include "../weaving_worker.hh"
+
+int main(int argc, const char *argv[]) {
+    if ((argc < 5) || (argc > 6)) {
+        std::cout << "Usage: weaving_optimize linkage.obj cross_section.json target_surface.obj job.json [output_dir]" << std::endl;
+        std::cout << "  Each accepted iterate is written to output_dir/iterate_<k>.txt and logged in output_dir/iterates.log;" << std::endl;
+        std::cout << "  the optimized linkage is saved to output_dir/optimized.msh." << std::endl;
+        exit(-1);
+    }
+
+    const std::string linkage_path(argv[1]),
+                cross_section_path(argv[2]),
+                surface_path(argv[3]),
+                job_path(argv[4]),
+                output_dir((argc == 6) ? argv[5] : ".");
+
+    WeavingJob job = WeavingJob::load(job_path);
+
+    SurfaceAttractedLinkage linkage(surface_path, job.useCenterline, linkage_path, 10, false, InterleavingType::weaving);
+
+    RodMaterial mat;
+    if (cross_section_path.substr(cross_section_path.size() - 4) == "json") {
+        mat.set(*CrossSection::load(cross_section_path), RodMaterial::StiffAxis::D1, false);
+    }
+    else {
+        mat.setContour(20000, 0.3, cross_section_path, 1.0, RodMaterial::StiffAxis::D1);
+    }
+    linkage.setMaterial(mat);
+    linkage.setDesignParameterConfig(true, true);
+
+    std::cout << "Optimizing weaving with " << linkage.numSegments() << " segments, " << linkage.numJoints() << " joints, and " << linkage.numDoF() << " DoF." << std::endl;
+
+    BENCHMARK_RESET();
+    const int status = runWeavingJob(linkage, job, weavingIterateFileWriter(output_dir));
+    BENCHMARK_REPORT_NO_MESSAGES();
+
+    linkage.saveVisualizationGeometry(output_dir + "/optimized.msh");
+
+    return status;
+}
@@ -0,0 +1,130 @@
+#include "weaving_worker.hh"
+#include "WeavingOptimization.hh"
+
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iomanip>
+
+using json = nlohmann::json;
+
+static OptAlgorithm parseOptAlgorithm(const std::string &name) {
+    if (name == "NEWTON_CG")        return OptAlgorithm::NEWTON_CG;
+    if (name == "BFGS")             return OptAlgorithm::BFGS;
+    if (name == "NATIVE_NEWTON_CG") return OptAlgorithm::NATIVE_NEWTON_CG;
+    if (name == "NATIVE_LBFGSB")    return OptAlgorithm::NATIVE_LBFGSB;
+    throw std::runtime_error("Unknown optimization algorithm '" + name + "'");
+}
+
+template<typename T>
+static void readOptional(const json &config, const char *key, T &val) {
+    if (config.count(key)) val = config.at(key).get<T>();
+}
+
+WeavingJob WeavingJob::load(const std::string &path) {
+    std::ifstream inFile(path);
+    if (!inFile.is_open()) throw std::runtime_error("Couldn't open weaving job file " + path);
+    json config;
+    inFile >> config;
+
+    WeavingJob job;
+    if (config.count("target_surface")) {
+        std::string surfacePath = config.at("target_surface").get<std::string>();
+        const size_t dirEnd = path.find_last_of("/\\");
+        if (!surfacePath.empty() && (surfacePath[0] != '/') && (dirEnd != std::string::npos))
+            surfacePath = path.substr(0, dirEnd + 1) + surfacePath;
+
+        std::vector<MeshIO::IOVertex > vertices;
+        std::vector<MeshIO::IOElement> elements;
+        MeshIO::load(surfacePath, vertices, elements);
+        job.targetV.resize(vertices.size(), 3);
+        job.targetF.resize(elements.size(), 3);
+        for (size_t i = 0; i < vertices.size(); ++i) job.targetV.row(i) = vertices[i].point.transpose();
+        for (size_t i = 0; i < elements.size(); ++i) {
+            if (elements[i].size() != 3) throw std::runtime_error("Target surface must be a triangle mesh");
+            for (size_t j = 0; j < 3; ++j) job.targetF(i, j) = elements[i][j];
+        }
+    }
+    readOptional(config, "use_centerline", job.useCenterline);
+
+    if (config.count("weights")) {
+        const auto &w = config.at("weights");
+        readOptional(w, "beta",                     job.beta);
+        readOptional(w, "gamma",                    job.gamma);
+        readOptional(w, "rest_length_minimization", job.restLengthMinimizationWeight);
+        readOptional(w, "rest_kappa_smoothing",     job.restKappaSmoothingWeight);
+        readOptional(w, "contact_force",            job.contactForceWeight);
+        readOptional(w, "attraction",               job.attractionWeight);
+    }
+
+    if (config.count("optimizer")) {
+        const auto &o = config.at("optimizer");
+        if (o.count("algorithm")) job.algorithm = parseOptAlgorithm(o.at("algorithm").get<std::string>());
+        readOptional(o, "num_steps",          job.numSteps);
+        readOptional(o, "trust_region_scale", job.trustRegionScale);
+        readOptional(o, "optimality_tol",     job.optimalityTol);
+        readOptional(o, "min_rest_length",    job.minRestLen);
+    }
+
+    if (config.count("equilibrium")) {
+        const auto &e = config.at("equilibrium");
+        readOptional(e, "grad_tol", job.equilibriumOptions.gradTol);
+        readOptional(e, "beta",     job.equilibriumOptions.beta);
+        readOptional(e, "niter",    job.equilibriumOptions.niter);
+        readOptional(e, "verbose",  job.equilibriumOptions.verbose);
+    }
+
+    readOptional(config, "pin_joint",       job.pinJoint);
+    readOptional(config, "use_fixed_joint", job.useFixedJoint);
+    readOptional(config, "fixed_vars",      job.fixedVars);
+
+    return job;
+}
+
+int runWeavingJob(SurfaceAttractedLinkage &linkage, const WeavingJob &job, const WeavingIterateCallback &callback) {
+    if (job.attractionWeight >= 0) linkage.attraction_weight = job.attractionWeight;
+
+    const bool hasTarget = job.targetV.rows() > 0;
+    const Eigen::MatrixXd targetV = hasTarget ? job.targetV : linkage.getTargetSurfaceVertices();
+    const Eigen::MatrixXi targetF = hasTarget ? job.targetF : linkage.getTargetSurfaceFaces();
+    if ((targetV.rows() == 0) || (targetF.rows() == 0)) throw std::runtime_error("Weaving job has no target surface");
+
+    WeavingOptimization<SurfaceAttractedLinkage_T> optimizer(linkage, targetV, targetF, job.useCenterline, job.equilibriumOptions,
+                                                             job.pinJoint, job.useFixedJoint, job.fixedVars);
+    optimizer.setBeta(job.beta);
+    optimizer.setGamma(job.gamma);
+    optimizer.setRestLengthMinimizationWeight(job.restLengthMinimizationWeight);
+    optimizer.setRestKappaSmoothingWeight(job.restKappaSmoothingWeight);
+    optimizer.setContactForceWeight(job.contactForceWeight);
+    optimizer.invalidateAdjointState();
+
+    size_t iteration = 0;
+    std::function<void()> reportIterate = [&]() {
+        if (!callback) return;
+        WeavingIterate it;
+        it.iteration        = iteration++;
+        it.J                = optimizer.J();
+        it.J_target         = optimizer.J_target();
+        it.designParameters = optimizer.params();
+        it.dofs             = linkage.getDoFs();
+        if (callback(it)) optimizer.requestTermination();
+    };
+
+    reportIterate(); // initial design
+    return optimizer.optimize(job.algorithm, job.numSteps, job.trustRegionScale, job.optimalityTol, reportIterate, job.minRestLen);
+}
+
+WeavingIterateCallback weavingIterateFileWriter(const std::string &directory) {
+    return [directory](const WeavingIterate &it) {
+        {
+            std::ofstream outFile(directory + "/iterate_" + std::to_string(it.iteration) + ".txt");
+            if (!outFile.is_open()) throw std::runtime_error("Couldn't write iterate to " + directory);
+            outFile << std::setprecision(17);
+            outFile << it.designParameters.transpose() << std::endl;
+            outFile << it.dofs.transpose() << std::endl;
+        }
+        // The log line is written last so that a reader never sees an incomplete iterate file.
+        std::ofstream logFile(directory + "/iterates.log", std::ios::app);
+        logFile << std::setprecision(17) << it.iteration << '\t' << it.J << '\t' << it.J_target << std::endl;
+        return false;
+    };
+}
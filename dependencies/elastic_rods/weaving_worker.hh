@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////
+// weaving_worker.hh
+////////////////////////////////////////////////////////////////////////////////
+/*! @file
+//  Run a complete weaving design optimization job in-process: build a
+//  WeavingOptimization for a surface-attracted linkage, configure the
+//  objective weights, run the optimizer and report every accepted iterate.
+//  This is the native counterpart of shipping the job to a remote Python
+//  server; it is exposed through the C API (erodWeavingOptimize) and the
+//  `weaving_optimize` command line tool.
+*/
+////////////////////////////////////////////////////////////////////////////////
+#ifndef WEAVING_WORKER_HH
+#define WEAVING_WORKER_HH
+
+#include "SurfaceAttractedLinkage.hh"
+#include "LinkageOptimization.hh"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+struct WeavingJob {
+    // Target surface (triangle mesh). Leave empty to use the linkage's own
+    // target surface fitter unchanged (e.g., one set up with a surface path).
+    Eigen::MatrixXd targetV;
+    Eigen::MatrixXi targetF;
+    bool useCenterline = true;
+
+    // Objective weights (same meaning as the WeavingOptimization setters).
+    Real beta                         = 500000.0;
+    Real gamma                        = 1.0;
+    Real restLengthMinimizationWeight = 1.0;
+    Real restKappaSmoothingWeight     = 10.0;
+    Real contactForceWeight           = 0.0;
+    Real attractionWeight             = 1e-5; // negative: keep the linkage's current attraction weight
+
+    // Optimizer configuration.
+    OptAlgorithm algorithm = OptAlgorithm::NATIVE_NEWTON_CG;
+    size_t numSteps        = 2000;
+    Real trustRegionScale  = 1.0;
+    Real optimalityTol     = 1e-2;
+    Real minRestLen        = -1;
+
+    // Equilibrium solver and rigid motion constraints.
+    NewtonOptimizerOptions equilibriumOptions = defaultEquilibriumOptions();
+    int pinJoint       = -1;
+    bool useFixedJoint = true;
+    std::vector<size_t> fixedVars;
+
+    static NewtonOptimizerOptions defaultEquilibriumOptions() {
+        NewtonOptimizerOptions eopts;
+        eopts.gradTol = 1e-6;
+        eopts.beta    = 1e-8;
+        eopts.niter   = 25;
+        eopts.verboseNonPosDef = false;
+        return eopts;
+    }
+
+    // Read the job configuration from a JSON file; all entries are optional:
+    //  { "target_surface": "surface.obj", "use_centerline": true,
+    //    "weights":     { "beta", "gamma", "rest_length_minimization", "rest_kappa_smoothing", "contact_force", "attraction" },
+    //    "optimizer":   { "algorithm": "NATIVE_NEWTON_CG" | "NATIVE_LBFGSB" | "NEWTON_CG" | "BFGS",
+    //                     "num_steps", "trust_region_scale", "optimality_tol", "min_rest_length" },
+    //    "equilibrium": { "grad_tol", "beta", "niter", "verbose" },
+    //    "pin_joint", "use_fixed_joint", "fixed_vars" }
+    // A relative "target_surface" path is resolved relative to the JSON file.
+    static WeavingJob load(const std::string &path);
+};
+
+// State reported after each accepted design iterate.
+struct WeavingIterate {
+    size_t iteration;
+    Real J, J_target;
+    Eigen::VectorXd designParameters;
+    Eigen::VectorXd dofs; // equilibrium DoFs of the linkage at `designParameters`
+};
+
+// Return `true` to stop the optimization after this iterate.
+using WeavingIterateCallback = std::function<bool(const WeavingIterate &)>;
+
+// Run the weaving optimization described by `job` on `linkage`, which is
+// updated in place with the optimized design and its equilibrium. Returns the
+// optimizer's status (0 on success, BoundConstrainedStatus::USER_TERMINATION
+// when stopped by the callback).
+int runWeavingJob(SurfaceAttractedLinkage &linkage, const WeavingJob &job,
+                  const WeavingIterateCallback &callback = nullptr);
+
+// Callback writing each iterate to `<directory>/iterate_<k>.txt` (design
+// parameters and DoFs) and appending a line to `<directory>/iterates.log`, so
+// that a parent process can follow a worker running as a subprocess.
+WeavingIterateCallback weavingIterateFileWriter(const std::string &directory);
+
+#endif /* end of include guard: WEAVING_WORKER_HH */
@@ -115,6 +115,10 @@ namespace ErodModelLib.Creators
             [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetRodTraceCount")]
             internal static extern int ErodXShellGetRodTraceCount(IntPtr linkage, out IntPtr errorMessage);
 
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetRodSegmentTable")]
+            internal static extern int ErodXShellGetRodSegmentTable(IntPtr linkage, out IntPtr outSegmentIndexes, out IntPtr outRodOffsets, out IntPtr outRodTypes, out long numRods, out long numSegments, out IntPtr errorMessage);
+
             [SuppressUnmanagedCodeSecurity]
             [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellRemoveRestCurvatures")]
             internal static extern double ErodXShellRemoveRestCurvatures(IntPtr linkage);
@@ -211,6 +215,134 @@ namespace ErodModelLib.Creators
             [SuppressUnmanagedCodeSecurity]
             [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetJointAngles")]
             internal static extern void ErodXShellGetJointAngles(IntPtr linkage, out IntPtr outAngles, out long numAngles);
+
+            // Bulk export
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetSegmentOffsets")]
+            internal static extern void ErodXShellGetSegmentOffsets(IntPtr linkage, out IntPtr outVertexOffsets, out IntPtr outEdgeOffsets, out long numOffsets);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetSegmentsCenterLinePositions")]
+            internal static extern void ErodXShellGetSegmentsCenterLinePositions(IntPtr linkage, out IntPtr outCoords, out long numCoords);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetSegmentsMaterialFrames")]
+            internal static extern void ErodXShellGetSegmentsMaterialFrames(IntPtr linkage, out IntPtr outCoordsD1, out IntPtr outCoordsD2, out long numCoords);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetSegmentsRestData")]
+            internal static extern void ErodXShellGetSegmentsRestData(IntPtr linkage, out IntPtr outRestLengths, out IntPtr outRestKappas, out IntPtr outRestTwists,
+                                                                      out IntPtr outRestPoints, out IntPtr outRestDirectors, out long numEdges, out long numVertices);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetSegmentsStiffnesses")]
+            internal static extern void ErodXShellGetSegmentsStiffnesses(IntPtr linkage, out IntPtr outBendingStiffness, out IntPtr outTwistingStiffness, out IntPtr outStretchingStiffness,
+                                                                         out long numEdges, out long numVertices);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetJointsData")]
+            internal static extern void ErodXShellGetJointsData(IntPtr linkage, out IntPtr outPositions, out IntPtr outNormals, out IntPtr outEdgeVecsA, out IntPtr outEdgeVecsB,
+                                                                out IntPtr outOmegas, out IntPtr outSourceTangents, out IntPtr outSourceNormals, out IntPtr outAngles, out IntPtr outLengths,
+                                                                out IntPtr outSegments, out IntPtr outTypes, out long numJoints);
+
+            // Caller-provided buffers (return 0 on success, 1 on a size mismatch)
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetMeshDataCount")]
+            internal static extern void ErodXShellGetMeshDataCount(IntPtr linkage, out long numCoords, out long numQuads);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetScalarFieldCount")]
+            internal static extern long ErodXShellGetScalarFieldCount(IntPtr linkage);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetRestLengthsSolveDoFCount")]
+            internal static extern long ErodXShellGetRestLengthsSolveDoFCount(IntPtr linkage);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillDoFs")]
+            internal static extern int ErodXShellFillDoFs(IntPtr linkage, [Out] double[] outDoFs, long numDoFs);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillCenterLinePositions")]
+            internal static extern int ErodXShellFillCenterLinePositions(IntPtr linkage, [Out] double[] outCoords, long numCoords);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillMeshData")]
+            internal static extern int ErodXShellFillMeshData(IntPtr linkage, [Out] double[] outCoords, [Out] int[] outQuads, long numCoords, long numQuads);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillMeshConnectivity")]
+            internal static extern int ErodXShellFillMeshConnectivity(IntPtr linkage, [Out] int[] outQuads, long numQuads);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillMeshPositions")]
+            internal static extern int ErodXShellFillMeshPositions(IntPtr linkage, [Out] double[] outCoords, [Out] double[] outNormals, long numCoords);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillScalarField")]
+            internal static extern int ErodXShellFillScalarField(IntPtr linkage, int fieldType, [Out] double[] outField, long numField);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillScalarFields")]
+            internal static extern int ErodXShellFillScalarFields(IntPtr linkage, [Out] double[] outSqrtBendingEnergies, [Out] double[] outMaxBendingStresses, [Out] double[] outMinBendingStresses,
+                                                                  [Out] double[] outVonMisesStresses, [Out] double[] outTwistingStresses, [Out] double[] outStretchingStresses, long numField, long numEdgeField);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillDesignParams")]
+            internal static extern int ErodXShellFillDesignParams(IntPtr linkage, [Out] double[] outDesignParams, long numDesignParams);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillRestKappaVars")]
+            internal static extern int ErodXShellFillRestKappaVars(IntPtr linkage, [Out] double[] outData, long numData);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillPerSegmentRestLengths")]
+            internal static extern int ErodXShellFillPerSegmentRestLengths(IntPtr linkage, [Out] double[] outLengths, long numLengths);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillRestLengthsSolveDoFs")]
+            internal static extern int ErodXShellFillRestLengthsSolveDoFs(IntPtr linkage, [Out] double[] outDoFs, long numDoFs);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillJointAngles")]
+            internal static extern int ErodXShellFillJointAngles(IntPtr linkage, [Out] double[] outAngles, long numAngles);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillSegmentsCenterLinePositions")]
+            internal static extern int ErodXShellFillSegmentsCenterLinePositions(IntPtr linkage, [Out] double[] outCoords, long numCoords);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillSegmentsMaterialFrames")]
+            internal static extern int ErodXShellFillSegmentsMaterialFrames(IntPtr linkage, [Out] double[] outCoordsD1, [Out] double[] outCoordsD2, long numCoords);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillJointPositions")]
+            internal static extern int ErodXShellFillJointPositions(IntPtr linkage, [Out] double[] outPositions, long numCoords);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillCenterLinePositionsFloat")]
+            internal static extern int ErodXShellFillCenterLinePositionsFloat(IntPtr linkage, [Out] float[] outCoords, long numCoords);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillMeshPositionsFloat")]
+            internal static extern int ErodXShellFillMeshPositionsFloat(IntPtr linkage, [Out] float[] outCoords, [Out] float[] outNormals, long numCoords);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillScalarFieldFloat")]
+            internal static extern int ErodXShellFillScalarFieldFloat(IntPtr linkage, int fieldType, [Out] float[] outField, long numField);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillScalarFieldsFloat")]
+            internal static extern int ErodXShellFillScalarFieldsFloat(IntPtr linkage, [Out] float[] outSqrtBendingEnergies, [Out] float[] outMaxBendingStresses, [Out] float[] outMinBendingStresses,
+                                                                       [Out] float[] outVonMisesStresses, [Out] float[] outTwistingStresses, [Out] float[] outStretchingStresses, long numField, long numEdgeField);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillSegmentsCenterLinePositionsFloat")]
+            internal static extern int ErodXShellFillSegmentsCenterLinePositionsFloat(IntPtr linkage, [Out] float[] outCoords, long numCoords);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellFillSegmentsMaterialFramesFloat")]
+            internal static extern int ErodXShellFillSegmentsMaterialFramesFloat(IntPtr linkage, [Out] float[] outCoordsD1, [Out] float[] outCoordsD2, long numCoords);
         }
     }
 }
@@ -8,29 +8,141 @@ namespace ErodModelLib.Creators
     {
         public static class Solvers
         {
+            // Called by the native Newton solvers after each iteration; return nonzero to cancel the solve.
+            [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+            public delegate int NewtonProgressCallback(int iteration, double energy, double gradientNorm, double freeGradientNorm, double stepLength, int indefinite);
+
             [SuppressUnmanagedCodeSecurity]
             [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodPeriodicElasticRodNewtonSolver")]
             internal static extern int ErodPeriodicElasticRodNewtonSolver(IntPtr pRod, int numIterations, int numSupports, int numForces, [In] int[] supports, [In] double[] inForces,
                                                                     double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                                                    int feasibilitySolve, int verboseNonPosDef, int writeReport, out IntPtr outReport, out IntPtr errorMessage);
+                                                                    int feasibilitySolve, int verboseNonPosDef, int writeReport, out IntPtr outReport, NewtonProgressCallback progress, out IntPtr errorMessage);
 
             [SuppressUnmanagedCodeSecurity]
             [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodElasticRodNewtonSolver")]
             internal static extern int ErodElasticRodNewtonSolver(IntPtr rod, int numIterations, int numSupports, int numForces, [In] int[] supports, [In] double[] inForces,
                                                                     double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                                                    int feasibilitySolve, int verboseNonPosDef, int writeReport, out IntPtr outReport, out IntPtr errorMessage);
+                                                                    int feasibilitySolve, int verboseNonPosDef, int writeReport, out IntPtr outReport, NewtonProgressCallback progress, out IntPtr errorMessage);
 
             [SuppressUnmanagedCodeSecurity]
             [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellNewtonSolver")]
             internal static extern int ErodXShellNewtonSolver(IntPtr linkage, int numIterations, double deployedAngle, int numSupports, int numForces, [In] int[] supports, [In] double[] inForces,
                                                                     double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                                                    int feasibilitySolve, int verboseNonPosDef, int writeReport, out IntPtr outReport, out IntPtr errorMessage);
+                                                                    int feasibilitySolve, int verboseNonPosDef, int writeReport, out IntPtr outReport, NewtonProgressCallback progress, out IntPtr errorMessage);
 
             [SuppressUnmanagedCodeSecurity]
             [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellAttractedLinkageNewtonSolver")]
             internal static extern int ErodXShellAttractedLinkageNewtonSolver(IntPtr linkage, int numIterations, double deployedAngle, int numSupports, int numForces, [In] int[] supports, [In] double[] inForces,
                                                         double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                                        int feasibilitySolve, int verboseNonPosDef, int writeReport, out IntPtr outReport, out IntPtr errorMessage);
+                                                        int feasibilitySolve, int verboseNonPosDef, int writeReport, out IntPtr outReport, NewtonProgressCallback progress, out IntPtr errorMessage);
+
+            // Asynchronous solves: the native side solves a copy of the linkage on a background thread.
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellNewtonSolveAsync")]
+            internal static extern IntPtr ErodXShellNewtonSolveAsync(IntPtr linkage, int numIterations, double deployedAngle, int numSupports, int numForces, [In] int[] supports, [In] double[] inForces,
+                                                        double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
+                                                        int feasibilitySolve, int verboseNonPosDef, NewtonProgressCallback progress, out IntPtr errorMessage);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellAttractedLinkageNewtonSolveAsync")]
+            internal static extern IntPtr ErodXShellAttractedLinkageNewtonSolveAsync(IntPtr linkage, int numIterations, double deployedAngle, int numSupports, int numForces, [In] int[] supports, [In] double[] inForces,
+                                                        double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
+                                                        int feasibilitySolve, int verboseNonPosDef, NewtonProgressCallback progress, out IntPtr errorMessage);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodAsyncSolveIsFinished")]
+            internal static extern int ErodAsyncSolveIsFinished(IntPtr job);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodAsyncSolveWait")]
+            internal static extern int ErodAsyncSolveWait(IntPtr job, double timeoutSeconds);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodAsyncSolveCancel")]
+            internal static extern void ErodAsyncSolveCancel(IntPtr job);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodAsyncSolveGetProgress")]
+            internal static extern void ErodAsyncSolveGetProgress(IntPtr job, out int iteration, out double energy);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodAsyncSolveGetResult")]
+            internal static extern int ErodAsyncSolveGetResult(IntPtr job, int writeReport, out IntPtr outReport, out IntPtr errorMessage);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellAsyncSolvePublish")]
+            internal static extern int ErodXShellAsyncSolvePublish(IntPtr job, IntPtr linkage, out IntPtr errorMessage);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellAttractedLinkageAsyncSolvePublish")]
+            internal static extern int ErodXShellAttractedLinkageAsyncSolvePublish(IntPtr job, IntPtr linkage, out IntPtr errorMessage);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodAsyncSolveRelease")]
+            internal static extern void ErodAsyncSolveRelease(IntPtr job);
+
+            // Parallelism: task arenas limit and isolate the threads used by the solves of the linkages they are attached to.
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodParallelismArenaBuild")]
+            internal static extern IntPtr ErodParallelismArenaBuild(int numThreads, int firstPinnedCore, out IntPtr errorMessage);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodParallelismArenaGetMaxConcurrency")]
+            internal static extern int ErodParallelismArenaGetMaxConcurrency(IntPtr arena);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodParallelismArenaRelease")]
+            internal static extern void ErodParallelismArenaRelease(IntPtr arena);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellSetParallelismArena")]
+            internal static extern void ErodXShellSetParallelismArena(IntPtr linkage, IntPtr arena);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodSetMaxNumThreads")]
+            internal static extern int ErodSetMaxNumThreads(int numThreads, out IntPtr errorMessage);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodProfilerSetEnabled")]
+            internal static extern void ErodProfilerSetEnabled(int enable);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodProfilerIsEnabled")]
+            internal static extern int ErodProfilerIsEnabled();
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodProfilerReset")]
+            internal static extern void ErodProfilerReset();
+
+            // The returned buffers are released with Marshal.FreeCoTaskMem; outCalls holds size_t (64-bit) counts.
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodProfilerGetReport")]
+            internal static extern int ErodProfilerGetReport(out IntPtr outNames, out IntPtr outParents, out IntPtr outSeconds, out IntPtr outCalls, out UIntPtr numSections, out IntPtr errorMessage);
+
+            // Memory: bytes per component ('\n'-terminated names); outBytes holds size_t (64-bit) values.
+            // The returned buffers are released with Marshal.FreeCoTaskMem.
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodXShellGetMemoryReport")]
+            internal static extern int ErodXShellGetMemoryReport(IntPtr linkage, out IntPtr outNames, out IntPtr outBytes, out UIntPtr numComponents, out IntPtr errorMessage);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodAsyncSolveGetMemoryReport")]
+            internal static extern int ErodAsyncSolveGetMemoryReport(IntPtr job, out IntPtr outNames, out IntPtr outBytes, out UIntPtr numComponents, out IntPtr errorMessage);
+
+            // Called by the native weaving optimization after each accepted design iterate; return nonzero to stop the optimization.
+            [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+            internal delegate int WeavingIterateCallback(int iteration, double J, double J_target, IntPtr designParams, UIntPtr numDesignParams, IntPtr dofs, UIntPtr numDoFs);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodWeavingOptimize")]
+            internal static extern int ErodWeavingOptimize(IntPtr linkage, int numVertices, int numTrias, [In] double[] inCoords, [In] int[] inTrias,
+                                                        double beta, double gamma, double restLengthWeight, double smoothingWeight, double contactForceWeight, double attractionWeight,
+                                                        int algorithm, int numSteps, double trustRegionScale, double optimalityTol, double minRestLen,
+                                                        int pinJoint, int useFixedJoint, int numFixedVars, [In] int[] fixedVars, WeavingIterateCallback callback, out IntPtr errorMessage);
+
+            [SuppressUnmanagedCodeSecurity]
+            [DllImport(erod_dylib, CallingConvention = CallingConvention.StdCall, EntryPoint = "erodWeavingOptimizeFromFile")]
+            internal static extern int ErodWeavingOptimizeFromFile(IntPtr linkage, string jobPath, string outputDirectory, WeavingIterateCallback callback, out IntPtr errorMessage);
 
         }
     }
@@ -15,36 +15,76 @@ namespace ErodModelLib.Types
         public double[] FreeGradientNorm { get; private set; }
         public double[] StepLength { get; private set; }
         public bool[] Indefinite { get; private set; }
+        public double[] Time { get; private set; }
+        public double[] AssemblyTime { get; private set; }
+        public double[] FactorizationTime { get; private set; }
+        public double[] LineSearchTime { get; private set; }
+        public int[] FailedFactorizations { get; private set; }
+        public double[] Tau { get; private set; }
+        public int[] BacktrackingSteps { get; private set; }
+        public int[] WorkingSetChanges { get; private set; }
 
-        public ConvergenceReport(double[] data, int numIterations)
+        private const int HeaderSize = 3;
+        private const int NumFields = 13;
+
+        // Parse a report flattened by the c++ library (see erod.h for the layout)
+        public ConvergenceReport(double[] data)
         {
             OpeningStep = 0;
-            Iterations = numIterations;
             Success = Convert.ToBoolean(data[0]);
             BacktrackingFailure = Convert.ToBoolean(data[1]);
+            Iterations = (int)data[2];
 
-            int idx = 2;
-            Energy = new double[Iterations];
-            Array.Copy(data, idx, Energy, 0, Iterations);
-
-            idx += Iterations;
-            GradientNorm = new double[Iterations];
-            Array.Copy(data, idx, GradientNorm, 0, Iterations);
-
-            idx += Iterations;
-            FreeGradientNorm = new double[Iterations];
-            Array.Copy(data, idx, FreeGradientNorm, 0, Iterations);
-
-            idx += Iterations;
-            StepLength = new double[Iterations];
-            Array.Copy(data, idx, StepLength, 0, Iterations);
-
-            idx += Iterations;
+            int idx = HeaderSize;
+            Energy = ReadDoubles(data, ref idx, Iterations);
+            GradientNorm = ReadDoubles(data, ref idx, Iterations);
+            FreeGradientNorm = ReadDoubles(data, ref idx, Iterations);
+            StepLength = ReadDoubles(data, ref idx, Iterations);
             Indefinite = new bool[Iterations];
             for (int i=0; i<Iterations; i++)
             {
                 Indefinite[i] = Convert.ToBoolean(data[idx + i]);
             }
+            idx += Iterations;
+
+            Time = ReadDoubles(data, ref idx, Iterations);
+            AssemblyTime = ReadDoubles(data, ref idx, Iterations);
+            FactorizationTime = ReadDoubles(data, ref idx, Iterations);
+            LineSearchTime = ReadDoubles(data, ref idx, Iterations);
+            FailedFactorizations = ReadInts(data, ref idx, Iterations);
+            Tau = ReadDoubles(data, ref idx, Iterations);
+            BacktrackingSteps = ReadInts(data, ref idx, Iterations);
+            WorkingSetChanges = ReadInts(data, ref idx, Iterations);
+        }
+
+        // Copy a report returned by the c++ library and release its buffer
+        public static ConvergenceReport FromNative(IntPtr ptrReport)
+        {
+            double[] header = new double[HeaderSize];
+            Marshal.Copy(ptrReport, header, 0, HeaderSize);
+
+            int size = HeaderSize + NumFields * (int)header[2];
+            double[] data = new double[size];
+            Marshal.Copy(ptrReport, data, 0, size);
+            Marshal.FreeCoTaskMem(ptrReport);
+
+            return new ConvergenceReport(data);
+        }
+
+        private static double[] ReadDoubles(double[] data, ref int idx, int count)
+        {
+            double[] values = new double[count];
+            Array.Copy(data, idx, values, 0, count);
+            idx += count;
+            return values;
+        }
+
+        private static int[] ReadInts(double[] data, ref int idx, int count)
+        {
+            int[] values = new int[count];
+            for (int i = 0; i < count; i++) values[i] = (int)data[idx + i];
+            idx += count;
+            return values;
         }
 
         public override string ToString()
@@ -54,7 +94,7 @@ namespace ErodModelLib.Types
                 string txt = "--- Convergence Report ---\nOpening Step: " + OpeningStep + " :: Success: " + Success + " :: Backtracking Failure: " + BacktrackingFailure;
                 for (int i = 0; i < Iterations; i++)
                 {
-                    txt += "\nIter(" + i + ") Energy: " + Energy[i] + " -- GradientNorm: " + GradientNorm[i] + " -- FreeGradientNorm: " + FreeGradientNorm[i] + " -- StepLength: " + StepLength[i] + " -- Indefinite: " + Indefinite[i];
+                    txt += "\nIter(" + i + ") Energy: " + Energy[i] + " -- GradientNorm: " + GradientNorm[i] + " -- FreeGradientNorm: " + FreeGradientNorm[i] + " -- StepLength: " + StepLength[i] + " -- Indefinite: " + Indefinite[i] + " -- Time: " + Time[i] + " -- Tau: " + Tau[i];
                 }
                 return txt;
             }else return "--- Empty Convergence Report --- ";
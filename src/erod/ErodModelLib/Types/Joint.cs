@@ -28,6 +28,11 @@ namespace ErodModelLib.Types
             Position = GetPositionAsPoint3d();
         }
 
+        internal void SetPosition(Point3d position)
+        {
+            Position = position;
+        }
+
         public Point3d GetPositionAsPoint3d()
         {
             double[] coords = GetPosition();
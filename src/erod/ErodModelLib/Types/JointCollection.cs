@@ -71,6 +71,17 @@ namespace ErodModelLib.Types
                 _cloud[i].Location = jt.Position;
             }
         }
+
+        // Update from the flattened joint positions of the whole linkage (3 coordinates per joint).
+        public void UpdateJointPositions(double[] coords)
+        {
+            for (int i=0; i<Count; i++)
+            {
+                var jt = _joints[i];
+                jt.SetPosition(new Point3d(coords[i * 3], coords[i * 3 + 1], coords[i * 3 + 2]));
+                _cloud[i].Location = jt.Position;
+            }
+        }
     }
 }
 
@@ -13,13 +13,22 @@ namespace ErodModelLib.Types
 {
     public partial class RodLinkage
     {
+        // Buffers reused across redraws and filled in place by the native library.
+        private double[] _meshCoordsBuffer;
+        private double[] _jointPositionsBuffer;
 
         public void UpdateMesh()
         {
-            double[] outCoords;
-            int[] outQuads;
-            GetMeshData(out outCoords, out outQuads);
+            // The mesh connectivity is unchanged by deformations: only refresh the vertex positions.
+            if (_meshCoordsBuffer == null || Kernel.RodLinkage.ErodXShellFillMeshPositions(Model, _meshCoordsBuffer, null, _meshCoordsBuffer.Length) != 0)
+            {
+                long numCoords, numQuads;
+                Kernel.RodLinkage.ErodXShellGetMeshDataCount(Model, out numCoords, out numQuads);
+                _meshCoordsBuffer = new double[numCoords];
+                Kernel.RodLinkage.ErodXShellFillMeshPositions(Model, _meshCoordsBuffer, null, numCoords);
+            }
 
+            double[] outCoords = _meshCoordsBuffer;
             int vCount = outCoords.Length / 3;
             for (int i = 0; i < vCount; i++)
             {
@@ -29,16 +38,65 @@ namespace ErodModelLib.Types
 
         public double[] GetDoFs()
         {
-            int numDoFs;
-            IntPtr cPtr;
-            Kernel.RodLinkage.ErodXShellGetDoFs(Model, out cPtr, out numDoFs);
-
-            double[] outDoFs = new double[numDoFs];
-            Marshal.Copy(cPtr, outDoFs, 0, numDoFs);
-            Marshal.FreeCoTaskMem(cPtr);
+            double[] outDoFs = new double[Kernel.RodLinkage.ErodXShellGetDoFCount(Model)];
+            GetDoFs(outDoFs);
             return outDoFs;
         }
 
+        // Fill a caller-provided array (of size GetDoFCount()) with the DoFs.
+        public void GetDoFs(double[] outDoFs)
+        {
+            if (Kernel.RodLinkage.ErodXShellFillDoFs(Model, outDoFs, outDoFs.Length) != 0) throw new ArgumentException("Invalid DoF buffer size");
+        }
+
+        // Fill a caller-provided array (of size GetScalarFieldCount(fieldType)) with a visualization scalar field.
+        // fieldType: 0 sqrt bending energies, 1 max bending stresses, 2 min bending stresses, 3 von Mises stresses, 4 twisting stresses, 5 stretching stresses
+        public void GetScalarField(int fieldType, double[] outField)
+        {
+            if (outField == null || outField.Length != GetScalarFieldCount(fieldType)) throw new ArgumentException("Invalid scalar field buffer size");
+            switch (Kernel.RodLinkage.ErodXShellFillScalarField(Model, fieldType, outField, outField.Length))
+            {
+                case 0: return;
+                case 1: throw new ArgumentException("Invalid scalar field buffer size");
+                case 2: throw new ArgumentException("Invalid scalar field type");
+                default: throw new Exception("Failed to compute the scalar field");
+            }
+        }
+
+        // Number of per-vertex scalar field entries.
+        public int GetScalarFieldCount()
+        {
+            return (int)Kernel.RodLinkage.ErodXShellGetScalarFieldCount(Model);
+        }
+
+        // Number of entries of scalar field `fieldType`: one per mesh vertex, except for the
+        // stretching stresses (fieldType 5), which have one entry per mesh quad.
+        public int GetScalarFieldCount(int fieldType)
+        {
+            if (fieldType != 5) return GetScalarFieldCount();
+            long numCoords, numQuads;
+            Kernel.RodLinkage.ErodXShellGetMeshDataCount(Model, out numCoords, out numQuads);
+            return (int)(numQuads / 4);
+        }
+
+        // Fill several visualization scalar fields in a single pass. Pass null for the fields that are not needed.
+        // Per-vertex fields have GetScalarFieldCount() entries; the per-quad stretching stresses have one entry per mesh quad.
+        public void GetScalarFields(double[] sqrtBendingEnergies, double[] maxBendingStresses, double[] minBendingStresses,
+                                    double[] vonMisesStresses, double[] twistingStresses, double[] stretchingStresses)
+        {
+            long numCoords, numQuads;
+            Kernel.RodLinkage.ErodXShellGetMeshDataCount(Model, out numCoords, out numQuads);
+            long numField = numCoords / 3, numEdgeField = numQuads / 4;
+            foreach (double[] field in new[] { sqrtBendingEnergies, maxBendingStresses, minBendingStresses, vonMisesStresses, twistingStresses })
+            {
+                if (field != null && field.Length != numField) throw new ArgumentException("Invalid scalar field buffer size");
+            }
+            if (stretchingStresses != null && stretchingStresses.Length != numEdgeField) throw new ArgumentException("Invalid scalar field buffer size");
+            if (Kernel.RodLinkage.ErodXShellFillScalarFields(Model, sqrtBendingEnergies, maxBendingStresses, minBendingStresses,
+                                                             vonMisesStresses, twistingStresses, stretchingStresses, numField, numEdgeField) != 0)
+                throw new ArgumentException("Invalid scalar field buffer size");
+        }
+
         public void SetDoFs(double[] dofs)
         {
             Kernel.RodLinkage.ErodXShellSetDoFs(Model, dofs, dofs.Length);
@@ -400,8 +458,150 @@ namespace ErodModelLib.Types
             return angles;
         }
 
+        private static double[] CopyAndFree(IntPtr ptr, long count)
+        {
+            double[] data = new double[count];
+            Marshal.Copy(ptr, data, 0, (int)count);
+            Marshal.FreeCoTaskMem(ptr);
+            return data;
+        }
+
+        private static int[] CopyAndFreeInt(IntPtr ptr, long count)
+        {
+            int[] data = new int[count];
+            Marshal.Copy(ptr, data, 0, (int)count);
+            Marshal.FreeCoTaskMem(ptr);
+            return data;
+        }
+
+        // Bulk export: segment i owns vertices [vertexOffsets[i], vertexOffsets[i+1]) and edges [edgeOffsets[i], edgeOffsets[i+1]) of the flattened arrays below.
+        public void GetSegmentOffsets(out int[] vertexOffsets, out int[] edgeOffsets)
+        {
+            IntPtr vPtr, ePtr;
+            long numOffsets;
+            Kernel.RodLinkage.ErodXShellGetSegmentOffsets(Model, out vPtr, out ePtr, out numOffsets);
+
+            vertexOffsets = CopyAndFreeInt(vPtr, numOffsets);
+            edgeOffsets = CopyAndFreeInt(ePtr, numOffsets);
+        }
+
+        // Rod r is made of the (ordered) segments segmentIndexes[rodOffsets[r]..rodOffsets[r + 1]).
+        public void GetRodSegmentTable(out int[] segmentIndexes, out int[] rodOffsets, out bool[] isRodA)
+        {
+            IntPtr sPtr, oPtr, tPtr, Error;
+            long numRods, numSegments;
+            int error = Kernel.RodLinkage.ErodXShellGetRodSegmentTable(Model, out sPtr, out oPtr, out tPtr, out numRods, out numSegments, out Error);
+            if (error != 0)
+            {
+                string errorMsg = Marshal.PtrToStringAnsi(Error);
+                throw new Exception(errorMsg);
+            }
+
+            segmentIndexes = CopyAndFreeInt(sPtr, numSegments);
+            rodOffsets = CopyAndFreeInt(oPtr, numRods + 1);
+            int[] types = CopyAndFreeInt(tPtr, numRods);
+            isRodA = new bool[numRods];
+            for (int i = 0; i < numRods; i++) isRodA[i] = types[i] != 0;
+        }
+
+        // Ordered segment indices of every rod, read with a single native call (use this rather than
+        // querying rods one at a time, which traverses the rod table once per rod).
+        public int[][] GetRodSegmentIndexes(out bool[] isRodA)
+        {
+            int[] segmentIndexes, rodOffsets;
+            GetRodSegmentTable(out segmentIndexes, out rodOffsets, out isRodA);
+
+            int[][] rods = new int[isRodA.Length][];
+            for (int r = 0; r < rods.Length; r++)
+            {
+                rods[r] = new int[rodOffsets[r + 1] - rodOffsets[r]];
+                Array.Copy(segmentIndexes, rodOffsets[r], rods[r], 0, rods[r].Length);
+            }
+            return rods;
+        }
+
+        public double[] GetSegmentsCenterLineCoordinates()
+        {
+            IntPtr cPtr;
+            long numCoords;
+            Kernel.RodLinkage.ErodXShellGetSegmentsCenterLinePositions(Model, out cPtr, out numCoords);
+            return CopyAndFree(cPtr, numCoords);
+        }
+
+        public void GetSegmentsMaterialFrames(out double[] d1, out double[] d2)
+        {
+            IntPtr d1Ptr, d2Ptr;
+            long numCoords;
+            Kernel.RodLinkage.ErodXShellGetSegmentsMaterialFrames(Model, out d1Ptr, out d2Ptr, out numCoords);
+
+            d1 = CopyAndFree(d1Ptr, numCoords);
+            d2 = CopyAndFree(d2Ptr, numCoords);
+        }
+
+        public void GetSegmentsRestData(out double[] restLengths, out double[] restKappas, out double[] restTwists, out double[] restPoints, out double[] restDirectors)
+        {
+            IntPtr lPtr, kPtr, tPtr, pPtr, dPtr;
+            long numEdges, numVertices;
+            Kernel.RodLinkage.ErodXShellGetSegmentsRestData(Model, out lPtr, out kPtr, out tPtr, out pPtr, out dPtr, out numEdges, out numVertices);
+
+            restLengths = CopyAndFree(lPtr, numEdges);
+            restKappas = CopyAndFree(kPtr, 2 * numVertices);
+            restTwists = CopyAndFree(tPtr, numVertices);
+            restPoints = CopyAndFree(pPtr, 3 * numVertices);
+            restDirectors = CopyAndFree(dPtr, 6 * numEdges);
+        }
+
+        public void GetSegmentsStiffnesses(out double[] bendingStiffness, out double[] twistingStiffness, out double[] stretchingStiffness)
+        {
+            IntPtr bPtr, tPtr, sPtr;
+            long numEdges, numVertices;
+            Kernel.RodLinkage.ErodXShellGetSegmentsStiffnesses(Model, out bPtr, out tPtr, out sPtr, out numEdges, out numVertices);
+
+            bendingStiffness = CopyAndFree(bPtr, 2 * numVertices);
+            twistingStiffness = CopyAndFree(tPtr, numVertices);
+            stretchingStiffness = CopyAndFree(sPtr, numEdges);
+        }
+
+        // Per-joint data (3 values per joint for vectors, lengths are (lenA, lenB), segments are (A0, A1, B0, B1) with -1 for missing segments).
+        public void GetJointsData(out double[] positions, out double[] normals, out double[] edgeVecsA, out double[] edgeVecsB,
+                                  out double[] omegas, out double[] sourceTangents, out double[] sourceNormals, out double[] angles, out double[] lengths,
+                                  out int[] segments, out int[] types)
+        {
+            IntPtr posPtr, nPtr, eaPtr, ebPtr, oPtr, stPtr, snPtr, aPtr, lPtr, sgPtr, tyPtr;
+            long numJoints;
+            Kernel.RodLinkage.ErodXShellGetJointsData(Model, out posPtr, out nPtr, out eaPtr, out ebPtr, out oPtr, out stPtr, out snPtr, out aPtr, out lPtr, out sgPtr, out tyPtr, out numJoints);
+
+            positions = CopyAndFree(posPtr, 3 * numJoints);
+            normals = CopyAndFree(nPtr, 3 * numJoints);
+            edgeVecsA = CopyAndFree(eaPtr, 3 * numJoints);
+            edgeVecsB = CopyAndFree(ebPtr, 3 * numJoints);
+            omegas = CopyAndFree(oPtr, 3 * numJoints);
+            sourceTangents = CopyAndFree(stPtr, 3 * numJoints);
+            sourceNormals = CopyAndFree(snPtr, 3 * numJoints);
+            angles = CopyAndFree(aPtr, numJoints);
+            lengths = CopyAndFree(lPtr, 2 * numJoints);
+            segments = CopyAndFreeInt(sgPtr, 4 * numJoints);
+            types = CopyAndFreeInt(tyPtr, numJoints);
+        }
+
+        // Flattened joint positions (3 coordinates per joint).
+        public double[] GetJointPositions()
+        {
+            double[] positions = new double[3 * Joints.Count];
+            GetJointPositions(positions);
+            return positions;
+        }
+
+        // Fill the caller-supplied buffer `positions` (of length 3 * Joints.Count) with the flattened joint positions.
+        public void GetJointPositions(double[] positions)
+        {
+            if (positions == null || positions.Length != 3 * Joints.Count) throw new ArgumentException("Invalid joint position buffer size");
+            if (Kernel.RodLinkage.ErodXShellFillJointPositions(Model, positions, positions.Length) != 0) throw new Exception("Joint count mismatch");
+        }
+
         public LineCurve[] GetSegmentsAsLines()
         {
+            double[] p = GetJointPositions();
             int numSegments = Segments.Count;
             LineCurve[] edges = new LineCurve[numSegments];
             for (int i = 0; i < numSegments; i++)
@@ -409,11 +609,8 @@ namespace ErodModelLib.Types
                 int idx0 = Segments[i].GetStartJoint();
                 int idx1 = Segments[i].GetEndJoint();
 
-                double[] p0 = Joints[idx0].GetPosition();
-                double[] p1 = Joints[idx1].GetPosition();
-
-                Point3d pos0 = new Point3d(p0[0], p0[1], p0[2]);
-                Point3d pos1 = new Point3d(p1[0], p1[1], p1[2]);
+                Point3d pos0 = new Point3d(p[idx0 * 3], p[idx0 * 3 + 1], p[idx0 * 3 + 2]);
+                Point3d pos1 = new Point3d(p[idx1 * 3], p[idx1 * 3 + 1], p[idx1 * 3 + 2]);
 
                 edges[i] = new LineCurve(pos0, pos1);
             }
@@ -363,7 +363,9 @@ namespace ErodModelLib.Types
 
         public override void Update()
         {
-            Joints.UpdateJointPositions();
+            if (_jointPositionsBuffer == null || _jointPositionsBuffer.Length != 3 * Joints.Count) _jointPositionsBuffer = new double[3 * Joints.Count];
+            GetJointPositions(_jointPositionsBuffer);
+            Joints.UpdateJointPositions(_jointPositionsBuffer);
             Segments.UpdateNodePositions();
             UpdateMesh();
         }
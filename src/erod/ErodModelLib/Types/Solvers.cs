@@ -9,7 +9,7 @@ namespace ErodModelLib.Types
 {
     public static class NewtonSolver
     {
-        public static bool Optimize(ElasticModel model, int[] supports, double[] forces, NewtonSolverOpts options, out ConvergenceReport report, bool updateMesh = true, double deployedAngle=0, bool lastStep=false)
+        public static bool Optimize(ElasticModel model, int[] supports, double[] forces, NewtonSolverOpts options, out ConvergenceReport report, bool updateMesh = true, double deployedAngle=0, bool lastStep=false, Kernel.Solvers.NewtonProgressCallback progress=null)
         {
             int numIterations = options.NumIterations;
             bool writeReport = false;
@@ -28,19 +28,19 @@ namespace ErodModelLib.Types
             {
                 case ElasticModelType.ElasticRod:
                     errorCode = Kernel.Solvers.ErodElasticRodNewtonSolver(model.Model, numIterations, supports.Length, forces.Length, supports, forces, options.GradTol, options.Beta, includeForces,
-                                                                    Convert.ToInt32(options.Verbose), Convert.ToInt32(options.UseIdentityMetric), Convert.ToInt32(options.UseNegativeCurvatureDirection), Convert.ToInt32(options.FeasibilitySolve), Convert.ToInt32(options.VerboseNonPosDef), Convert.ToInt32(writeReport), out ptrReport, out model.Error);
+                                                                    Convert.ToInt32(options.Verbose), Convert.ToInt32(options.UseIdentityMetric), Convert.ToInt32(options.UseNegativeCurvatureDirection), Convert.ToInt32(options.FeasibilitySolve), Convert.ToInt32(options.VerboseNonPosDef), Convert.ToInt32(writeReport), out ptrReport, progress, out model.Error);
                     break;
                 case ElasticModelType.PeriodicRod:
                     errorCode = Kernel.Solvers.ErodPeriodicElasticRodNewtonSolver(model.Model, numIterations, supports.Length, forces.Length, supports, forces, options.GradTol, options.Beta, includeForces,
-                                                                    Convert.ToInt32(options.Verbose), Convert.ToInt32(options.UseIdentityMetric), Convert.ToInt32(options.UseNegativeCurvatureDirection), Convert.ToInt32(options.FeasibilitySolve), Convert.ToInt32(options.VerboseNonPosDef), Convert.ToInt32(writeReport), out ptrReport, out model.Error);
+                                                                    Convert.ToInt32(options.Verbose), Convert.ToInt32(options.UseIdentityMetric), Convert.ToInt32(options.UseNegativeCurvatureDirection), Convert.ToInt32(options.FeasibilitySolve), Convert.ToInt32(options.VerboseNonPosDef), Convert.ToInt32(writeReport), out ptrReport, progress, out model.Error);
                     break;
                 case ElasticModelType.RodLinkage:
                     errorCode = Kernel.Solvers.ErodXShellNewtonSolver(model.Model, numIterations, deployedAngle, supports.Length, forces.Length, supports, forces, options.GradTol, options.Beta, includeForces,
-                                                                    Convert.ToInt32(options.Verbose), Convert.ToInt32(options.UseIdentityMetric), Convert.ToInt32(options.UseNegativeCurvatureDirection), Convert.ToInt32(options.FeasibilitySolve), Convert.ToInt32(options.VerboseNonPosDef), Convert.ToInt32(writeReport), out ptrReport, out model.Error);
+                                                                    Convert.ToInt32(options.Verbose), Convert.ToInt32(options.UseIdentityMetric), Convert.ToInt32(options.UseNegativeCurvatureDirection), Convert.ToInt32(options.FeasibilitySolve), Convert.ToInt32(options.VerboseNonPosDef), Convert.ToInt32(writeReport), out ptrReport, progress, out model.Error);
                     break;
                 case ElasticModelType.AttractedSurfaceRodLinkage:
                     errorCode = Kernel.Solvers.ErodXShellAttractedLinkageNewtonSolver(model.Model, numIterations, deployedAngle, supports.Length, forces.Length, supports, forces, options.GradTol, options.Beta, includeForces,
-                                                                    Convert.ToInt32(options.Verbose), Convert.ToInt32(options.UseIdentityMetric), Convert.ToInt32(options.UseNegativeCurvatureDirection), Convert.ToInt32(options.FeasibilitySolve), Convert.ToInt32(options.VerboseNonPosDef), Convert.ToInt32(writeReport), out ptrReport, out model.Error);
+                                                                    Convert.ToInt32(options.Verbose), Convert.ToInt32(options.UseIdentityMetric), Convert.ToInt32(options.UseNegativeCurvatureDirection), Convert.ToInt32(options.FeasibilitySolve), Convert.ToInt32(options.VerboseNonPosDef), Convert.ToInt32(writeReport), out ptrReport, progress, out model.Error);
                     break;
                 default:
                     ptrReport = IntPtr.Zero;
@@ -60,18 +60,121 @@ namespace ErodModelLib.Types
                 report = new ConvergenceReport();
                 if (writeReport)
                 {
-                    int size = numIterations * 5 + 2;
-                    double[] data = new double[size];
-                    Marshal.Copy(ptrReport, data, 0, size);
-
-                    report = new ConvergenceReport(data, numIterations);
-                    Marshal.FreeCoTaskMem(ptrReport);
+                    report = ConvergenceReport.FromNative(ptrReport);
                 }
 
-                // Return true if the model converged
+                // Return true if the model converged (a cancelled solve returns 2)
                 if (errorCode == 1) return true;
                 else return false;
             }
         }
     }
-}
+
+    // Equilibrium solve of a linkage running on a native background thread. The solve works on a copy of
+    // the model taken at start, so the model can still be used while the job runs; Publish copies the
+    // result back into it.
+    public class NewtonSolveJob : IDisposable
+    {
+        private IntPtr _job;
+        private readonly ElasticModel _model;
+        private readonly int _numIterations;
+        private readonly Kernel.Solvers.NewtonProgressCallback _progress;
+        // Keeps the delegate alive while the native side may call it, including during finalization.
+        private GCHandle _progressHandle;
+
+        public NewtonSolveJob(ElasticModel model, int[] supports, double[] forces, NewtonSolverOpts options, double deployedAngle = 0, Kernel.Solvers.NewtonProgressCallback progress = null)
+        {
+            _model = model;
+            _numIterations = options.NumIterations;
+            _progress = progress;
+            if (_progress != null) _progressHandle = GCHandle.Alloc(_progress);
+
+            int includeForces = Convert.ToInt32(true);
+            IntPtr error;
+            switch (model.ModelType)
+            {
+                case ElasticModelType.RodLinkage:
+                    _job = Kernel.Solvers.ErodXShellNewtonSolveAsync(model.Model, _numIterations, deployedAngle, supports.Length, forces.Length, supports, forces, options.GradTol, options.Beta, includeForces,
+                                                                    Convert.ToInt32(options.Verbose), Convert.ToInt32(options.UseIdentityMetric), Convert.ToInt32(options.UseNegativeCurvatureDirection), Convert.ToInt32(options.FeasibilitySolve), Convert.ToInt32(options.VerboseNonPosDef), _progress, out error);
+                    break;
+                case ElasticModelType.AttractedSurfaceRodLinkage:
+                    _job = Kernel.Solvers.ErodXShellAttractedLinkageNewtonSolveAsync(model.Model, _numIterations, deployedAngle, supports.Length, forces.Length, supports, forces, options.GradTol, options.Beta, includeForces,
+                                                                    Convert.ToInt32(options.Verbose), Convert.ToInt32(options.UseIdentityMetric), Convert.ToInt32(options.UseNegativeCurvatureDirection), Convert.ToInt32(options.FeasibilitySolve), Convert.ToInt32(options.VerboseNonPosDef), _progress, out error);
+                    break;
+                default:
+                    throw new Exception("Asynchronous solves are only available for linkages");
+            }
+
+            if (_job == IntPtr.Zero)
+            {
+                Release();
+                GC.SuppressFinalize(this);
+                throw new Exception(Marshal.PtrToStringAnsi(error));
+            }
+        }
+
+        public bool IsFinished => Kernel.Solvers.ErodAsyncSolveIsFinished(_job) == 1;
+
+        // Returns true if the solve finished within the timeout (negative: wait until finished).
+        public bool Wait(double timeoutSeconds = -1) => Kernel.Solvers.ErodAsyncSolveWait(_job, timeoutSeconds) == 1;
+
+        public void Cancel() => Kernel.Solvers.ErodAsyncSolveCancel(_job);
+
+        public void GetProgress(out int iteration, out double energy) => Kernel.Solvers.ErodAsyncSolveGetProgress(_job, out iteration, out energy);
+
+        // Waits for the solve and copies its equilibrium into the model. Returns true if the solve converged.
+        public bool Publish(out ConvergenceReport report, bool writeReport = false, bool updateMesh = true)
+        {
+            IntPtr ptrReport = IntPtr.Zero, error;
+            int errorCode = Kernel.Solvers.ErodAsyncSolveGetResult(_job, Convert.ToInt32(writeReport), out ptrReport, out error);
+            try
+            {
+                if (errorCode == -1) throw new Exception(Marshal.PtrToStringAnsi(error));
+
+                int publishCode;
+                if (_model.ModelType == ElasticModelType.AttractedSurfaceRodLinkage) publishCode = Kernel.Solvers.ErodXShellAttractedLinkageAsyncSolvePublish(_job, _model.Model, out error);
+                else publishCode = Kernel.Solvers.ErodXShellAsyncSolvePublish(_job, _model.Model, out error);
+                if (publishCode != 0) throw new Exception(Marshal.PtrToStringAnsi(error));
+
+                if (updateMesh) _model.Update();
+
+                report = new ConvergenceReport();
+                if (writeReport && ptrReport != IntPtr.Zero)
+                {
+                    // FromNative releases the buffer
+                    report = ConvergenceReport.FromNative(ptrReport);
+                    ptrReport = IntPtr.Zero;
+                }
+
+                return errorCode == 1;
+            }
+            finally
+            {
+                if (ptrReport != IntPtr.Zero) Marshal.FreeCoTaskMem(ptrReport);
+            }
+        }
+
+        public void Dispose()
+        {
+            Release();
+            GC.SuppressFinalize(this);
+        }
+
+        ~NewtonSolveJob()
+        {
+            Release();
+        }
+
+        // The native release cancels and joins the worker, which may call the progress delegate until then,
+        // so the delegate's handle is only freed afterwards.
+        private void Release()
+        {
+            if (_job != IntPtr.Zero)
+            {
+                Kernel.Solvers.ErodAsyncSolveRelease(_job);
+                _job = IntPtr.Zero;
+            }
+            if (_progressHandle.IsAllocated) _progressHandle.Free();
+        }
+    }
+}
\ No newline at end of file
@@ -11,6 +11,11 @@
 #include "ElasticRod.hh"
 #include "CrossSectionStressAnalysis.hh"
 #include "python_bindings/visualization.hh"
+#include "weaving_worker.hh"
+#include "linkage_io.hh"
+#include "async_equilibrium.hh"
+#include <MeshFEM/Parallelism.hh>
+#include <MeshFEM/Profiler.hh>
 
 extern "C"
 {
@@ -19,22 +24,183 @@ extern "C"
 
 namespace ElasticRodsGH
 {
-    void getConvergenceReport(ConvergenceReport report, double **outReport)
+    void getConvergenceReport(const ConvergenceReport &report, double **outReport)
     {
+        const size_t numEntries = report.energy.size();
         std::vector<double> flatReport;
+        flatReport.reserve(3 + 13 * numEntries);
         flatReport.push_back(static_cast<double>(report.success));
         flatReport.push_back(static_cast<double>(report.backtracking_failure));
+        flatReport.push_back(static_cast<double>(numEntries));
         flatReport.insert(flatReport.end(), report.energy.begin(), report.energy.end());
         flatReport.insert(flatReport.end(), report.gradientNorm.begin(), report.gradientNorm.end());
         flatReport.insert(flatReport.end(), report.freeGradientNorm.begin(), report.freeGradientNorm.end());
         flatReport.insert(flatReport.end(), report.stepLength.begin(), report.stepLength.end());
         flatReport.insert(flatReport.end(), report.indefinite.begin(), report.indefinite.end());
 
-        auto sizeReport = flatReport.size() * sizeof(double);//(numIterations * 5 + 2) * sizeof(double);
+        // Per-iteration statistics; reports not produced by NewtonOptimizer have none and get zeros.
+        auto appendStatistic = [&](auto field)
+        {
+            for (size_t i = 0; i < numEntries; ++i)
+                flatReport.push_back((i < report.statistics.size()) ? static_cast<double>(report.statistics[i].*field) : 0.0);
+        };
+        appendStatistic(&NewtonIterationStatistics::time);
+        appendStatistic(&NewtonIterationStatistics::assemblyTime);
+        appendStatistic(&NewtonIterationStatistics::factorizationTime);
+        appendStatistic(&NewtonIterationStatistics::lineSearchTime);
+        appendStatistic(&NewtonIterationStatistics::failedFactorizations);
+        appendStatistic(&NewtonIterationStatistics::tau);
+        appendStatistic(&NewtonIterationStatistics::backtrackingSteps);
+        appendStatistic(&NewtonIterationStatistics::workingSetChanges);
+
+        auto sizeReport = flatReport.size() * sizeof(double);
         *outReport = static_cast<double *>(malloc(sizeReport));
         std::memcpy(*outReport, flatReport.data(), sizeReport);
     }
 
+    NewtonProgressCallback newtonProgressCallback(erodNewtonProgressCallback callback)
+    {
+        if (callback == nullptr) return nullptr;
+        return [callback](const NewtonProgress &p)
+        {
+            return callback(static_cast<int>(p.iteration), p.energy, p.gradientNorm, p.freeGradientNorm, p.stepLength, p.indefinite) != 0;
+        };
+    }
+
+    template<typename F>
+    void forEachIndex(size_t n, F &&f)
+    {
+#if MESHFEM_WITH_TBB
+        parallel_for_range(n, f);
+#else
+        for (size_t i = 0; i < n; ++i) f(i);
+#endif
+    }
+
+    // Offsets of each segment's vertices (or edges) in the flattened
+    // linkage-wide arrays; the last entry holds the total count.
+    std::vector<size_t> segmentOffsets(const RodLinkage &linkage, bool edges)
+    {
+        const size_t ns = linkage.numSegments();
+        std::vector<size_t> offsets(ns + 1, 0);
+        for (size_t si = 0; si < ns; ++si)
+        {
+            const auto &rod = linkage.segment(si).rod;
+            offsets[si + 1] = offsets[si] + (edges ? rod.numEdges() : rod.numVertices());
+        }
+        return offsets;
+    }
+
+    // Fill `result` (`stride` values per vertex/edge of all segments) in
+    // parallel: `f(rod, out)` writes the values of one segment to `out`.
+    template<typename T, typename F>
+    void fillSegmentData(const RodLinkage &linkage, const std::vector<size_t> &offsets, size_t stride, T *result, F &&f)
+    {
+        forEachIndex(linkage.numSegments(), [&](size_t si)
+        {
+            f(linkage.segment(si).rod, result + offsets[si] * stride);
+        });
+    }
+
+    // Same as fillSegmentData, allocating the result array.
+    template<typename F>
+    double *gatherSegmentData(const RodLinkage &linkage, const std::vector<size_t> &offsets, size_t stride, F &&f)
+    {
+        double *result = static_cast<double *>(malloc(offsets.back() * stride * sizeof(double)));
+        fillSegmentData(linkage, offsets, stride, result, std::forward<F>(f));
+        return result;
+    }
+
+    // Same as gatherSegmentData for the joints (`stride` values per joint).
+    template<typename T, typename F>
+    T *gatherJointData(const RodLinkage &linkage, size_t stride, F &&f)
+    {
+        const size_t nj = linkage.numJoints();
+        T *result = static_cast<T *>(malloc(nj * stride * sizeof(T)));
+        forEachIndex(nj, [&](size_t ji) { f(linkage.joint(ji), result + ji * stride); });
+        return result;
+    }
+
+    // Copy serialized data to a malloc'd buffer owned by the caller.
+    void copyBytes(const std::string &data, unsigned char **outData, size_t *numBytes)
+    {
+        *numBytes = data.size();
+        *outData = static_cast<unsigned char *>(malloc(data.size()));
+        std::memcpy(*outData, data.data(), data.size());
+    }
+
+    // The output type T is double, or float for the single-precision exports.
+    template<typename T>
+    void copyVec3(const Eigen::Vector3d &v, T *out)
+    {
+        out[0] = T(v[0]);
+        out[1] = T(v[1]);
+        out[2] = T(v[2]);
+    }
+
+    template<typename T>
+    void segmentCenterLinePositions(const ElasticRod &rod, T *out)
+    {
+        const auto &pts = rod.deformedPoints();
+        for (size_t i = 0; i < pts.size(); i++) copyVec3(pts[i], out + 3 * i);
+    }
+
+    template<typename T>
+    void segmentMaterialFramesD1(const ElasticRod &rod, T *out)
+    {
+        for (size_t j = 0; j < rod.numEdges(); j++) copyVec3(rod.deformedMaterialFrameD1(j), out + 3 * j);
+    }
+
+    template<typename T>
+    void segmentMaterialFramesD2(const ElasticRod &rod, T *out)
+    {
+        for (size_t j = 0; j < rod.numEdges(); j++) copyVec3(rod.deformedMaterialFrameD2(j), out + 3 * j);
+    }
+
+    // Copy `data` into the caller-provided buffer `out` holding `size` values.
+    // Returns 0 on success and 1 (leaving `out` untouched) on a size mismatch.
+    template<typename T, typename OutT>
+    int fillBuffer(const T *data, size_t n, OutT *out, size_t size)
+    {
+        if (n != size) return 1;
+        for (size_t i = 0; i < n; i++) out[i] = OutT(data[i]);
+        return 0;
+    }
+
+    // The Grasshopper components index joints and segments by the vertices and
+    // edges of the input line graph, so linkages renumbered by
+    // RodLinkage::reorderForLocality (e.g., saved from Python) are loaded in
+    // their original order. Surface-attracted linkages store per-joint target
+    // data that is not renumbered, so reordered ones are rejected.
+    RodLinkage *loadedInOriginalOrder(std::unique_ptr<RodLinkage> linkage)
+    {
+        linkage->restoreOriginalOrder();
+        return linkage.release();
+    }
+
+    SurfaceAttractedLinkage *loadedInOriginalOrder(std::unique_ptr<SurfaceAttractedLinkage> linkage)
+    {
+        if (linkage->isReordered()) throw std::runtime_error("Reordered surface-attracted linkages are not supported; save the linkage in its original order");
+        return linkage.release();
+    }
+
+    // Visualization scalar fields, indexed by the `fieldType` argument of erodXShellFillScalarField.
+    // The field types are the RodLinkage::StressField values.
+    Eigen::VectorXd linkageScalarField(const RodLinkage &linkage, int fieldType)
+    {
+        using StressField = RodLinkage::StressField;
+        if ((fieldType < 0) || (fieldType >= int(StressField::Count)))
+            throw std::runtime_error("Unknown scalar field type");
+
+        const bool perEdge = (StressField(fieldType) == StressField::StretchingStress);
+        Eigen::VectorXd result(perEdge ? linkage.numVisualizationQuads() : linkage.numVisualizationVertices());
+        RodLinkage::StressFieldOutputs out;
+        out.fill(nullptr);
+        out[fieldType] = result.data();
+        linkage.stressVisualizationFields(1u << fieldType, out);
+        return result;
+    }
+
     // AttractedLinkage
     EROD_API SurfaceAttractedLinkage *erodXShellAttractedSurfaceBuild(int numVertices, int numTrias, double *inCoords, int *inTrias, RodLinkage *linkage, double tgt_joint_weight, const char **errorMessage)
     {
@@ -104,6 +270,107 @@ namespace ElasticRodsGH
         }
     }
 
+    EROD_API int erodXShellAttractedSurfaceSaveBinary(SurfaceAttractedLinkage *linkage, const char *path, const char **errorMessage)
+    {
+        try
+        {
+            saveBinary(*linkage, path);
+            *errorMessage = "";
+            return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
+        }
+    }
+
+    EROD_API SurfaceAttractedLinkage *erodXShellAttractedSurfaceLoadBinary(const char *path, const char **errorMessage)
+    {
+        try
+        {
+            std::ifstream is(path, std::ios::binary);
+            if (!is.is_open()) throw std::runtime_error(std::string("Failed to open input file ") + path);
+            *errorMessage = "Attracted Linkage Loaded";
+            return loadedInOriginalOrder(LinkageBinaryIO::loadSurfaceAttractedLinkage(is));
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return nullptr;
+        }
+    }
+
+    EROD_API int erodXShellAttractedSurfaceSerializeBinary(SurfaceAttractedLinkage *linkage, unsigned char **outData, size_t *numBytes, const char **errorMessage)
+    {
+        try
+        {
+            copyBytes(serializeBinary(*linkage), outData, numBytes);
+            *errorMessage = "";
+            return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
+        }
+    }
+
+    EROD_API SurfaceAttractedLinkage *erodXShellAttractedSurfaceDeserializeBinary(const unsigned char *data, size_t numBytes, const char **errorMessage)
+    {
+        try
+        {
+            std::istringstream is(std::string(reinterpret_cast<const char *>(data), numBytes), std::ios::binary);
+            *errorMessage = "Attracted Linkage Loaded";
+            return loadedInOriginalOrder(LinkageBinaryIO::loadSurfaceAttractedLinkage(is));
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return nullptr;
+        }
+    }
+
     // Target Surface
     EROD_API int erodXShellInferTargetSurface(RodLinkage *linkage, size_t nsubdiv, size_t numExtensionLayers, double **outCoords, int **outTrias, size_t *numCoords, size_t *numTrias, const char **errorMessage)
     {
@@ -250,6 +517,107 @@ namespace ElasticRodsGH
         }
     }
 
+    EROD_API int erodXShellSaveBinary(RodLinkage *linkage, const char *path, const char **errorMessage)
+    {
+        try
+        {
+            saveBinary(*linkage, path);
+            *errorMessage = "";
+            return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
+        }
+    }
+
+    EROD_API RodLinkage *erodXShellLoadBinary(const char *path, const char **errorMessage)
+    {
+        try
+        {
+            std::ifstream is(path, std::ios::binary);
+            if (!is.is_open()) throw std::runtime_error(std::string("Failed to open input file ") + path);
+            *errorMessage = "Rod Linkage Loaded";
+            return loadedInOriginalOrder(LinkageBinaryIO::loadRodLinkage(is));
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return nullptr;
+        }
+    }
+
+    EROD_API int erodXShellSerializeBinary(RodLinkage *linkage, unsigned char **outData, size_t *numBytes, const char **errorMessage)
+    {
+        try
+        {
+            copyBytes(serializeBinary(*linkage), outData, numBytes);
+            *errorMessage = "";
+            return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
+        }
+    }
+
+    EROD_API RodLinkage *erodXShellDeserializeBinary(const unsigned char *data, size_t numBytes, const char **errorMessage)
+    {
+        try
+        {
+            std::istringstream is(std::string(reinterpret_cast<const char *>(data), numBytes), std::ios::binary);
+            *errorMessage = "Rod Linkage Loaded";
+            return loadedInOriginalOrder(LinkageBinaryIO::loadRodLinkage(is));
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return nullptr;
+        }
+    }
+
     EROD_API RodLinkage *erodXShellBuild(int numVertices, int numEdges, double *inCoords, int *inEdges, double *inNormals,
                                                       double *inRestLengths, int *inOffsetInteriorCoords, double *inInteriorCoords,
                                                       int interleavingType, int initConsistentAngle, int initConsistentNormals, const char **errorMessage)
@@ -640,48 +1008,24 @@ namespace ElasticRodsGH
 
     EROD_API void erodXShellGetMeshData(RodLinkage *linkage, double **outCoords, int **outQuads, size_t *numCoords, size_t *numQuads)
     {
-        std::vector<MeshIO::IOVertex> vertices;
-        std::vector<MeshIO::IOElement> quads;
-        linkage->visualizationGeometry(vertices, quads, true, true);
-
-        *numCoords = vertices.size() * 3;
-        auto sizeCoords = (*numCoords) * sizeof(double);
-        *outCoords = static_cast<double *>(malloc(sizeCoords));
-        std::vector<double> coords;
-        for (size_t i = 0; i < vertices.size(); i++)
-        {
-            auto v = vertices[i].point;
-            coords.push_back(v[0]);
-            coords.push_back(v[1]);
-            coords.push_back(v[2]);
-        }
-        std::memcpy(*outCoords, coords.data(), sizeCoords);
-
-        *numQuads = quads.size() * 4;
-        auto sizeQuads = (*numQuads) * sizeof(int);
-        *outQuads = static_cast<int *>(malloc(sizeQuads));
-        std::vector<int> quadsIdx;
-        for (size_t i = 0; i < quads.size(); i++)
-        {
-            auto q = quads[i];
-            quadsIdx.push_back(q[0]);
-            quadsIdx.push_back(q[1]);
-            quadsIdx.push_back(q[2]);
-            quadsIdx.push_back(q[3]);
-        }
-        std::memcpy(*outQuads, quadsIdx.data(), sizeQuads);
+        erodXShellGetMeshDataCount(linkage, numCoords, numQuads);
+        *outCoords = static_cast<double *>(malloc((*numCoords) * sizeof(double)));
+        *outQuads = static_cast<int *>(malloc((*numQuads) * sizeof(int)));
+        erodXShellFillMeshPositions(linkage, *outCoords, nullptr, *numCoords);
+        erodXShellFillMeshConnectivity(linkage, *outQuads, *numQuads);
     }
 
     EROD_API void erodXShellGetRodSegmentIndexesPerRod(RodLinkage *linkage, int index, int **segmentIndexes, size_t *numSeg, int *type)
     {
-        const auto data = linkage->traceRods()[index];
+        const auto &data = linkage->traceRods().at(index);
         *type = std::get<0>(data);
-        const auto vec = std::get<1>(data);
+        const auto &vec = std::get<1>(data);
 
         *numSeg = vec.size();
         auto size = (*numSeg) * sizeof(int);
         *segmentIndexes = static_cast<int *>(malloc(size));
-        std::memcpy(*segmentIndexes, vec.data(), size);
+        for (size_t i = 0; i < vec.size(); i++)
+            (*segmentIndexes)[i] = static_cast<int>(vec[i]);
     }
 
     EROD_API size_t erodXShellGetRodTraceCount(RodLinkage *linkage, const char **errorMessage)
@@ -708,6 +1052,47 @@ namespace ElasticRodsGH
         }
     }
 
+    EROD_API int erodXShellGetRodSegmentTable(RodLinkage *linkage, int **outSegmentIndexes, int **outRodOffsets, int **outRodTypes,
+                                              size_t *numRods, size_t *numSegments, const char **errorMessage)
+    {
+        try
+        {
+            const auto &rods = linkage->traceRods();
+            *numRods = rods.size();
+            *outRodOffsets = static_cast<int *>(malloc((rods.size() + 1) * sizeof(int)));
+            *outRodTypes = static_cast<int *>(malloc(rods.size() * sizeof(int)));
+
+            size_t count = 0;
+            (*outRodOffsets)[0] = 0;
+            for (size_t ri = 0; ri < rods.size(); ri++)
+            {
+                (*outRodTypes)[ri] = std::get<0>(rods[ri]);
+                count += std::get<1>(rods[ri]).size();
+                (*outRodOffsets)[ri + 1] = static_cast<int>(count);
+            }
+
+            *numSegments = count;
+            *outSegmentIndexes = static_cast<int *>(malloc(count * sizeof(int)));
+            int *out = *outSegmentIndexes;
+            for (const auto &rod : rods)
+                for (size_t si : std::get<1>(rod))
+                    *out++ = static_cast<int>(si);
+
+            *errorMessage = "Trace Built";
+            return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
+        }
+    }
+
     EROD_API void erodXShellRemoveRestCurvatures(RodLinkage *linkage)
     {
         for (auto &seg : linkage->segments())
@@ -964,10 +1349,410 @@ namespace ElasticRodsGH
         std::memcpy(*outAngles, angles.data(), sizeAngles);
     }
     
+    // Bulk export: flattened per-segment and per-joint data for the whole linkage in a single call.
+    EROD_API void erodXShellGetSegmentOffsets(RodLinkage *linkage, int **outVertexOffsets, int **outEdgeOffsets, size_t *numOffsets)
+    {
+        const auto vtxOffsets = segmentOffsets(*linkage, false);
+        const auto edgeOffsets = segmentOffsets(*linkage, true);
+
+        *numOffsets = vtxOffsets.size();
+        auto sizeData = (*numOffsets) * sizeof(int);
+        *outVertexOffsets = static_cast<int *>(malloc(sizeData));
+        *outEdgeOffsets = static_cast<int *>(malloc(sizeData));
+        for (size_t i = 0; i < vtxOffsets.size(); i++)
+        {
+            (*outVertexOffsets)[i] = static_cast<int>(vtxOffsets[i]);
+            (*outEdgeOffsets)[i] = static_cast<int>(edgeOffsets[i]);
+        }
+    }
+
+    EROD_API void erodXShellGetSegmentsCenterLinePositions(RodLinkage *linkage, double **outCoords, size_t *numCoords)
+    {
+        const auto offsets = segmentOffsets(*linkage, false);
+        *numCoords = offsets.back() * 3;
+        *outCoords = gatherSegmentData(*linkage, offsets, 3, segmentCenterLinePositions<double>);
+    }
+
+    EROD_API void erodXShellGetSegmentsMaterialFrames(RodLinkage *linkage, double **outCoordsD1, double **outCoordsD2, size_t *numCoords)
+    {
+        const auto offsets = segmentOffsets(*linkage, true);
+        *numCoords = offsets.back() * 3;
+        *outCoordsD1 = gatherSegmentData(*linkage, offsets, 3, segmentMaterialFramesD1<double>);
+        *outCoordsD2 = gatherSegmentData(*linkage, offsets, 3, segmentMaterialFramesD2<double>);
+    }
+
+    EROD_API void erodXShellGetSegmentsRestData(RodLinkage *linkage, double **outRestLengths, double **outRestKappas, double **outRestTwists,
+                                                double **outRestPoints, double **outRestDirectors, size_t *numEdges, size_t *numVertices)
+    {
+        const auto vtxOffsets = segmentOffsets(*linkage, false);
+        const auto edgeOffsets = segmentOffsets(*linkage, true);
+        *numEdges = edgeOffsets.back();
+        *numVertices = vtxOffsets.back();
+
+        *outRestLengths = gatherSegmentData(*linkage, edgeOffsets, 1, [](const ElasticRod &rod, double *out)
+        {
+            const auto &data = rod.restLengths();
+            std::copy(data.begin(), data.end(), out);
+        });
+        *outRestKappas = gatherSegmentData(*linkage, vtxOffsets, 2, [](const ElasticRod &rod, double *out)
+        {
+            const auto &kappas = rod.restKappas();
+            for (size_t i = 0; i < kappas.size(); i++)
+            {
+                out[2 * i] = kappas[i][0];
+                out[2 * i + 1] = kappas[i][1];
+            }
+        });
+        *outRestTwists = gatherSegmentData(*linkage, vtxOffsets, 1, [](const ElasticRod &rod, double *out)
+        {
+            const auto &data = rod.restTwists();
+            std::copy(data.begin(), data.end(), out);
+        });
+        *outRestPoints = gatherSegmentData(*linkage, vtxOffsets, 3, [](const ElasticRod &rod, double *out)
+        {
+            const auto &pts = rod.restPoints();
+            for (size_t i = 0; i < pts.size(); i++) copyVec3(pts[i], out + 3 * i);
+        });
+        *outRestDirectors = gatherSegmentData(*linkage, edgeOffsets, 6, [](const ElasticRod &rod, double *out)
+        {
+            const auto &dir = rod.restDirectors();
+            for (size_t j = 0; j < dir.size(); j++)
+            {
+                copyVec3(dir[j].d1, out + 6 * j);
+                copyVec3(dir[j].d2, out + 6 * j + 3);
+            }
+        });
+    }
+
+    EROD_API void erodXShellGetSegmentsStiffnesses(RodLinkage *linkage, double **outBendingStiffness, double **outTwistingStiffness, double **outStretchingStiffness,
+                                                   size_t *numEdges, size_t *numVertices)
+    {
+        const auto vtxOffsets = segmentOffsets(*linkage, false);
+        const auto edgeOffsets = segmentOffsets(*linkage, true);
+        *numEdges = edgeOffsets.back();
+        *numVertices = vtxOffsets.back();
+
+        *outBendingStiffness = gatherSegmentData(*linkage, vtxOffsets, 2, [](const ElasticRod &rod, double *out)
+        {
+            const auto &s = rod.bendingStiffnesses();
+            for (size_t i = 0; i < s.size(); i++)
+            {
+                out[2 * i] = s[i].lambda_1;
+                out[2 * i + 1] = s[i].lambda_2;
+            }
+        });
+        *outTwistingStiffness = gatherSegmentData(*linkage, vtxOffsets, 1, [](const ElasticRod &rod, double *out)
+        {
+            const auto &data = rod.twistingStiffnesses();
+            std::copy(data.begin(), data.end(), out);
+        });
+        *outStretchingStiffness = gatherSegmentData(*linkage, edgeOffsets, 1, [](const ElasticRod &rod, double *out)
+        {
+            const auto &data = rod.stretchingStiffnesses();
+            std::copy(data.begin(), data.end(), out);
+        });
+    }
+
+    EROD_API void erodXShellGetJointsData(RodLinkage *linkage, double **outPositions, double **outNormals, double **outEdgeVecsA, double **outEdgeVecsB,
+                                          double **outOmegas, double **outSourceTangents, double **outSourceNormals, double **outAngles, double **outLengths,
+                                          int **outSegments, int **outTypes, size_t *numJoints)
+    {
+        using Joint = RodLinkage::Joint;
+        *numJoints = linkage->numJoints();
+
+        *outPositions      = gatherJointData<double>(*linkage, 3, [](const Joint &j, double *out) { copyVec3(j.pos(), out); });
+        *outNormals        = gatherJointData<double>(*linkage, 3, [](const Joint &j, double *out) { copyVec3(j.normal(), out); });
+        *outEdgeVecsA      = gatherJointData<double>(*linkage, 3, [](const Joint &j, double *out) { copyVec3(j.source_t_A(), out); });
+        *outEdgeVecsB      = gatherJointData<double>(*linkage, 3, [](const Joint &j, double *out) { copyVec3(j.source_t_B(), out); });
+        *outOmegas         = gatherJointData<double>(*linkage, 3, [](const Joint &j, double *out) { copyVec3(j.omega(), out); });
+        *outSourceTangents = gatherJointData<double>(*linkage, 3, [](const Joint &j, double *out) { copyVec3(j.source_tangent(), out); });
+        *outSourceNormals  = gatherJointData<double>(*linkage, 3, [](const Joint &j, double *out) { copyVec3(j.source_normal(), out); });
+        *outAngles         = gatherJointData<double>(*linkage, 1, [](const Joint &j, double *out) { out[0] = j.alpha(); });
+        *outLengths        = gatherJointData<double>(*linkage, 2, [](const Joint &j, double *out)
+        {
+            out[0] = j.len_A();
+            out[1] = j.len_B();
+        });
+        // Segments A0, A1, B0, B1 incident to each joint (-1 if absent)
+        *outSegments       = gatherJointData<int>(*linkage, 4, [](const Joint &j, int *out)
+        {
+            const auto sA = j.segmentsA();
+            const auto sB = j.segmentsB();
+            for (size_t i = 0; i < 2; i++)
+            {
+                out[i] = (sA[i] == RodLinkage::NONE) ? -1 : static_cast<int>(sA[i]);
+                out[2 + i] = (sB[i] == RodLinkage::NONE) ? -1 : static_cast<int>(sB[i]);
+            }
+        });
+        *outTypes          = gatherJointData<int>(*linkage, 1, [](const Joint &j, int *out) { out[0] = static_cast<int>(j.type); });
+    }
+
+    // Caller-provided buffers: the following fill arrays allocated (and possibly
+    // pinned and reused) by the caller instead of returning malloc-ed copies.
+    // Buffer sizes are given in number of values and must match the size
+    // queries exactly; the functions return 0 on success and 1 on a mismatch.
+    EROD_API void erodXShellGetMeshDataCount(RodLinkage *linkage, size_t *numCoords, size_t *numQuads)
+    {
+        *numCoords = linkage->numVisualizationVertices() * 3;
+        *numQuads = linkage->numVisualizationQuads() * 4;
+    }
+
+    EROD_API size_t erodXShellGetScalarFieldCount(RodLinkage *linkage)
+    {
+        return linkage->numVisualizationVertices();
+    }
+
+    EROD_API size_t erodXShellGetRestLengthsSolveDoFCount(RodLinkage *linkage)
+    {
+        return linkage->numRestlenSolveDof();
+    }
+
+    EROD_API int erodXShellFillDoFs(RodLinkage *linkage, double *outDoFs, size_t numDoFs)
+    {
+        const auto dofs = linkage->getDoFs();
+        return fillBuffer(dofs.data(), dofs.size(), outDoFs, numDoFs);
+    }
+
+    EROD_API int erodXShellFillCenterLinePositions(RodLinkage *linkage, double *outCoords, size_t numCoords)
+    {
+        const auto pos = linkage->centerLinePositions();
+        return fillBuffer(pos.data(), pos.size(), outCoords, numCoords);
+    }
+
+    EROD_API int erodXShellFillMeshData(RodLinkage *linkage, double *outCoords, int *outQuads, size_t numCoords, size_t numQuads)
+    {
+        if (erodXShellFillMeshPositions(linkage, outCoords, nullptr, numCoords) != 0)
+            return 1;
+        return erodXShellFillMeshConnectivity(linkage, outQuads, numQuads);
+    }
+
+    EROD_API int erodXShellFillMeshConnectivity(RodLinkage *linkage, int *outQuads, size_t numQuads)
+    {
+        if (linkage->numVisualizationQuads() * 4 != numQuads)
+            return 1;
+
+        std::vector<MeshIO::IOElement> quads;
+        linkage->visualizationQuads(quads);
+        for (size_t i = 0; i < quads.size(); i++)
+        {
+            for (size_t j = 0; j < 4; j++)
+                outQuads[4 * i + j] = quads[i][j];
+        }
+        return 0;
+    }
+
+    EROD_API int erodXShellFillMeshPositions(RodLinkage *linkage, double *outCoords, double *outNormals, size_t numCoords)
+    {
+        if (linkage->numVisualizationVertices() * 3 != numCoords)
+            return 1;
+        try
+        {
+            linkage->visualizationPositions(outCoords, outNormals, true, true);
+        }
+        catch (...)
+        {
+            return 1;
+        }
+        return 0;
+    }
+
+    EROD_API int erodXShellFillScalarField(RodLinkage *linkage, int fieldType, double *outField, size_t numField)
+    {
+        using StressField = RodLinkage::StressField;
+        if ((fieldType < 0) || (fieldType >= int(StressField::Count)))
+            return 2;
+        try
+        {
+            const Eigen::VectorXd field = linkageScalarField(*linkage, fieldType);
+            return fillBuffer(field.data(), size_t(field.size()), outField, numField);
+        }
+        catch (...)
+        {
+            return 3;
+        }
+    }
+
+    EROD_API int erodXShellFillScalarFields(RodLinkage *linkage, double *outSqrtBendingEnergies, double *outMaxBendingStresses, double *outMinBendingStresses,
+                                            double *outVonMisesStresses, double *outTwistingStresses, double *outStretchingStresses,
+                                            size_t numField, size_t numEdgeField)
+    {
+        using StressField = RodLinkage::StressField;
+        if ((numField != linkage->numVisualizationVertices()) || (numEdgeField != linkage->numVisualizationQuads()))
+            return 1;
+
+        const RodLinkage::StressFieldOutputs out = {{ outSqrtBendingEnergies, outMaxBendingStresses, outMinBendingStresses,
+                                                      outVonMisesStresses, outTwistingStresses, outStretchingStresses }};
+        unsigned fieldMask = 0;
+        for (size_t f = 0; f < size_t(StressField::Count); f++)
+        {
+            if (out[f] != nullptr) fieldMask |= 1u << f;
+        }
+
+        try
+        {
+            linkage->stressVisualizationFields(fieldMask, out);
+        }
+        catch (...)
+        {
+            return 1;
+        }
+        return 0;
+    }
+
+    EROD_API int erodXShellFillDesignParams(RodLinkage *linkage, double *outDesignParams, size_t numDesignParams)
+    {
+        const auto data = linkage->getDesignParameters();
+        return fillBuffer(data.data(), data.size(), outDesignParams, numDesignParams);
+    }
+
+    EROD_API int erodXShellFillRestKappaVars(RodLinkage *linkage, double *outData, size_t numData)
+    {
+        const auto data = linkage->getRestKappaVars();
+        return fillBuffer(data.data(), data.size(), outData, numData);
+    }
+
+    EROD_API int erodXShellFillPerSegmentRestLengths(RodLinkage *linkage, double *outLengths, size_t numLengths)
+    {
+        const auto data = linkage->getPerSegmentRestLength();
+        return fillBuffer(data.data(), data.size(), outLengths, numLengths);
+    }
+
+    EROD_API int erodXShellFillRestLengthsSolveDoFs(RodLinkage *linkage, double *outDoFs, size_t numDoFs)
+    {
+        const auto data = linkage->getRestlenSolveDoF();
+        return fillBuffer(data.data(), data.size(), outDoFs, numDoFs);
+    }
+
+    EROD_API int erodXShellFillJointAngles(RodLinkage *linkage, double *outAngles, size_t numAngles)
+    {
+        if (numAngles != linkage->numJoints())
+            return 1;
+        forEachIndex(numAngles, [&](size_t ji) { outAngles[ji] = linkage->joint(ji).alpha(); });
+        return 0;
+    }
+
+    EROD_API int erodXShellFillSegmentsCenterLinePositions(RodLinkage *linkage, double *outCoords, size_t numCoords)
+    {
+        const auto offsets = segmentOffsets(*linkage, false);
+        if (numCoords != offsets.back() * 3)
+            return 1;
+        fillSegmentData(*linkage, offsets, 3, outCoords, segmentCenterLinePositions<double>);
+        return 0;
+    }
+
+    EROD_API int erodXShellFillSegmentsMaterialFrames(RodLinkage *linkage, double *outCoordsD1, double *outCoordsD2, size_t numCoords)
+    {
+        const auto offsets = segmentOffsets(*linkage, true);
+        if (numCoords != offsets.back() * 3)
+            return 1;
+        fillSegmentData(*linkage, offsets, 3, outCoordsD1, segmentMaterialFramesD1<double>);
+        fillSegmentData(*linkage, offsets, 3, outCoordsD2, segmentMaterialFramesD2<double>);
+        return 0;
+    }
+
+    EROD_API int erodXShellFillJointPositions(RodLinkage *linkage, double *outPositions, size_t numCoords)
+    {
+        if (numCoords != linkage->numJoints() * 3)
+            return 1;
+        forEachIndex(linkage->numJoints(), [&](size_t ji) { copyVec3(linkage->joint(ji).pos(), outPositions + 3 * ji); });
+        return 0;
+    }
+
+    // Single-precision exports
+    EROD_API int erodXShellFillCenterLinePositionsFloat(RodLinkage *linkage, float *outCoords, size_t numCoords)
+    {
+        const auto pos = linkage->centerLinePositions();
+        return fillBuffer(pos.data(), pos.size(), outCoords, numCoords);
+    }
+
+    EROD_API int erodXShellFillMeshPositionsFloat(RodLinkage *linkage, float *outCoords, float *outNormals, size_t numCoords)
+    {
+        if (linkage->numVisualizationVertices() * 3 != numCoords)
+            return 1;
+        try
+        {
+            linkage->visualizationPositions(outCoords, outNormals, true, true);
+        }
+        catch (...)
+        {
+            return 1;
+        }
+        return 0;
+    }
+
+    EROD_API int erodXShellFillScalarFieldFloat(RodLinkage *linkage, int fieldType, float *outField, size_t numField)
+    {
+        using StressField = RodLinkage::StressField;
+        if ((fieldType < 0) || (fieldType >= int(StressField::Count)))
+            return 2;
+        const bool perEdge = (StressField(fieldType) == StressField::StretchingStress);
+        if (numField != (perEdge ? linkage->numVisualizationQuads() : linkage->numVisualizationVertices()))
+            return 1;
+
+        RodLinkage::StressFieldOutputsF out;
+        out.fill(nullptr);
+        out[fieldType] = outField;
+        try
+        {
+            linkage->stressVisualizationFields(1u << fieldType, out);
+        }
+        catch (...)
+        {
+            return 3;
+        }
+        return 0;
+    }
+
+    EROD_API int erodXShellFillScalarFieldsFloat(RodLinkage *linkage, float *outSqrtBendingEnergies, float *outMaxBendingStresses, float *outMinBendingStresses,
+                                                 float *outVonMisesStresses, float *outTwistingStresses, float *outStretchingStresses,
+                                                 size_t numField, size_t numEdgeField)
+    {
+        using StressField = RodLinkage::StressField;
+        if ((numField != linkage->numVisualizationVertices()) || (numEdgeField != linkage->numVisualizationQuads()))
+            return 1;
+
+        const RodLinkage::StressFieldOutputsF out = {{ outSqrtBendingEnergies, outMaxBendingStresses, outMinBendingStresses,
+                                                       outVonMisesStresses, outTwistingStresses, outStretchingStresses }};
+        unsigned fieldMask = 0;
+        for (size_t f = 0; f < size_t(StressField::Count); f++)
+        {
+            if (out[f] != nullptr) fieldMask |= 1u << f;
+        }
+
+        try
+        {
+            linkage->stressVisualizationFields(fieldMask, out);
+        }
+        catch (...)
+        {
+            return 1;
+        }
+        return 0;
+    }
+
+    EROD_API int erodXShellFillSegmentsCenterLinePositionsFloat(RodLinkage *linkage, float *outCoords, size_t numCoords)
+    {
+        const auto offsets = segmentOffsets(*linkage, false);
+        if (numCoords != offsets.back() * 3)
+            return 1;
+        fillSegmentData(*linkage, offsets, 3, outCoords, segmentCenterLinePositions<float>);
+        return 0;
+    }
+
+    EROD_API int erodXShellFillSegmentsMaterialFramesFloat(RodLinkage *linkage, float *outCoordsD1, float *outCoordsD2, size_t numCoords)
+    {
+        const auto offsets = segmentOffsets(*linkage, true);
+        if (numCoords != offsets.back() * 3)
+            return 1;
+        fillSegmentData(*linkage, offsets, 3, outCoordsD1, segmentMaterialFramesD1<float>);
+        fillSegmentData(*linkage, offsets, 3, outCoordsD2, segmentMaterialFramesD2<float>);
+        return 0;
+    }
+
     // Solver
     EROD_API int erodPeriodicElasticRodNewtonSolver(PeriodicRod *pRod, int numIterations, int numSupports, int numForces, int *supports, double *inForces,
                                                     double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                                    int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, const char **errorMessage)
+                                                    int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, erodNewtonProgressCallback progress, const char **errorMessage)
     {
         try
         {
@@ -986,6 +1771,7 @@ namespace ElasticRodsGH
             options.feasibilitySolve = feasibilitySolve;
             options.verboseNonPosDef = verboseNonPosDef;
             options.verbose = verbose;
+            options.progressCallback = newtonProgressCallback(progress);
 
             auto problem = equilibrium_problem(*pRod, fixedVars);
 
@@ -1007,6 +1793,8 @@ namespace ElasticRodsGH
 
             *errorMessage = "";
 
+            if (report.cancelled)
+                return 2;
             if (report.success)
                 return 1;
             else
@@ -1031,7 +1819,7 @@ namespace ElasticRodsGH
 
     EROD_API int erodElasticRodNewtonSolver(ElasticRod *rod, int numIterations, int numSupports, int numForces, int *supports, double *inForces,
                                             double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                            int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, const char **errorMessage)
+                                            int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, erodNewtonProgressCallback progress, const char **errorMessage)
     {
         try
         {
@@ -1050,6 +1838,7 @@ namespace ElasticRodsGH
             options.feasibilitySolve = feasibilitySolve;
             options.verboseNonPosDef = verboseNonPosDef;
             options.verbose = verbose;
+            options.progressCallback = newtonProgressCallback(progress);
 
             auto problem = equilibrium_problem(*rod, fixedVars);
 
@@ -1067,24 +1856,12 @@ namespace ElasticRodsGH
             solver.options = options;
             const auto report = solver.optimize();
 
-            if (writeReport)
-            {
-                std::vector<double> flatReport;
-                flatReport.push_back(report.success);
-                flatReport.push_back(report.backtracking_failure);
-                flatReport.insert(flatReport.end(), report.energy.begin(), report.energy.end());
-                flatReport.insert(flatReport.end(), report.gradientNorm.begin(), report.gradientNorm.end());
-                flatReport.insert(flatReport.end(), report.freeGradientNorm.begin(), report.freeGradientNorm.end());
-                flatReport.insert(flatReport.end(), report.stepLength.begin(), report.stepLength.end());
-                flatReport.insert(flatReport.end(), report.indefinite.begin(), report.indefinite.end());
-
-                auto sizeReport = (numIterations * 5 + 2) * sizeof(double);
-                *outReport = static_cast<double *>(malloc(sizeReport));
-                std::memcpy(*outReport, flatReport.data(), sizeReport);
-            }
+            if (writeReport) getConvergenceReport(report, outReport);
 
             *errorMessage = "";
 
+            if (report.cancelled)
+                return 2;
             if (report.success)
                 return 1;
             else
@@ -1092,134 +1869,671 @@ namespace ElasticRodsGH
         }
         catch (const std::runtime_error &error)
         {
-            *errorMessage = error.what();
-            return -1;
+            *errorMessage = error.what();
+            return -1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return -1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return -1;
+        }
+    }
+
+    EROD_API int erodXShellNewtonSolver(RodLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
+                                        double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
+                                        int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, erodNewtonProgressCallback progress, const char **errorMessage)
+    {
+        try
+        {
+            std::vector<size_t> fixedVars;
+            for (int i = 0; i < numSupports; i++)
+            {
+                fixedVars.push_back(supports[i]);
+            }
+
+            NewtonOptimizerOptions options;
+            options.gradTol = gradTol;
+            options.niter = numIterations;
+            options.beta = beta;
+            options.useIdentityMetric = useIdentityMetric;
+            options.useNegativeCurvatureDirection = useNegativeCurvatureDirection;
+            options.feasibilitySolve = feasibilitySolve;
+            options.verboseNonPosDef = verboseNonPosDef;
+            options.verbose = verbose;
+            options.progressCallback = newtonProgressCallback(progress);
+            options.arena = linkage->parallelismArena();
+
+            std::unique_ptr<EquilibriumProblem<RodLinkage>> problem;
+            if (deployedAngle == 0)
+                problem = equilibrium_problem(*linkage, fixedVars);
+            else
+                problem = equilibrium_problem(*linkage, deployedAngle, fixedVars);
+
+            if (includeForces && numForces > 0)
+            {
+                Eigen::VectorXd externalForces(numForces);
+                for (int i = 0; i < numForces; i++)
+                {
+                    externalForces(i) = inForces[i];
+                }
+                problem->external_forces = externalForces;
+            }
+
+            NewtonOptimizer solver(std::move(problem));
+            solver.options = options;
+            const auto report = solver.optimize();
+
+            if (writeReport) getConvergenceReport(report, outReport);
+
+            *errorMessage = "";
+            if (report.cancelled)
+                return 2;
+            if (report.success) return 1;
+            else return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return -1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return -1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown Error from the Unmanaged Code";
+            return -1;
+        }
+    }
+
+    EROD_API int erodXShellAttractedLinkageNewtonSolver(SurfaceAttractedLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
+                                                        double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
+                                                        int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, erodNewtonProgressCallback progress, const char **errorMessage)
+    {
+        try
+        {
+            std::vector<size_t> fixedVars;
+            for (int i = 0; i < numSupports; i++)
+            {
+                fixedVars.push_back(supports[i]);
+            }
+
+            NewtonOptimizerOptions options;
+            options.gradTol = gradTol;
+            options.niter = numIterations;
+            options.beta = beta;
+            options.useIdentityMetric = useIdentityMetric;
+            options.useNegativeCurvatureDirection = useNegativeCurvatureDirection;
+            options.feasibilitySolve = feasibilitySolve;
+            options.verboseNonPosDef = verboseNonPosDef;
+            options.verbose = verbose;
+            options.progressCallback = newtonProgressCallback(progress);
+            options.arena = linkage->parallelismArena();
+
+            std::unique_ptr<EquilibriumProblem<SurfaceAttractedLinkage>> problem;
+            if (deployedAngle == 0)
+                problem = equilibrium_problem(*linkage, fixedVars);
+            else
+                problem = equilibrium_problem(*linkage, deployedAngle, fixedVars);
+
+            if (includeForces && numForces > 0)
+            {
+                Eigen::VectorXd externalForces(numForces);
+                for (int i = 0; i < numForces; i++)
+                {
+                    externalForces(i) = inForces[i];
+                }
+                problem->external_forces = externalForces;
+            }
+
+            NewtonOptimizer solver(std::move(problem));
+            solver.options = options;
+            const auto report = solver.optimize();
+
+            if (writeReport) getConvergenceReport(report, outReport);
+
+            *errorMessage = "";
+
+            if (report.cancelled)
+                return 2;
+            if (report.success)
+                return 1;
+            else
+                return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return -1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return -1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return -1;
+        }
+    }
+
+    EROD_API int erodXShellLiveNewtonSolver(RodLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
+                                            double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
+                                            int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, const char **errorMessage)
+    {
+        try
+        {
+            std::vector<size_t> fixedVars;
+            for (int i = 0; i < numSupports; i++)
+            {
+                fixedVars.push_back(supports[i]);
+            }
+
+            NewtonOptimizerOptions options;
+            options.gradTol = gradTol;
+            options.niter = numIterations;
+            options.beta = beta;
+            options.useIdentityMetric = useIdentityMetric;
+            options.useNegativeCurvatureDirection = useNegativeCurvatureDirection;
+            options.feasibilitySolve = feasibilitySolve;
+            options.verboseNonPosDef = verboseNonPosDef;
+            options.verbose = verbose;
+
+            std::unique_ptr<EquilibriumProblem<RodLinkage>> problem;
+            if (deployedAngle == 0)
+                problem = equilibrium_problem(*linkage, fixedVars);
+            else
+                problem = equilibrium_problem(*linkage, deployedAngle, fixedVars);
+
+            if (includeForces && numForces > 0)
+            {
+                Eigen::VectorXd externalForces(numForces);
+                for (int i = 0; i < numForces; i++)
+                {
+                    externalForces(i) = inForces[i];
+                }
+                problem->external_forces = externalForces;
+            }
+
+            NewtonOptimizer solver(std::move(problem));
+            solver.options = options;
+            const auto report = solver.optimize();
+
+            if (writeReport) getConvergenceReport(report, outReport);
+
+            *errorMessage = "";
+
+            if (report.success)
+                return 1;
+            else
+                return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return -1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return -1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return -1;
+        }
+    }
+
+    // Asynchronous solves
+    template<class Object>
+    static AsyncEquilibriumSolveBase *startAsyncSolve(Object &obj, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
+                                                      double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
+                                                      int feasibilitySolve, int verboseNonPosDef, erodNewtonProgressCallback progress)
+    {
+        std::vector<size_t> fixedVars(supports, supports + numSupports);
+
+        NewtonOptimizerOptions options;
+        options.gradTol = gradTol;
+        options.niter = numIterations;
+        options.beta = beta;
+        options.useIdentityMetric = useIdentityMetric;
+        options.useNegativeCurvatureDirection = useNegativeCurvatureDirection;
+        options.feasibilitySolve = feasibilitySolve;
+        options.verboseNonPosDef = verboseNonPosDef;
+        options.verbose = verbose;
+        options.progressCallback = newtonProgressCallback(progress);
+        options.arena = obj.parallelismArena();
+
+        Eigen::VectorXd externalForces;
+        if (includeForces && numForces > 0) externalForces = Eigen::Map<const Eigen::VectorXd>(inForces, numForces);
+
+        return new AsyncEquilibriumSolve<Object>(obj, options, fixedVars, externalForces, (deployedAngle == 0) ? TARGET_ANGLE_NONE : deployedAngle);
+    }
+
+    EROD_API AsyncEquilibriumSolveBase *erodXShellNewtonSolveAsync(RodLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
+                                                                   double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
+                                                                   int feasibilitySolve, int verboseNonPosDef, erodNewtonProgressCallback progress, const char **errorMessage)
+    {
+        try
+        {
+            *errorMessage = "";
+            return startAsyncSolve(*linkage, numIterations, deployedAngle, numSupports, numForces, supports, inForces, gradTol, beta, includeForces, verbose,
+                                   useIdentityMetric, useNegativeCurvatureDirection, feasibilitySolve, verboseNonPosDef, progress);
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return nullptr;
+        }
+    }
+
+    EROD_API AsyncEquilibriumSolveBase *erodXShellAttractedLinkageNewtonSolveAsync(SurfaceAttractedLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
+                                                                                   double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
+                                                                                   int feasibilitySolve, int verboseNonPosDef, erodNewtonProgressCallback progress, const char **errorMessage)
+    {
+        try
+        {
+            *errorMessage = "";
+            return startAsyncSolve(*linkage, numIterations, deployedAngle, numSupports, numForces, supports, inForces, gradTol, beta, includeForces, verbose,
+                                   useIdentityMetric, useNegativeCurvatureDirection, feasibilitySolve, verboseNonPosDef, progress);
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return nullptr;
+        }
+    }
+
+    EROD_API int erodAsyncSolveIsFinished(AsyncEquilibriumSolveBase *job)
+    {
+        return job->finished() ? 1 : 0;
+    }
+
+    EROD_API int erodAsyncSolveWait(AsyncEquilibriumSolveBase *job, double timeoutSeconds)
+    {
+        return job->wait(timeoutSeconds) ? 1 : 0;
+    }
+
+    EROD_API void erodAsyncSolveCancel(AsyncEquilibriumSolveBase *job)
+    {
+        job->cancel();
+    }
+
+    EROD_API void erodAsyncSolveGetProgress(AsyncEquilibriumSolveBase *job, int *iteration, double *energy)
+    {
+        *iteration = static_cast<int>(job->iteration());
+        *energy = job->energy();
+    }
+
+    EROD_API int erodAsyncSolveGetResult(AsyncEquilibriumSolveBase *job, int writeReport, double **outReport, const char **errorMessage)
+    {
+        try
+        {
+            const ConvergenceReport &report = job->report();
+
+            if (writeReport) getConvergenceReport(report, outReport);
+
+            *errorMessage = "";
+            if (report.cancelled)
+                return 2;
+            if (report.success) return 1;
+            else return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return -1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return -1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return -1;
+        }
+    }
+
+    template<class Object>
+    static void publishAsyncSolve(AsyncEquilibriumSolveBase *job, Object &target)
+    {
+        auto typedJob = dynamic_cast<AsyncEquilibriumSolve<Object> *>(job);
+        if (typedJob == nullptr) throw std::runtime_error("The solve was not started for this type of linkage");
+        typedJob->publish(target);
+    }
+
+    EROD_API int erodXShellAsyncSolvePublish(AsyncEquilibriumSolveBase *job, RodLinkage *linkage, const char **errorMessage)
+    {
+        try
+        {
+            publishAsyncSolve(job, *linkage);
+            *errorMessage = "";
+            return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
+        }
+    }
+
+    EROD_API int erodXShellAttractedLinkageAsyncSolvePublish(AsyncEquilibriumSolveBase *job, SurfaceAttractedLinkage *linkage, const char **errorMessage)
+    {
+        try
+        {
+            publishAsyncSolve(job, *linkage);
+            *errorMessage = "";
+            return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
+        }
+    }
+
+    EROD_API void erodAsyncSolveRelease(AsyncEquilibriumSolveBase *job)
+    {
+        delete job;
+    }
+
+    // Parallelism
+    EROD_API ParallelismArena *erodParallelismArenaBuild(int numThreads, int firstPinnedCore, const char **errorMessage)
+    {
+        try
+        {
+            *errorMessage = "";
+            return new ParallelismArena((numThreads > 0) ? numThreads : ParallelismArena::automatic, firstPinnedCore);
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return nullptr;
+        }
+    }
+
+    EROD_API int erodParallelismArenaGetMaxConcurrency(ParallelismArena *arena)
+    {
+        return arena->maxConcurrency();
+    }
+
+    EROD_API void erodParallelismArenaRelease(ParallelismArena *arena)
+    {
+        delete arena;
+    }
+
+    EROD_API void erodXShellSetParallelismArena(RodLinkage *linkage, ParallelismArena *arena)
+    {
+        linkage->setParallelismArena((arena != nullptr) ? *arena : ParallelismArena());
+    }
+
+    EROD_API int erodSetMaxNumThreads(int numThreads, const char **errorMessage)
+    {
+        try
+        {
+#if MESHFEM_WITH_TBB
+            if (numThreads > 0) set_max_num_tbb_threads(numThreads);
+            else unset_max_num_tbb_threads();
+#else
+            throw std::runtime_error("TBB Disabled");
+#endif
+            *errorMessage = "";
+            return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
+        }
+    }
+
+    // Profiling
+    // Preorder traversal of the merged profiler tree; parents[i] is the index of
+    // the parent section of section i (-1 for top-level sections).
+    void flattenProfile(const Profiler::Node &node, int parent, std::string &names, std::vector<int> &parents,
+                        std::vector<double> &seconds, std::vector<size_t> &calls)
+    {
+        for (const auto &child : node.children)
+        {
+            const int index = int(parents.size());
+            names += child.name;
+            names += '\n';
+            parents.push_back(parent);
+            seconds.push_back(child.seconds);
+            calls.push_back(child.calls);
+            flattenProfile(child, index, names, parents, seconds, calls);
+        }
+    }
+
+    EROD_API void erodProfilerSetEnabled(int enable)
+    {
+        Profiler::setEnabled(enable != 0);
+    }
+
+    EROD_API int erodProfilerIsEnabled()
+    {
+        return Profiler::enabled() ? 1 : 0;
+    }
+
+    EROD_API void erodProfilerReset()
+    {
+        Profiler::reset();
+    }
+
+    EROD_API int erodProfilerGetReport(char **outNames, int **outParents, double **outSeconds, size_t **outCalls, size_t *numSections, const char **errorMessage)
+    {
+        try
+        {
+            std::string names;
+            std::vector<int> parents;
+            std::vector<double> seconds;
+            std::vector<size_t> calls;
+            flattenProfile(Profiler::report(), -1, names, parents, seconds, calls);
+
+            const size_t n = parents.size();
+            *numSections = n;
+            *outNames = static_cast<char *>(malloc(names.size() + 1));
+            std::memcpy(*outNames, names.c_str(), names.size() + 1);
+            *outParents = static_cast<int    *>(malloc(n * sizeof(int)));
+            *outSeconds = static_cast<double *>(malloc(n * sizeof(double)));
+            *outCalls   = static_cast<size_t *>(malloc(n * sizeof(size_t)));
+            std::copy(parents.begin(), parents.end(), *outParents);
+            std::copy(seconds.begin(), seconds.end(), *outSeconds);
+            std::copy(calls.begin(),   calls.end(),   *outCalls);
+            *errorMessage = "";
+            return 0;
         }
-        catch (const std::out_of_range &error)
+        catch (const std::runtime_error &error)
         {
             *errorMessage = error.what();
-            return -1;
+            return 1;
         }
         catch (...)
         {
             *errorMessage = "Unknown error from the c++ library.";
-            return -1;
+            return 1;
         }
     }
 
-    EROD_API int erodXShellNewtonSolver(RodLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
-                                        double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                        int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, const char **errorMessage)
+    // Memory
+    void getMemoryReport(const MemoryReport &report, char **outNames, size_t **outBytes, size_t *numComponents)
     {
-        try
+        std::string names;
+        for (const auto &c : report.components)
         {
-            std::vector<size_t> fixedVars;
-            for (int i = 0; i < numSupports; i++)
-            {
-                fixedVars.push_back(supports[i]);
-            }
-
-            NewtonOptimizerOptions options;
-            options.gradTol = gradTol;
-            options.niter = numIterations;
-            options.beta = beta;
-            options.useIdentityMetric = useIdentityMetric;
-            options.useNegativeCurvatureDirection = useNegativeCurvatureDirection;
-            options.feasibilitySolve = feasibilitySolve;
-            options.verboseNonPosDef = verboseNonPosDef;
-            options.verbose = verbose;
-
-            std::unique_ptr<EquilibriumProblem<RodLinkage>> problem;
-            if (deployedAngle == 0)
-                problem = equilibrium_problem(*linkage, fixedVars);
-            else
-                problem = equilibrium_problem(*linkage, deployedAngle, fixedVars);
-
-            if (includeForces && numForces > 0)
-            {
-                Eigen::VectorXd externalForces(numForces);
-                for (int i = 0; i < numForces; i++)
-                {
-                    externalForces(i) = inForces[i];
-                }
-                problem->external_forces = externalForces;
-            }
-
-            NewtonOptimizer solver(std::move(problem));
-            solver.options = options;
-            const auto report = solver.optimize();
+            names += c.first;
+            names += '\n';
+        }
 
-            if (writeReport) getConvergenceReport(report, outReport);
+        const size_t n = report.components.size();
+        *numComponents = n;
+        *outNames = static_cast<char *>(malloc(names.size() + 1));
+        std::memcpy(*outNames, names.c_str(), names.size() + 1);
+        *outBytes = static_cast<size_t *>(malloc(n * sizeof(size_t)));
+        for (size_t i = 0; i < n; ++i) (*outBytes)[i] = report.components[i].second;
+    }
 
+    EROD_API int erodXShellGetMemoryReport(RodLinkage *linkage, char **outNames, size_t **outBytes, size_t *numComponents, const char **errorMessage)
+    {
+        try
+        {
+            getMemoryReport(linkage->memoryReport(), outNames, outBytes, numComponents);
             *errorMessage = "";
-            if (report.success) return 1;
-            else return 0;
+            return 0;
         }
         catch (const std::runtime_error &error)
         {
             *errorMessage = error.what();
-            return -1;
+            return 1;
         }
-        catch (const std::out_of_range &error)
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
+        }
+    }
+
+    EROD_API int erodAsyncSolveGetMemoryReport(AsyncEquilibriumSolveBase *job, char **outNames, size_t **outBytes, size_t *numComponents, const char **errorMessage)
+    {
+        try
+        {
+            getMemoryReport(job->memoryReport(), outNames, outBytes, numComponents);
+            *errorMessage = "";
+            return 0;
+        }
+        catch (const std::runtime_error &error)
         {
             *errorMessage = error.what();
-            return -1;
+            return 1;
         }
         catch (...)
         {
-            *errorMessage = "Unknown Error from the Unmanaged Code";
-            return -1;
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
         }
     }
 
-    EROD_API int erodXShellAttractedLinkageNewtonSolver(SurfaceAttractedLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
-                                                        double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                                        int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, const char **errorMessage)
+    // Weaving Optimization
+    static WeavingIterateCallback weavingIterateCallback(erodWeavingIterateCallback callback)
+    {
+        if (callback == nullptr) return nullptr;
+        return [callback](const WeavingIterate &it)
+        {
+            return callback(static_cast<int>(it.iteration), it.J, it.J_target, it.designParameters.data(), static_cast<size_t>(it.designParameters.size()), it.dofs.data(), static_cast<size_t>(it.dofs.size())) != 0;
+        };
+    }
+
+    EROD_API int erodWeavingOptimize(SurfaceAttractedLinkage *linkage, int numVertices, int numTrias, double *inCoords, int *inTrias,
+                                     double beta, double gamma, double restLengthWeight, double smoothingWeight, double contactForceWeight, double attractionWeight,
+                                     int algorithm, int numSteps, double trustRegionScale, double optimalityTol, double minRestLen,
+                                     int pinJoint, int useFixedJoint, int numFixedVars, int *fixedVars, erodWeavingIterateCallback callback, const char **errorMessage)
     {
         try
         {
-            std::vector<size_t> fixedVars;
-            for (int i = 0; i < numSupports; i++)
+            WeavingJob job;
+            job.targetV.resize(numVertices, 3);
+            for (int i = 0; i < numVertices; i++)
             {
-                fixedVars.push_back(supports[i]);
+                for (int j = 0; j < 3; j++)
+                {
+                    job.targetV(i, j) = inCoords[3 * i + j];
+                }
             }
-
-            NewtonOptimizerOptions options;
-            options.gradTol = gradTol;
-            options.niter = numIterations;
-            options.beta = beta;
-            options.useIdentityMetric = useIdentityMetric;
-            options.useNegativeCurvatureDirection = useNegativeCurvatureDirection;
-            options.feasibilitySolve = feasibilitySolve;
-            options.verboseNonPosDef = verboseNonPosDef;
-            options.verbose = verbose;
-
-            std::unique_ptr<EquilibriumProblem<SurfaceAttractedLinkage>> problem;
-            if (deployedAngle == 0)
-                problem = equilibrium_problem(*linkage, fixedVars);
-            else
-                problem = equilibrium_problem(*linkage, deployedAngle, fixedVars);
-
-            if (includeForces && numForces > 0)
+            job.targetF.resize(numTrias, 3);
+            for (int i = 0; i < numTrias; i++)
             {
-                Eigen::VectorXd externalForces(numForces);
-                for (int i = 0; i < numForces; i++)
+                for (int j = 0; j < 3; j++)
                 {
-                    externalForces(i) = inForces[i];
+                    job.targetF(i, j) = inTrias[3 * i + j];
                 }
-                problem->external_forces = externalForces;
             }
 
-            NewtonOptimizer solver(std::move(problem));
-            solver.options = options;
-            const auto report = solver.optimize();
-
-            if (writeReport) getConvergenceReport(report, outReport);
+            job.beta = beta;
+            job.gamma = gamma;
+            job.restLengthMinimizationWeight = restLengthWeight;
+            job.restKappaSmoothingWeight = smoothingWeight;
+            job.contactForceWeight = contactForceWeight;
+            job.attractionWeight = attractionWeight;
+            job.algorithm = static_cast<OptAlgorithm>(algorithm);
+            job.numSteps = numSteps;
+            job.trustRegionScale = trustRegionScale;
+            job.optimalityTol = optimalityTol;
+            job.minRestLen = minRestLen;
+            job.pinJoint = pinJoint;
+            job.useFixedJoint = useFixedJoint;
+            for (int i = 0; i < numFixedVars; i++)
+            {
+                job.fixedVars.push_back(fixedVars[i]);
+            }
 
+            const int status = runWeavingJob(*linkage, job, weavingIterateCallback(callback));
             *errorMessage = "";
 
-            if (report.success)
+            if (status == 0)
                 return 1;
+            else if (status == int(BoundConstrainedStatus::USER_TERMINATION))
+                return 2;
             else
                 return 0;
         }
@@ -1240,54 +2554,25 @@ namespace ElasticRodsGH
         }
     }
 
-    EROD_API int erodXShellLiveNewtonSolver(RodLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
-                                            double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                            int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, const char **errorMessage)
+    EROD_API int erodWeavingOptimizeFromFile(SurfaceAttractedLinkage *linkage, const char *jobPath, const char *outputDirectory, erodWeavingIterateCallback callback, const char **errorMessage)
     {
         try
         {
-            std::vector<size_t> fixedVars;
-            for (int i = 0; i < numSupports; i++)
-            {
-                fixedVars.push_back(supports[i]);
-            }
-
-            NewtonOptimizerOptions options;
-            options.gradTol = gradTol;
-            options.niter = numIterations;
-            options.beta = beta;
-            options.useIdentityMetric = useIdentityMetric;
-            options.useNegativeCurvatureDirection = useNegativeCurvatureDirection;
-            options.feasibilitySolve = feasibilitySolve;
-            options.verboseNonPosDef = verboseNonPosDef;
-            options.verbose = verbose;
-
-            std::unique_ptr<EquilibriumProblem<RodLinkage>> problem;
-            if (deployedAngle == 0)
-                problem = equilibrium_problem(*linkage, fixedVars);
-            else
-                problem = equilibrium_problem(*linkage, deployedAngle, fixedVars);
+            const WeavingJob job = WeavingJob::load(jobPath);
 
-            if (includeForces && numForces > 0)
+            WeavingIterateCallback writeIterate = (outputDirectory != nullptr) ? weavingIterateFileWriter(outputDirectory) : nullptr;
+            WeavingIterateCallback notify = weavingIterateCallback(callback);
+            const int status = runWeavingJob(*linkage, job, [&](const WeavingIterate &it)
             {
-                Eigen::VectorXd externalForces(numForces);
-                for (int i = 0; i < numForces; i++)
-                {
-                    externalForces(i) = inForces[i];
-                }
-                problem->external_forces = externalForces;
-            }
-
-            NewtonOptimizer solver(std::move(problem));
-            solver.options = options;
-            const auto report = solver.optimize();
-
-            if (writeReport) getConvergenceReport(report, outReport);
-
+                if (writeIterate) writeIterate(it);
+                return notify && notify(it);
+            });
             *errorMessage = "";
 
-            if (report.success)
+            if (status == 0)
                 return 1;
+            else if (status == int(BoundConstrainedStatus::USER_TERMINATION))
+                return 2;
             else
                 return 0;
         }
@@ -2691,6 +3976,107 @@ namespace ElasticRodsGH
         }
     }
 
+    EROD_API int erodPeriodicElasticRodSaveBinary(PeriodicRod *pRod, const char *path, const char **errorMessage)
+    {
+        try
+        {
+            saveBinary(*pRod, path);
+            *errorMessage = "";
+            return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
+        }
+    }
+
+    EROD_API PeriodicRod *erodPeriodicElasticRodLoadBinary(const char *path, const char **errorMessage)
+    {
+        try
+        {
+            std::ifstream is(path, std::ios::binary);
+            if (!is.is_open()) throw std::runtime_error(std::string("Failed to open input file ") + path);
+            *errorMessage = "Periodic Rod Loaded";
+            return LinkageBinaryIO::loadPeriodicRod(is).release();
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return nullptr;
+        }
+    }
+
+    EROD_API int erodPeriodicElasticRodSerializeBinary(PeriodicRod *pRod, unsigned char **outData, size_t *numBytes, const char **errorMessage)
+    {
+        try
+        {
+            copyBytes(serializeBinary(*pRod), outData, numBytes);
+            *errorMessage = "";
+            return 0;
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return 1;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return 1;
+        }
+    }
+
+    EROD_API PeriodicRod *erodPeriodicElasticRodDeserializeBinary(const unsigned char *data, size_t numBytes, const char **errorMessage)
+    {
+        try
+        {
+            std::istringstream is(std::string(reinterpret_cast<const char *>(data), numBytes), std::ios::binary);
+            *errorMessage = "Periodic Rod Loaded";
+            return LinkageBinaryIO::loadPeriodicRod(is).release();
+        }
+        catch (const std::runtime_error &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (const std::out_of_range &error)
+        {
+            *errorMessage = error.what();
+            return nullptr;
+        }
+        catch (...)
+        {
+            *errorMessage = "Unknown error from the c++ library.";
+            return nullptr;
+        }
+    }
+
     EROD_API void erodPeriodicElasticRodGetMeshData(PeriodicRod *pRod, double **outCoords, int **outQuads, size_t *numCoords, size_t *numQuads)
     {
         std::vector<MeshIO::IOVertex> vertices;
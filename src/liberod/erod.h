@@ -10,6 +10,7 @@
 #include "infer_target_surface.hh"
 #include "RodMaterial.hh"
 #include "SurfaceAttractedLinkage.hh"
+#include "async_equilibrium.hh"
 
 #define EROD_API_VERSION "erod"
 
@@ -30,6 +31,14 @@ namespace ElasticRodsGH
 
     EROD_API SurfaceAttractedLinkage *erodXShellAttractedSurfaceCopy(SurfaceAttractedLinkage *linkage, const char **errorMessage);
 
+    EROD_API int erodXShellAttractedSurfaceSaveBinary(SurfaceAttractedLinkage *linkage, const char *path, const char **errorMessage);
+
+    EROD_API SurfaceAttractedLinkage *erodXShellAttractedSurfaceLoadBinary(const char *path, const char **errorMessage);
+
+    EROD_API int erodXShellAttractedSurfaceSerializeBinary(SurfaceAttractedLinkage *linkage, unsigned char **outData, size_t *numBytes, const char **errorMessage);
+
+    EROD_API SurfaceAttractedLinkage *erodXShellAttractedSurfaceDeserializeBinary(const unsigned char *data, size_t numBytes, const char **errorMessage);
+
     // Target Surface
     EROD_API int erodXShellInferTargetSurface(RodLinkage *linkage, size_t nsubdiv, size_t numExtensionLayers, double **outCoords, int **outTrias, size_t *numCoords, size_t *numTrias, const char **errorMessage);
 
@@ -42,6 +51,15 @@ namespace ElasticRodsGH
 
     EROD_API RodLinkage *erodXShellCopy(RodLinkage *linkage, const char **errorMessage);
 
+    // Binary serialization (see linkage_io.hh). The Serialize functions return a malloc'd buffer.
+    EROD_API int erodXShellSaveBinary(RodLinkage *linkage, const char *path, const char **errorMessage);
+
+    EROD_API RodLinkage *erodXShellLoadBinary(const char *path, const char **errorMessage);
+
+    EROD_API int erodXShellSerializeBinary(RodLinkage *linkage, unsigned char **outData, size_t *numBytes, const char **errorMessage);
+
+    EROD_API RodLinkage *erodXShellDeserializeBinary(const unsigned char *data, size_t numBytes, const char **errorMessage);
+
     EROD_API RodLinkage::RodSegment *erodXShellBuildRodSegment(int numVertices, double *inCoords);
 
     EROD_API void erodXShellSetMaterial(RodLinkage *linkage, int sectionType, double E, double nu, double *sectionParams, int numParams, int axisType);
@@ -88,10 +106,16 @@ namespace ElasticRodsGH
 
     EROD_API void erodXShellGetMeshData(RodLinkage* linkage, double** outCoords, int** outQuads, size_t* numCoords, size_t* numQuads);
 
+    // Segments of a single rod; prefer erodXShellGetRodSegmentTable when reading all rods.
     EROD_API void erodXShellGetRodSegmentIndexesPerRod(RodLinkage *linkage, int index, int **segmentIndexes, size_t *numSeg, int *type);
 
     EROD_API size_t erodXShellGetRodTraceCount(RodLinkage *linkage, const char **errorMessage);
 
+    // Complete rod-to-segment table: rod r consists of the (ordered) segments
+    // outSegmentIndexes[outRodOffsets[r]..outRodOffsets[r + 1]); outRodTypes[r] is 1 for "A" rods.
+    EROD_API int erodXShellGetRodSegmentTable(RodLinkage *linkage, int **outSegmentIndexes, int **outRodOffsets, int **outRodTypes,
+                                              size_t *numRods, size_t *numSegments, const char **errorMessage);
+
     EROD_API void erodXShellRemoveRestCurvatures(RodLinkage *linkage);
 
     EROD_API size_t erodXShellHessianNNZ(RodLinkage *linkage, int variableDesignParameters);
@@ -142,6 +166,92 @@ namespace ElasticRodsGH
 
     EROD_API void erodXShellGetJointAngles(RodLinkage *linkage, double **outAngles, size_t *numAngles);
 
+    // Bulk export. Per-vertex and per-edge arrays concatenate all segments in order;
+    // segment i owns entries [offsets[i], offsets[i + 1]) of erodXShellGetSegmentOffsets.
+    EROD_API void erodXShellGetSegmentOffsets(RodLinkage *linkage, int **outVertexOffsets, int **outEdgeOffsets, size_t *numOffsets);
+
+    EROD_API void erodXShellGetSegmentsCenterLinePositions(RodLinkage *linkage, double **outCoords, size_t *numCoords);
+
+    EROD_API void erodXShellGetSegmentsMaterialFrames(RodLinkage *linkage, double **outCoordsD1, double **outCoordsD2, size_t *numCoords);
+
+    EROD_API void erodXShellGetSegmentsRestData(RodLinkage *linkage, double **outRestLengths, double **outRestKappas, double **outRestTwists,
+                                                double **outRestPoints, double **outRestDirectors, size_t *numEdges, size_t *numVertices);
+
+    EROD_API void erodXShellGetSegmentsStiffnesses(RodLinkage *linkage, double **outBendingStiffness, double **outTwistingStiffness, double **outStretchingStiffness,
+                                                   size_t *numEdges, size_t *numVertices);
+
+    EROD_API void erodXShellGetJointsData(RodLinkage *linkage, double **outPositions, double **outNormals, double **outEdgeVecsA, double **outEdgeVecsB,
+                                          double **outOmegas, double **outSourceTangents, double **outSourceNormals, double **outAngles, double **outLengths,
+                                          int **outSegments, int **outTypes, size_t *numJoints);
+
+    // Caller-provided buffers. Sizes (in number of values) must match the size queries
+    // (erodXShellGetDoFCount, 3 * erodXShellGetCenterLinePositionsCount, erodXShellGetMeshDataCount, ...).
+    // Return 0 on success, 1 on a size mismatch.
+    EROD_API void erodXShellGetMeshDataCount(RodLinkage *linkage, size_t *numCoords, size_t *numQuads);
+
+    EROD_API size_t erodXShellGetScalarFieldCount(RodLinkage *linkage);
+
+    EROD_API size_t erodXShellGetRestLengthsSolveDoFCount(RodLinkage *linkage);
+
+    EROD_API int erodXShellFillDoFs(RodLinkage *linkage, double *outDoFs, size_t numDoFs);
+
+    EROD_API int erodXShellFillCenterLinePositions(RodLinkage *linkage, double *outCoords, size_t numCoords);
+
+    EROD_API int erodXShellFillMeshData(RodLinkage *linkage, double *outCoords, int *outQuads, size_t numCoords, size_t numQuads);
+
+    // Topology-stable mesh: the quads only change with the topology or the cross-sections,
+    // so they can be fetched once and only the vertex positions refreshed afterwards.
+    // outNormals may be null; otherwise it receives numCoords unit vertex normals.
+    EROD_API int erodXShellFillMeshConnectivity(RodLinkage *linkage, int *outQuads, size_t numQuads);
+
+    EROD_API int erodXShellFillMeshPositions(RodLinkage *linkage, double *outCoords, double *outNormals, size_t numCoords);
+
+    // fieldType: 0 sqrt bending energies, 1 max bending stresses, 2 min bending stresses, 3 von Mises stresses, 4 twisting stresses, 5 stretching stresses
+    // Fields 0-4 have numField = erodXShellGetScalarFieldCount entries; field 5 has one entry per quad (numQuads / 4 of erodXShellGetMeshDataCount).
+    // Returns 0 on success, 1 for a buffer size mismatch, 2 for an unknown fieldType and 3 if the field could not be computed.
+    EROD_API int erodXShellFillScalarField(RodLinkage *linkage, int fieldType, double *outField, size_t numField);
+
+    // Compute every field whose output pointer is non-null in a single pass over the linkage.
+    // Per-vertex fields have numField = erodXShellGetScalarFieldCount entries; the per-edge
+    // stretching stresses have numEdgeField = (numQuads / 4 of erodXShellGetMeshDataCount) entries.
+    EROD_API int erodXShellFillScalarFields(RodLinkage *linkage, double *outSqrtBendingEnergies, double *outMaxBendingStresses, double *outMinBendingStresses,
+                                            double *outVonMisesStresses, double *outTwistingStresses, double *outStretchingStresses,
+                                            size_t numField, size_t numEdgeField);
+
+    EROD_API int erodXShellFillDesignParams(RodLinkage *linkage, double *outDesignParams, size_t numDesignParams);
+
+    EROD_API int erodXShellFillRestKappaVars(RodLinkage *linkage, double *outData, size_t numData);
+
+    EROD_API int erodXShellFillPerSegmentRestLengths(RodLinkage *linkage, double *outLengths, size_t numLengths);
+
+    EROD_API int erodXShellFillRestLengthsSolveDoFs(RodLinkage *linkage, double *outDoFs, size_t numDoFs);
+
+    EROD_API int erodXShellFillJointAngles(RodLinkage *linkage, double *outAngles, size_t numAngles);
+
+    EROD_API int erodXShellFillSegmentsCenterLinePositions(RodLinkage *linkage, double *outCoords, size_t numCoords);
+
+    EROD_API int erodXShellFillSegmentsMaterialFrames(RodLinkage *linkage, double *outCoordsD1, double *outCoordsD2, size_t numCoords);
+
+    EROD_API int erodXShellFillJointPositions(RodLinkage *linkage, double *outPositions, size_t numCoords);
+
+    // Single-precision variants of the exports above, for display pipelines working in float32.
+    // The mesh positions and scalar fields are evaluated directly into the float buffers; the
+    // other exports are converted while copying. Sizes and return codes are the same.
+    EROD_API int erodXShellFillCenterLinePositionsFloat(RodLinkage *linkage, float *outCoords, size_t numCoords);
+
+    EROD_API int erodXShellFillMeshPositionsFloat(RodLinkage *linkage, float *outCoords, float *outNormals, size_t numCoords);
+
+    // Return codes as for erodXShellFillScalarField.
+    EROD_API int erodXShellFillScalarFieldFloat(RodLinkage *linkage, int fieldType, float *outField, size_t numField);
+
+    EROD_API int erodXShellFillScalarFieldsFloat(RodLinkage *linkage, float *outSqrtBendingEnergies, float *outMaxBendingStresses, float *outMinBendingStresses,
+                                                 float *outVonMisesStresses, float *outTwistingStresses, float *outStretchingStresses,
+                                                 size_t numField, size_t numEdgeField);
+
+    EROD_API int erodXShellFillSegmentsCenterLinePositionsFloat(RodLinkage *linkage, float *outCoords, size_t numCoords);
+
+    EROD_API int erodXShellFillSegmentsMaterialFramesFloat(RodLinkage *linkage, float *outCoordsD1, float *outCoordsD2, size_t numCoords);
+
     // Material
     EROD_API RodMaterial *erodMaterialBuild(int sectionType, double E, double nu, double *params, int numParams, int axisType);
 
@@ -164,21 +274,116 @@ namespace ElasticRodsGH
     EROD_API double erodMaterialGetCrossSectionHeight(RodMaterial *material);
 
     // Solver
+    // Progress callback of the Newton solvers, called after each iteration. Return nonzero to
+    // cancel the solve: the model is left at the last accepted iterate and the solver returns 2.
+    typedef int (*erodNewtonProgressCallback)(int iteration, double energy, double gradientNorm, double freeGradientNorm, double stepLength, int indefinite);
+
+    // Convergence reports (outReport) are flattened as
+    //     [success, backtracking_failure, numEntries,
+    //      energy, gradientNorm, freeGradientNorm, stepLength, indefinite,
+    //      time, assemblyTime, factorizationTime, lineSearchTime, failedFactorizations, tau, backtrackingSteps, workingSetChanges]
+    // where each of the 13 per-iteration fields holds numEntries values (see ConvergenceReport/NewtonIterationStatistics).
+
     EROD_API int erodPeriodicElasticRodNewtonSolver(PeriodicRod *rod, int numIterations, int numSupports, int numForces, int *supports, double *inForces,
                                                     double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                                    int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, const char **errorMessage);
+                                                    int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, erodNewtonProgressCallback progress, const char **errorMessage);
 
     EROD_API int erodElasticRodNewtonSolver(ElasticRod *rod, int numIterations, int numSupports, int numForces, int *supports, double *inForces,
                                             double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                            int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, const char **errorMessage);
+                                            int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, erodNewtonProgressCallback progress, const char **errorMessage);
 
     EROD_API int erodXShellNewtonSolver(RodLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double* inForces, 
                                               double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection, 
-                                              int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, const char **errorMessage);
+                                              int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, erodNewtonProgressCallback progress, const char **errorMessage);
 
     EROD_API int erodXShellAttractedLinkageNewtonSolver(SurfaceAttractedLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
                                                         double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
-                                                        int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, const char **errorMessage);
+                                                        int feasibilitySolve, int verboseNonPosDef, int writeReport, double **outReport, erodNewtonProgressCallback progress, const char **errorMessage);
+
+    // Asynchronous solves. The SolveAsync functions copy the linkage and start solving the copy on a
+    // background thread; they return the job handle (nullptr on error) and the arguments have the same
+    // meaning as for erodXShellNewtonSolver. The progress callback is called on the worker thread and
+    // must stay valid until the job finishes. The linkage can be used freely while the job runs; the
+    // Publish functions wait for the solve and copy its equilibrium back to a linkage of the same kind
+    // (0 on success, 1 on error). Jobs are deleted with erodAsyncSolveRelease, which cancels a running solve.
+    EROD_API AsyncEquilibriumSolveBase *erodXShellNewtonSolveAsync(RodLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
+                                                                   double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
+                                                                   int feasibilitySolve, int verboseNonPosDef, erodNewtonProgressCallback progress, const char **errorMessage);
+
+    EROD_API AsyncEquilibriumSolveBase *erodXShellAttractedLinkageNewtonSolveAsync(SurfaceAttractedLinkage *linkage, int numIterations, double deployedAngle, int numSupports, int numForces, int *supports, double *inForces,
+                                                                                   double gradTol, double beta, int includeForces, int verbose, int useIdentityMetric, int useNegativeCurvatureDirection,
+                                                                                   int feasibilitySolve, int verboseNonPosDef, erodNewtonProgressCallback progress, const char **errorMessage);
+
+    // 1 if the solve has finished, 0 if it is still running.
+    EROD_API int erodAsyncSolveIsFinished(AsyncEquilibriumSolveBase *job);
+
+    // Wait at most timeoutSeconds (negative: until finished); returns erodAsyncSolveIsFinished.
+    EROD_API int erodAsyncSolveWait(AsyncEquilibriumSolveBase *job, double timeoutSeconds);
+
+    EROD_API void erodAsyncSolveCancel(AsyncEquilibriumSolveBase *job);
+
+    // Last completed iteration and its energy.
+    EROD_API void erodAsyncSolveGetProgress(AsyncEquilibriumSolveBase *job, int *iteration, double *energy);
+
+    // Wait for the solve; returns 1 converged, 0 not converged, 2 cancelled, -1 error.
+    EROD_API int erodAsyncSolveGetResult(AsyncEquilibriumSolveBase *job, int writeReport, double **outReport, const char **errorMessage);
+
+    EROD_API int erodXShellAsyncSolvePublish(AsyncEquilibriumSolveBase *job, RodLinkage *linkage, const char **errorMessage);
+
+    EROD_API int erodXShellAttractedLinkageAsyncSolvePublish(AsyncEquilibriumSolveBase *job, SurfaceAttractedLinkage *linkage, const char **errorMessage);
+
+    EROD_API void erodAsyncSolveRelease(AsyncEquilibriumSolveBase *job);
+
+    // Parallelism
+    // Task arena with at most numThreads threads (<= 0: automatic). If firstPinnedCore >= 0, its threads are
+    // pinned to cores firstPinnedCore, firstPinnedCore + 1, ... while they work in the arena. Arenas attached
+    // to a linkage are used by its Newton solves (also the asynchronous ones) and weaving optimizations;
+    // releasing the handle does not detach it. Returns nullptr on error.
+    EROD_API ParallelismArena *erodParallelismArenaBuild(int numThreads, int firstPinnedCore, const char **errorMessage);
+
+    EROD_API int erodParallelismArenaGetMaxConcurrency(ParallelismArena *arena);
+
+    EROD_API void erodParallelismArenaRelease(ParallelismArena *arena);
+
+    // Pass a null arena to run in the default, shared arena again.
+    EROD_API void erodXShellSetParallelismArena(RodLinkage *linkage, ParallelismArena *arena);
+
+    // Process-wide limit on the number of threads (<= 0: remove the limit). Returns 0 on success, 1 on error.
+    EROD_API int erodSetMaxNumThreads(int numThreads, const char **errorMessage);
+
+    // Profiling
+    // The profiler is disabled by default (enabled in builds configured with MESHFEM_ENABLE_BENCHMARKING).
+    EROD_API void erodProfilerSetEnabled(int enable);
+
+    EROD_API int erodProfilerIsEnabled();
+
+    EROD_API void erodProfilerReset();
+
+    // Merged call tree of all threads, flattened in preorder: outNames holds the numSections section
+    // names, each terminated by '\n'; outParents[i] is the index of the enclosing section (-1 at the
+    // top level), outSeconds[i] the total time and outCalls[i] the number of calls. Returns 0 on success.
+    EROD_API int erodProfilerGetReport(char **outNames, int **outParents, double **outSeconds, size_t **outCalls, size_t *numSections, const char **errorMessage);
+
+    // Memory
+    // Bytes held by each component of a linkage (also accepts surface-attracted linkages) or of a
+    // finished asynchronous solve (its linkage snapshot and solver, including the cached Hessian
+    // and the CHOLMOD factor). outNames holds the numComponents dot-separated component names,
+    // each terminated by '\n'; outBytes[i] is the size of component i. Returns 0 on success.
+    EROD_API int erodXShellGetMemoryReport(RodLinkage *linkage, char **outNames, size_t **outBytes, size_t *numComponents, const char **errorMessage);
+
+    EROD_API int erodAsyncSolveGetMemoryReport(AsyncEquilibriumSolveBase *job, char **outNames, size_t **outBytes, size_t *numComponents, const char **errorMessage);
+
+    // Weaving Optimization
+    // Called after each accepted design iterate (and once for the initial design).
+    // Return nonzero to stop the optimization; the weaving functions then return 2.
+    typedef int (*erodWeavingIterateCallback)(int iteration, double J, double J_target, const double *designParams, size_t numDesignParams, const double *dofs, size_t numDoFs);
+
+    EROD_API int erodWeavingOptimize(SurfaceAttractedLinkage *linkage, int numVertices, int numTrias, double *inCoords, int *inTrias,
+                                     double beta, double gamma, double restLengthWeight, double smoothingWeight, double contactForceWeight, double attractionWeight,
+                                     int algorithm, int numSteps, double trustRegionScale, double optimalityTol, double minRestLen,
+                                     int pinJoint, int useFixedJoint, int numFixedVars, int *fixedVars, erodWeavingIterateCallback callback, const char **errorMessage);
+
+    EROD_API int erodWeavingOptimizeFromFile(SurfaceAttractedLinkage *linkage, const char *jobPath, const char *outputDirectory, erodWeavingIterateCallback callback, const char **errorMessage);
 
     // Joints 
     EROD_API const RodLinkage::Joint *erodJointBuild(RodLinkage *linkage, size_t index);
@@ -375,6 +580,14 @@ namespace ElasticRodsGH
 
     EROD_API PeriodicRod *erodPeriodicElasticRodCopy(PeriodicRod *pRod, const char **errorMessage);
 
+    EROD_API int erodPeriodicElasticRodSaveBinary(PeriodicRod *pRod, const char *path, const char **errorMessage);
+
+    EROD_API PeriodicRod *erodPeriodicElasticRodLoadBinary(const char *path, const char **errorMessage);
+
+    EROD_API int erodPeriodicElasticRodSerializeBinary(PeriodicRod *pRod, unsigned char **outData, size_t *numBytes, const char **errorMessage);
+
+    EROD_API PeriodicRod *erodPeriodicElasticRodDeserializeBinary(const unsigned char *data, size_t numBytes, const char **errorMessage);
+
     EROD_API void erodPeriodicElasticRodGetMeshData(PeriodicRod *pRod, double** outCoords, int** outQuads, size_t* numCoords, size_t* numQuads);
 
     EROD_API void erodPeriodicElasticRodSetMaterial(PeriodicRod *pRod, int sectionType, double E, double nu, double *sectionParams, int numParams, int axisType);